@@ -0,0 +1,651 @@
+/**
+ * CircularLog.cpp
+ *
+ * Implementation der vorallokierten Ringdatei
+ */
+
+#include "CircularLog.h"
+#include <esp_timer.h>
+
+CircularLog::CircularLog()
+    : opened(false)
+    , sd(nullptr)
+    , blockCount(0)
+    , format(LOG_RING_FORMAT_TEXT)
+    , headSeq(1)
+    , tailSeq(1)
+    , blocksSinceHeader(0)
+    , headerSeq(1)
+    , initBlocks(0)
+    , boot(0)
+    , fill(sizeof(LogRingBlockHeader))
+    , dirty(false)
+    , dirtySince(0)
+    , blockMinMs(0)
+    , blockMaxMs(0)
+    , groupValid(false)
+    , groupMinMs(0)
+    , groupMaxMs(0)
+    , groupBoot(0)
+    , compress(false)
+    , raw(nullptr)
+    , rawLen(0)
+    , lz(nullptr)
+    , index(nullptr)
+    , indexEntries(0)
+{
+    path[0] = '\0';
+    memset(block, 0, sizeof(block));
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool CircularLog::open(SDCardHandler& sdCard, const char* filePath, uint32_t blocks, uint8_t fileFormat,
+                       bool compressBlocks) {
+    if (opened) close();
+    if (!filePath || blocks == 0 || strlen(filePath) >= SD_MAX_PATH) return false;
+    
+    sd = &sdCard;
+    strncpy(path, filePath, SD_MAX_PATH - 1);
+    path[SD_MAX_PATH - 1] = '\0';
+    blockCount = blocks;
+    format = fileFormat;
+    setCompression(compressBlocks);
+    
+    file = sd->openFile(path, "r+");
+    bool created = false;
+    if (!file || !load()) {
+        if (file) migrate();
+        if (!create()) return false;
+        created = true;
+    } else if (!initAhead()) {
+        // Kopf mit der neuen Boot-Nummer (sonst erhält der nächste Boot dieselbe)
+        DEBUG_PRINTF("CircularLog: ⚠️ Kopf schreiben fehlgeschlagen: %s\n", path);
+    }
+    
+    // Ohne Index weiter nutzbar, readRange liest dann alle Blöcke
+    if (!openIndex(created)) {
+        DEBUG_PRINTF("CircularLog: ⚠️ Kein Zeitindex für %s\n", path);
+    }
+    
+    opened = true;
+    return true;
+}
+
+void CircularLog::close() {
+    if (!opened) return;
+    
+    flush();
+    file.close();
+    if (indexFile) indexFile.close();
+    delete[] index;
+    index = nullptr;
+    indexEntries = 0;
+    delete[] raw;
+    raw = nullptr;
+    delete lz;
+    lz = nullptr;
+    compress = false;
+    opened = false;
+}
+
+void CircularLog::setCompression(bool enable) {
+    if (enable == compress) return;
+    
+    // Ein Block ist ganz oder gar nicht komprimiert
+    if (opened && fill > sizeof(LogRingBlockHeader)) advance();
+    
+    if (enable && !raw) {
+        raw = new uint8_t[LOG_LZ_WINDOW];
+        lz = new LogLzState;
+    }
+    compress = enable;
+    rawLen = 0;
+    if (lz) logLzReset(lz);
+}
+
+bool CircularLog::append(const uint8_t* data, size_t len, uint32_t timestampMs) {
+    if (!opened || !data || len == 0 || len > LOG_RING_PAYLOAD_SIZE) return false;
+    
+    // Records überspannen keine Blockgrenze
+    bool ok = true;
+    int packed = -1;
+    if (compress) {
+        // Record an die Rohdaten hängen und komprimiert in den Block schreiben,
+        // passt er nicht mehr → neuer Block (Zustand dort frisch)
+        int64_t startUs = esp_timer_get_time();
+        if (rawLen + len <= LOG_LZ_WINDOW) {
+            memcpy(&raw[rawLen], data, len);
+            packed = logLzCompress(lz, raw, rawLen, rawLen + len, &block[fill], LOG_RING_BLOCK_SIZE - fill);
+        }
+        if (packed < 0) {
+            ok = advance();
+            memcpy(raw, data, len);
+            packed = logLzCompress(lz, raw, 0, len, &block[fill], LOG_RING_BLOCK_SIZE - fill);
+        }
+        stats.compressUs += esp_timer_get_time() - startUs;
+        stats.rawBytes += len;
+        stats.packedBytes += packed;
+    } else if (fill + len > LOG_RING_BLOCK_SIZE) {
+        ok = advance();
+    }
+    
+    if (fill == sizeof(LogRingBlockHeader)) {
+        blockMinMs = blockMaxMs = timestampMs;
+    } else {
+        if (timestampMs < blockMinMs) blockMinMs = timestampMs;
+        if (timestampMs > blockMaxMs) blockMaxMs = timestampMs;
+    }
+    if (!groupValid) {
+        groupMinMs = groupMaxMs = timestampMs;
+        groupBoot = boot;
+        groupValid = true;
+    } else {
+        if (timestampMs < groupMinMs) groupMinMs = timestampMs;
+        if (timestampMs > groupMaxMs) groupMaxMs = timestampMs;
+    }
+    if (compress) {
+        rawLen += len;
+        fill += packed;
+    } else {
+        memcpy(&block[fill], data, len);
+        fill += len;
+    }
+    if (!dirty) {
+        dirty = true;
+        dirtySince = millis();
+    }
+    return ok;
+}
+
+bool CircularLog::flush() {
+    if (!opened) return false;
+    
+    bool ok = true;
+    if (dirty) {
+        // Teilblock an seiner Position, wird später vervollständigt überschrieben
+        ok = writeBlock();
+    }
+    if (blocksSinceHeader > 0 || !ok) {
+        ok = writeHeader() && ok;
+    }
+    file.flush();
+    if (indexFile) indexFile.flush();
+    return ok;
+}
+
+void CircularLog::flushIfDue(uint32_t maxAgeMs) {
+    if (opened && dirty && (millis() - dirtySince) >= maxAgeMs) {
+        flush();
+    }
+}
+
+void CircularLog::clear() {
+    if (!opened) return;
+    
+    // Aktuellen Block aufgeben, alles davor ist ab jetzt ungültig
+    headSeq++;
+    tailSeq = headSeq;
+    resetBlock();
+    groupValid = false;
+    if (!initAhead()) writeHeader();
+    file.flush();
+}
+
+size_t CircularLog::getUsedBytes() const {
+    return (headSeq - tailSeq) * LOG_RING_PAYLOAD_SIZE + (fill - sizeof(LogRingBlockHeader));
+}
+
+int CircularLog::readRange(uint32_t fromMs, uint32_t toMs, CircularLogBlockCallback callback, uint32_t queryBoot) {
+    if (!opened || !callback) return -1;
+    if (queryBoot == 0) queryBoot = boot;
+    
+    uint8_t buffer[LOG_RING_BLOCK_SIZE];
+    uint8_t* unpacked = nullptr;          // Erst bei komprimierten Blöcken
+    int blocksRead = 0;
+    bool done = false;
+    
+    // Gruppenweise von Tail zu Head
+    uint32_t seq = tailSeq;
+    while (!done && seq <= headSeq) {
+        uint32_t startSeq = groupStart(seq);
+        uint32_t endSeq = startSeq + groupLength(seq) - 1;
+        
+        // Volle Gruppe mit gültigem Eintrag außerhalb des Fensters → überspringen
+        if (index && startSeq >= tailSeq && endSeq < headSeq) {
+            const LogRingIndexEntry& entry = index[((startSeq - 1) % blockCount) / LOG_RING_INDEX_STRIDE];
+            if (entry.seq == startSeq && ((entry.boot != 0 && entry.boot != queryBoot) ||
+                                          entry.minMs > toMs || entry.maxMs < fromMs)) {
+                seq = endSeq + 1;
+                continue;
+            }
+        }
+        
+        if (endSeq > headSeq) endSeq = headSeq;
+        for (; !done && seq <= endSeq; seq++) {
+            LogRingBlockHeader bh;
+            const uint8_t* data;
+            size_t len;
+            
+            if (seq == headSeq) {
+                // Schreib-Block aus dem RAM (evtl. noch nicht auf der Karte)
+                bh.minMs = blockMinMs;
+                bh.maxMs = blockMaxMs;
+                bh.boot = boot;
+                data = compress ? raw : &block[sizeof(bh)];
+                len = compress ? rawLen : fill - sizeof(bh);
+            } else {
+                if (!file.seek(blockOffset(seq)) ||
+                    file.read(buffer, LOG_RING_BLOCK_SIZE) != LOG_RING_BLOCK_SIZE) {
+                    blocksRead = -1;
+                    break;
+                }
+                memcpy(&bh, buffer, sizeof(bh));
+                if (bh.seq != seq || bh.used > LOG_RING_PAYLOAD_SIZE) continue;
+                data = &buffer[sizeof(bh)];
+                len = bh.used;
+                blocksRead++;
+                
+                if (bh.rawLen > 0 && len > 0 && bh.boot == queryBoot && bh.minMs <= toMs && bh.maxMs >= fromMs) {
+                    if (!unpacked) unpacked = new uint8_t[LOG_LZ_WINDOW];
+                    int n = logLzDecompress(data, len, unpacked, LOG_LZ_WINDOW);
+                    if (n != bh.rawLen) continue;
+                    data = unpacked;
+                    len = n;
+                }
+            }
+            
+            if (len == 0 || bh.boot != queryBoot || bh.minMs > toMs || bh.maxMs < fromMs) continue;
+            done = !callback(data, len);
+        }
+        if (blocksRead < 0) break;
+    }
+    
+    delete[] unpacked;
+    return blocksRead;
+}
+
+void CircularLog::getStats(CircularLogStats* out) {
+    if (out) *out = stats;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRIVATE METHODEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+uint32_t CircularLog::blockOffset(uint32_t seq) const {
+    return LOG_RING_BLOCK_SIZE * (1 + (seq - 1) % blockCount);
+}
+
+bool CircularLog::create() {
+    unsigned long start = millis();
+    DEBUG_PRINTF("CircularLog: Lege %s an (%lu KB)...\n", path,
+                 (unsigned long)((blockCount + 1) * LOG_RING_BLOCK_SIZE / 1024));
+    
+    file = sd->openFile(path, FILE_WRITE);
+    if (!file) {
+        DEBUG_PRINTF("CircularLog: ❌ Kann Datei nicht anlegen: %s\n", path);
+        return false;
+    }
+    
+    // Nur das letzte Byte schreiben: FAT reserviert die ganze Cluster-Kette,
+    // die Datenblöcke nullt der Writer später vor dem Head (initAhead)
+    uint8_t zero = 0;
+    bool ok = file.seek((blockCount + 1) * LOG_RING_BLOCK_SIZE - 1) && file.write(&zero, 1) == 1;
+    file.close();
+    
+    if (!ok) {
+        DEBUG_PRINTF("CircularLog: ❌ Zu wenig Platz für %s\n", path);
+        return false;
+    }
+    
+    file = sd->openFile(path, "r+");
+    if (!file) return false;
+    
+    headSeq = 1;
+    tailSeq = 1;
+    initBlocks = 0;
+    boot = 1;
+    resetBlock();
+    groupValid = false;
+    ok = initAhead();
+    file.flush();
+    
+    DEBUG_PRINTF("CircularLog: ✅ %s angelegt (%lu ms)\n", path, millis() - start);
+    return ok;
+}
+
+bool CircularLog::load() {
+    LogRingHeader header;
+    if (file.size() != (blockCount + 1) * LOG_RING_BLOCK_SIZE) return false;
+    if (!file.seek(0) || file.read((uint8_t*)&header, sizeof(header)) != sizeof(header)) return false;
+    
+    if (memcmp(header.magic, LOG_RING_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LOG_RING_VERSION ||
+        header.format != format ||
+        (format == LOG_RING_FORMAT_BINARY && header.schemaVersion != LOG_BIN_VERSION) ||
+        header.blockSize != LOG_RING_BLOCK_SIZE ||
+        header.blockCount != blockCount ||
+        header.headSeq == 0) {
+        DEBUG_PRINTF("CircularLog: ⚠️ %s passt nicht zur Konfiguration, neu anlegen\n", path);
+        return false;
+    }
+    
+    headSeq = header.headSeq;
+    tailSeq = header.tailSeq;
+    headerSeq = header.headSeq;
+    boot = header.boot + 1;
+    initBlocks = header.initBlocks == 0 || header.initBlocks > blockCount ? blockCount : header.initBlocks;
+    
+    // Kopf läuft nach: Blöcke mit fortlaufender Sequenz nach dem Head übernehmen
+    // (im ersten Umlauf nur genullte Blöcke, dahinter liegen alte Karteninhalte)
+    LogRingBlockHeader bh;
+    for (uint32_t i = 0; i < blockCount; i++) {
+        if ((initBlocks < blockCount && headSeq + 1 > initBlocks) ||
+            !file.seek(blockOffset(headSeq + 1)) ||
+            file.read((uint8_t*)&bh, sizeof(bh)) != sizeof(bh) ||
+            bh.seq != headSeq + 1) {
+            break;
+        }
+        headSeq++;
+    }
+    if (headSeq - tailSeq >= blockCount) {
+        tailSeq = headSeq - blockCount + 1;
+    }
+    
+    // Teilweise gefüllter Head-Block gehört zum vorigen Boot: bleibt auf der Karte,
+    // geschrieben wird im nächsten Block (ein Block = Records eines Boots)
+    resetBlock();
+    if (file.seek(blockOffset(headSeq)) &&
+        file.read((uint8_t*)&bh, sizeof(bh)) == sizeof(bh) &&
+        bh.seq == headSeq && bh.used > 0) {
+        headSeq++;
+        if (headSeq - tailSeq >= blockCount) {
+            tailSeq = headSeq - blockCount + 1;
+        }
+    }
+    
+    DEBUG_PRINTF("CircularLog: ✅ %s (Blöcke %lu..%lu von %lu)\n", path, tailSeq, headSeq, blockCount);
+    return true;
+}
+
+bool CircularLog::openIndex(bool rebuild) {
+    indexEntries = (blockCount + LOG_RING_INDEX_STRIDE - 1) / LOG_RING_INDEX_STRIDE;
+    index = new LogRingIndexEntry[indexEntries];
+    size_t tableSize = indexEntries * sizeof(LogRingIndexEntry);
+    
+    char indexPath[SD_MAX_PATH + 4];
+    snprintf(indexPath, sizeof(indexPath), "%s.idx", path);
+    
+    // Vorhandenen Index übernehmen, wenn er zu dieser Ringdatei passt
+    if (!rebuild) {
+        indexFile = sd->openFile(indexPath, "r+");
+        LogRingIndexHeader header;
+        if (indexFile && indexFile.size() == sizeof(header) + tableSize &&
+            indexFile.seek(0) &&
+            indexFile.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            memcmp(header.magic, LOG_RING_INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+            header.version == LOG_RING_VERSION &&
+            header.stride == LOG_RING_INDEX_STRIDE &&
+            header.entries == indexEntries &&
+            indexFile.read((uint8_t*)index, tableSize) == tableSize) {
+            // Seit dem letzten Kopf vollendete Gruppen nachtragen
+            repairIndex(groupStart(headerSeq));
+            return true;
+        }
+        if (indexFile) indexFile.close();
+    }
+    
+    // Neu anlegen (vorallokiert), Einträge danach aus den Block-Köpfen
+    DEBUG_PRINTF("CircularLog: Baue Zeitindex %s auf...\n", indexPath);
+    memset(index, 0, tableSize);
+    indexFile = sd->openFile(indexPath, FILE_WRITE);
+    if (!indexFile) {
+        delete[] index;
+        index = nullptr;
+        return false;
+    }
+    
+    LogRingIndexHeader header = {};
+    memcpy(header.magic, LOG_RING_INDEX_MAGIC, sizeof(header.magic));
+    header.version = LOG_RING_VERSION;
+    header.stride = LOG_RING_INDEX_STRIDE;
+    header.entries = indexEntries;
+    bool ok = indexFile.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              indexFile.write((const uint8_t*)index, tableSize) == tableSize;
+    indexFile.close();
+    
+    if (ok) indexFile = sd->openFile(indexPath, "r+");
+    if (!ok || !indexFile) {
+        delete[] index;
+        index = nullptr;
+        return false;
+    }
+    
+    repairIndex(tailSeq);
+    return true;
+}
+
+void CircularLog::updateIndex(uint32_t startSeq, uint32_t minMs, uint32_t maxMs, uint32_t groupBoot) {
+    if (!index) return;
+    
+    uint32_t group = ((startSeq - 1) % blockCount) / LOG_RING_INDEX_STRIDE;
+    LogRingIndexEntry& entry = index[group];
+    if (entry.seq == startSeq && entry.minMs == minMs && entry.maxMs == maxMs && entry.boot == groupBoot) return;
+    
+    // Nur der geänderte Eintrag (16 Bytes an fester Position)
+    entry.seq = startSeq;
+    entry.minMs = minMs;
+    entry.maxMs = maxMs;
+    entry.boot = groupBoot;
+    size_t offset = sizeof(LogRingIndexHeader) + group * sizeof(LogRingIndexEntry);
+    if (indexFile.seek(offset) &&
+        indexFile.write((const uint8_t*)&entry, sizeof(entry)) == sizeof(entry)) {
+        stats.indexWrites++;
+    } else {
+        stats.writeErrors++;
+    }
+}
+
+void CircularLog::repairIndex(uint32_t fromSeq) {
+    uint32_t minMs, maxMs, blocksBoot;
+    
+    // Vollendete Gruppen (vollständig nach dem Tail)
+    uint32_t seq = groupStart(fromSeq);
+    while (seq + groupLength(seq) <= headSeq) {
+        uint32_t endSeq = seq + groupLength(seq) - 1;
+        if (seq >= tailSeq && scanBlocks(seq, endSeq, &minMs, &maxMs, &blocksBoot)) {
+            updateIndex(seq, minMs, maxMs, blocksBoot);
+        }
+        seq = endSeq + 1;
+    }
+    
+    // Aktuelle Gruppe: geschriebene Blöcke plus Schreib-Block
+    uint32_t startSeq = groupStart(headSeq);
+    if (startSeq < tailSeq) startSeq = tailSeq;
+    groupValid = startSeq < headSeq && scanBlocks(startSeq, headSeq - 1, &groupMinMs, &groupMaxMs, &groupBoot);
+    if (fill > sizeof(LogRingBlockHeader)) {
+        if (!groupValid) {
+            groupMinMs = blockMinMs;
+            groupMaxMs = blockMaxMs;
+            groupBoot = boot;
+            groupValid = true;
+        } else {
+            if (blockMinMs < groupMinMs) groupMinMs = blockMinMs;
+            if (blockMaxMs > groupMaxMs) groupMaxMs = blockMaxMs;
+        }
+    }
+    if (groupValid && groupBoot != boot) groupBoot = 0;
+}
+
+bool CircularLog::scanBlocks(uint32_t fromSeq, uint32_t toSeq, uint32_t* minMs, uint32_t* maxMs,
+                             uint32_t* blocksBoot) {
+    LogRingBlockHeader bh;
+    *minMs = UINT32_MAX;
+    *maxMs = 0;
+    *blocksBoot = 0;
+    
+    for (uint32_t seq = fromSeq; seq <= toSeq; seq++) {
+        if (!file.seek(blockOffset(seq)) ||
+            file.read((uint8_t*)&bh, sizeof(bh)) != sizeof(bh) ||
+            bh.seq != seq || bh.used == 0) {
+            return false;
+        }
+        if (bh.minMs < *minMs) *minMs = bh.minMs;
+        if (bh.maxMs > *maxMs) *maxMs = bh.maxMs;
+        *blocksBoot = seq == fromSeq || *blocksBoot == bh.boot ? bh.boot : 0;
+    }
+    return fromSeq <= toSeq;
+}
+
+uint32_t CircularLog::groupStart(uint32_t seq) const {
+    return seq - ((seq - 1) % blockCount) % LOG_RING_INDEX_STRIDE;
+}
+
+uint32_t CircularLog::groupLength(uint32_t seq) const {
+    uint32_t first = ((seq - 1) % blockCount) / LOG_RING_INDEX_STRIDE * LOG_RING_INDEX_STRIDE;
+    uint32_t last = first + LOG_RING_INDEX_STRIDE;
+    return (last > blockCount ? blockCount : last) - first;
+}
+
+void CircularLog::resetBlock() {
+    memset(block, 0, sizeof(block));
+    fill = sizeof(LogRingBlockHeader);
+    dirty = false;
+    rawLen = 0;
+    if (lz) logLzReset(lz);
+}
+
+bool CircularLog::writeBlock() {
+    LogRingBlockHeader bh = {};
+    bh.seq = headSeq;
+    bh.used = fill - sizeof(bh);
+    bh.rawLen = compress ? rawLen : 0;
+    bh.minMs = blockMinMs;
+    bh.maxMs = blockMaxMs;
+    bh.boot = boot;
+    memcpy(block, &bh, sizeof(bh));
+    
+    // Immer der ganze Sektor an fester Position
+    int64_t startUs = esp_timer_get_time();
+    bool ok = file.seek(blockOffset(headSeq)) &&
+              file.write(block, LOG_RING_BLOCK_SIZE) == LOG_RING_BLOCK_SIZE;
+    uint32_t elapsed = esp_timer_get_time() - startUs;
+    
+    stats.blockWrites++;
+    if (elapsed > stats.maxWriteUs) stats.maxWriteUs = elapsed;
+    if (!ok) {
+        stats.writeErrors++;
+        DEBUG_PRINTF("CircularLog: ❌ Block schreiben fehlgeschlagen: %s\n", path);
+    }
+    
+    dirty = false;
+    return ok;
+}
+
+bool CircularLog::advance() {
+    bool ok = writeBlock();
+    
+    // Letzter Block der Gruppe → Index-Eintrag der vollen Gruppe
+    uint32_t startSeq = groupStart(headSeq);
+    if (headSeq == startSeq + groupLength(headSeq) - 1) {
+        if (ok && groupValid && startSeq >= tailSeq) {
+            updateIndex(startSeq, groupMinMs, groupMaxMs, groupBoot);
+        }
+        groupValid = false;
+    }
+    
+    headSeq++;
+    blocksSinceHeader++;
+    
+    // Nächster Block überschreibt den ältesten
+    if (headSeq - tailSeq >= blockCount) {
+        tailSeq = headSeq - blockCount + 1;
+        stats.overwritten++;
+    }
+    resetBlock();
+    
+    // Erster Umlauf: Blöcke vor dem Head nullen (schreibt auch den Kopf)
+    if (initBlocks < blockCount && headSeq + LOG_RING_INIT_BLOCKS / 2 > initBlocks) {
+        ok = initAhead() && ok;
+    }
+    if (blocksSinceHeader >= LOG_RING_HEADER_INTERVAL) {
+        ok = writeHeader() && ok;
+    }
+    return ok;
+}
+
+void CircularLog::migrate() {
+    // Einmalige Umstellung: Append-Log bzw. Ringdatei einer älteren Firmware
+    // oder anderen Konfiguration nicht verwerfen, sondern beiseitelegen
+    char magic[sizeof(LOG_RING_MAGIC) - 1] = {};
+    bool ring = file.seek(0) && file.read((uint8_t*)magic, sizeof(magic)) == sizeof(magic) &&
+                memcmp(magic, LOG_RING_MAGIC, sizeof(magic)) == 0;
+    size_t size = file.size();
+    file.close();
+    if (size == 0) return;
+    
+    const char* kind = ring ? "Ringdatei mit anderem Format" : "Log der älteren Firmware";
+    char oldPath[SD_MAX_PATH + 4];
+    snprintf(oldPath, sizeof(oldPath), "%s.old", path);
+    if (sd->fileExists(oldPath)) sd->deleteFile(oldPath);
+    if (sd->renameFile(path, oldPath)) {
+        DEBUG_PRINTF("CircularLog: ⚠️ %s ist %s (%lu Bytes), einmalig nach %s verschoben\n",
+                     path, kind, (unsigned long)size, oldPath);
+    } else {
+        DEBUG_PRINTF("CircularLog: ⚠️ %s ist %s (%lu Bytes) und wird ersetzt\n",
+                     path, kind, (unsigned long)size);
+    }
+}
+
+bool CircularLog::initAhead() {
+    static const uint8_t zero[LOG_RING_BLOCK_SIZE] = {};
+    
+    uint32_t target = headSeq + LOG_RING_INIT_BLOCKS;
+    if (target > blockCount) target = blockCount;
+    
+    // Fortlaufende Blöcke ab initBlocks (Offset des Blocks initBlocks + 1)
+    bool ok = true;
+    if (initBlocks < target) {
+        int64_t startUs = esp_timer_get_time();
+        ok = file.seek(LOG_RING_BLOCK_SIZE * (1 + initBlocks));
+        for (uint32_t i = initBlocks; ok && i < target; i++) {
+            ok = file.write(zero, LOG_RING_BLOCK_SIZE) == LOG_RING_BLOCK_SIZE;
+        }
+        uint32_t elapsed = esp_timer_get_time() - startUs;
+        if (elapsed > stats.maxWriteUs) stats.maxWriteUs = elapsed;
+        
+        if (!ok) {
+            stats.writeErrors++;
+            DEBUG_PRINTF("CircularLog: ❌ Blöcke nullen fehlgeschlagen: %s\n", path);
+            return false;
+        }
+        initBlocks = target;
+    }
+    
+    // Kopf mit neuem initBlocks vor den ersten Daten in diesen Blöcken
+    return writeHeader();
+}
+
+bool CircularLog::writeHeader() {
+    LogRingHeader header = {};
+    memcpy(header.magic, LOG_RING_MAGIC, sizeof(header.magic));
+    header.version = LOG_RING_VERSION;
+    header.format = format;
+    header.schemaVersion = LOG_BIN_VERSION;
+    header.blockSize = LOG_RING_BLOCK_SIZE;
+    header.blockCount = blockCount;
+    header.headSeq = headSeq;
+    header.tailSeq = tailSeq;
+    header.headOffset = blockOffset(headSeq);
+    header.tailOffset = blockOffset(tailSeq);
+    header.initBlocks = initBlocks;
+    header.boot = boot;
+    headerSeq = headSeq;
+    
+    bool ok = file.seek(0) && file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    
+    stats.headerWrites++;
+    if (!ok) stats.writeErrors++;
+    blocksSinceHeader = 0;
+    return ok;
+}
@@ -0,0 +1,302 @@
+/**
+ * CircularLog.h
+ *
+ * Vorallokierte Ringdatei für Logs
+ *
+ * Features:
+ * - Datei wird einmalig in voller Größe angelegt (Cluster-Kette steht danach fest),
+ *   genullt wird nur vor dem Head (LOG_RING_INIT_BLOCKS je Schritt im Writer)
+ * - Schreiben nur noch durch Überschreiben an Ort und Stelle (kein Append,
+ *   kein Rename/Delete, keine Cluster-Allokation im Dauerbetrieb)
+ * - Blöcke = SD-Sektoren (512 Bytes), Records überspannen keine Blockgrenze
+ * - Kopf mit Head/Tail wird nur alle LOG_RING_HEADER_INTERVAL Blöcke geschrieben,
+ *   beim Öffnen wird der Head über die Block-Sequenzen nachgezogen
+ * - Zeitindex als Sidecar-Datei (<pfad>.idx): Min/Max-Zeitstempel je Gruppe von
+ *   LOG_RING_INDEX_STRIDE Blöcken, beim Schreiben fortgeschrieben → readRange()
+ *   liest nur die Blöcke des gesuchten Zeitfensters
+ * - Boot-Nummer pro Öffnen: millis() beginnt je Boot bei 0, readRange() liefert
+ *   nur Blöcke eines Boots (Standard: aktueller)
+ * - Optional LZ-Kompression pro Block (LogCompress.h): Records werden beim
+ *   Anhängen komprimiert, jeder Block bleibt für sich dekodierbar
+ * - Layout in LogSchema.h (gemeinsam mit tools/logdecode)
+ *
+ * Nicht thread-safe: Aufrufer serialisiert (LogManager: drainMutex)
+ */
+
+#ifndef CIRCULAR_LOG_H
+#define CIRCULAR_LOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <functional>
+#include "config.h"
+#include "SDCardHandler.h"
+#include "LogSchema.h"
+#include "LogCompress.h"
+
+#ifndef LOG_RING_HEADER_INTERVAL
+#define LOG_RING_HEADER_INTERVAL    16      // Kopf spätestens nach so vielen Blöcken schreiben
+#endif
+
+#ifndef LOG_RING_INDEX_STRIDE
+#define LOG_RING_INDEX_STRIDE       16      // Blöcke pro Zeitindex-Eintrag
+#endif
+
+#ifndef LOG_RING_INIT_BLOCKS
+#define LOG_RING_INIT_BLOCKS        32      // Blöcke pro Null-Schritt vor dem Head (erster Umlauf)
+#endif
+
+// Nutzdaten pro Block
+#define LOG_RING_PAYLOAD_SIZE   (LOG_RING_BLOCK_SIZE - sizeof(LogRingBlockHeader))
+
+/**
+ * Callback für readRange(): Records eines Blocks
+ * @return false = Abfrage abbrechen
+ */
+typedef std::function<bool(const uint8_t* data, size_t len)> CircularLogBlockCallback;
+
+/**
+ * Statistik einer Ringdatei
+ */
+struct CircularLogStats {
+    uint32_t blockWrites;           // Geschriebene Blöcke (voll oder Teilblock)
+    uint32_t headerWrites;          // Geschriebene Köpfe
+    uint32_t indexWrites;           // Geschriebene Index-Einträge
+    uint32_t overwritten;           // Überschriebene (älteste) Blöcke
+    uint32_t writeErrors;           // Fehlgeschlagene Schreibvorgänge
+    uint32_t maxWriteUs;            // Längster Block-Schreibvorgang
+    uint32_t rawBytes;              // Records vor Kompression (nur komprimierte Blöcke)
+    uint32_t packedBytes;           // Records nach Kompression
+    uint32_t compressUs;            // CPU-Zeit der Kompression gesamt
+};
+
+class CircularLog {
+public:
+    /**
+     * Konstruktor
+     */
+    CircularLog();
+    
+    /**
+     * Ringdatei öffnen (bei fehlender oder unpassender Datei neu anlegen)
+     * @param sd SD-Handler
+     * @param path Dateipfad
+     * @param blockCount Anzahl Datenblöcke
+     * @param format LOG_RING_FORMAT_TEXT oder LOG_RING_FORMAT_BINARY
+     * @param compress Neue Blöcke LZ-komprimieren
+     * @return true bei Erfolg
+     */
+    bool open(SDCardHandler& sd, const char* path, uint32_t blockCount, uint8_t format,
+              bool compress = false);
+    
+    /**
+     * Ausstehende Daten schreiben und Datei schließen
+     */
+    void close();
+    
+    /**
+     * Ist die Datei geöffnet?
+     */
+    bool isOpen() const { return opened; }
+    
+    /**
+     * Kompression ein-/ausschalten (angefangener Block wird abgeschlossen)
+     */
+    void setCompression(bool enable);
+    
+    /**
+     * Werden neue Blöcke komprimiert?
+     */
+    bool isCompressed() const { return compress; }
+    
+    /**
+     * Record anhängen (wird bei Bedarf in den nächsten Block gelegt)
+     * @param data Record-Bytes
+     * @param len Länge (max. LOG_RING_PAYLOAD_SIZE)
+     * @param timestampMs Zeitstempel des Records (für Block-Kopf und Index)
+     * @return false bei Schreibfehler oder zu langem Record
+     */
+    bool append(const uint8_t* data, size_t len, uint32_t timestampMs);
+    
+    /**
+     * Blöcke lesen, die Records im Zeitfenster enthalten können (älteste zuerst)
+     * Über Index und Block-Köpfe werden nur passende Blöcke gelesen,
+     * der Aufrufer filtert die einzelnen Records.
+     * @param fromMs Beginn (inklusive)
+     * @param toMs Ende (inklusive)
+     * @param callback Aufruf pro Block mit Records
+     * @param boot Boot-Nummer der Zeitstempel (0 = aktueller Boot)
+     * @return Gelesene Blöcke, -1 bei Fehler
+     */
+    int readRange(uint32_t fromMs, uint32_t toMs, CircularLogBlockCallback callback, uint32_t boot = 0);
+    
+    /**
+     * Teilblock und Kopf schreiben
+     */
+    bool flush();
+    
+    /**
+     * Teilblock schreiben wenn er älter als maxAgeMs ist
+     */
+    void flushIfDue(uint32_t maxAgeMs);
+    
+    /**
+     * Inhalt verwerfen (nur Kopf wird geschrieben)
+     */
+    void clear();
+    
+    /**
+     * Belegte Nutzbytes (volle Blöcke zählen voll)
+     */
+    size_t getUsedBytes() const;
+    
+    /**
+     * Kapazität in Nutzbytes
+     */
+    size_t getCapacity() const { return blockCount * LOG_RING_PAYLOAD_SIZE; }
+    
+    /**
+     * Sequenz des Schreib-Blocks
+     */
+    uint32_t getHeadSeq() const { return headSeq; }
+    
+    /**
+     * Älteste gültige Sequenz
+     */
+    uint32_t getTailSeq() const { return tailSeq; }
+    
+    /**
+     * Boot-Nummer der neu geschriebenen Records
+     */
+    uint32_t getBoot() const { return boot; }
+    
+    /**
+     * Statistik abrufen
+     */
+    void getStats(CircularLogStats* stats);
+
+private:
+    bool opened;
+    SDCardHandler* sd;
+    File file;
+    char path[SD_MAX_PATH];
+    uint32_t blockCount;
+    uint8_t format;
+    
+    // Head/Tail als Block-Sequenzen (Index = (seq - 1) % blockCount)
+    uint32_t headSeq;
+    uint32_t tailSeq;
+    uint32_t blocksSinceHeader;
+    uint32_t headerSeq;             // Head laut Kopf beim Öffnen (Index-Reparatur ab hier)
+    uint32_t initBlocks;            // Genullte Datenblöcke (blockCount = alle)
+    uint32_t boot;                  // Boot-Nummer dieses Öffnens
+    
+    // Schreib-Block im RAM
+    uint8_t block[LOG_RING_BLOCK_SIZE];
+    size_t fill;                    // Bytes im Block inkl. Kopf
+    bool dirty;                     // Ungeschriebene Daten
+    unsigned long dirtySince;
+    uint32_t blockMinMs;            // Zeitspanne der Records im Block
+    uint32_t blockMaxMs;
+    
+    // Zeitspanne der aktuellen Blockgruppe (Index-Eintrag wenn sie voll ist)
+    bool groupValid;
+    uint32_t groupMinMs;
+    uint32_t groupMaxMs;
+    uint32_t groupBoot;             // 0 = Blöcke aus mehreren Boots
+    
+    // Kompression (nur wenn aktiv: Rohdaten des Schreib-Blocks als Fenster)
+    bool compress;
+    uint8_t* raw;
+    size_t rawLen;
+    LogLzState* lz;
+    
+    // Zeitindex (RAM-Kopie der Sidecar-Datei)
+    File indexFile;
+    LogRingIndexEntry* index;
+    uint32_t indexEntries;
+    
+    CircularLogStats stats;
+    
+    /**
+     * Datei-Offset eines Blocks
+     */
+    uint32_t blockOffset(uint32_t seq) const;
+    
+    /**
+     * Neue Datei in voller Größe anlegen (nur Kopf und erste Blöcke genullt)
+     */
+    bool create();
+    
+    /**
+     * Nicht ladbare Datei (ältere Firmware oder andere Konfiguration) nach <pfad>.old verschieben
+     */
+    void migrate();
+    
+    /**
+     * Blöcke ab initBlocks nullen, bis der Head LOG_RING_INIT_BLOCKS Vorlauf hat
+     * (nur im ersten Umlauf, Kopf wird danach geschrieben)
+     */
+    bool initAhead();
+    
+    /**
+     * Kopf lesen, prüfen und Head nachziehen
+     */
+    bool load();
+    
+    /**
+     * Index-Datei öffnen, bei Bedarf aus den Block-Köpfen neu aufbauen
+     * @param rebuild true = vorhandene Index-Datei ignorieren
+     */
+    bool openIndex(bool rebuild);
+    
+    /**
+     * Index-Eintrag einer vollen Gruppe schreiben
+     * @param startSeq Sequenz des ersten Blocks der Gruppe
+     */
+    void updateIndex(uint32_t startSeq, uint32_t minMs, uint32_t maxMs, uint32_t groupBoot);
+    
+    /**
+     * Einträge der seit fromSeq vollendeten Gruppen aus den Block-Köpfen
+     * nachtragen und Zeitspanne der aktuellen Gruppe laden (nach Neustart)
+     */
+    void repairIndex(uint32_t fromSeq);
+    
+    /**
+     * Zeitspanne und Boot-Nummer (0 = gemischt) der Blöcke fromSeq..toSeq aus ihren Köpfen
+     * @return false wenn ein Block fehlt (überschrieben oder leer)
+     */
+    bool scanBlocks(uint32_t fromSeq, uint32_t toSeq, uint32_t* minMs, uint32_t* maxMs, uint32_t* blocksBoot);
+    
+    /**
+     * Sequenz des ersten Blocks der Gruppe von seq
+     */
+    uint32_t groupStart(uint32_t seq) const;
+    
+    /**
+     * Anzahl Blöcke der Gruppe von seq (letzte Gruppe kann kürzer sein)
+     */
+    uint32_t groupLength(uint32_t seq) const;
+    
+    /**
+     * Schreib-Block leeren (neue Sequenz)
+     */
+    void resetBlock();
+    
+    /**
+     * Schreib-Block an seiner Position schreiben
+     */
+    bool writeBlock();
+    
+    /**
+     * Vollen Block schreiben und zum nächsten wechseln
+     */
+    bool advance();
+    
+    /**
+     * Kopf schreiben
+     */
+    bool writeHeader();
+};
+
+#endif // CIRCULAR_LOG_H
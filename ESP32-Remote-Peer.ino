@@ -1,9 +1,15 @@
 #include "BatteryMonitor.h"
 #include "ESPNowManager.h"
 #include "SDCardHandler.h"
+#include "MotorOutput.h"
+#include "FlightRecorder.h"
+#include "PacketCapture.h"
 BatteryMonitor battery;
 ESPNowManager ESPNow;
 SDCardHandler sdCard;
+MotorOutput motors;
+FlightRecorder flightRecorder(sdCard);
+PacketCapture capture(sdCard);
 
 // Timing für Logging
 unsigned long lastBatteryLog = 0;
@@ -48,6 +54,12 @@ void setup() {
         espnow.setHeartbeat(true, config.espnowHeartbeatInterval);
         espnow.setTimeout(config.espnowTimeout);
         
+        // Motor-Befehle nur vom Haupt-Controller (andere Peers werden verworfen)
+        uint8_t controllerMac[6];
+        if (EspNowManager::stringToMac(ESPNOW_MAIN_DEVICE_MAC, controllerMac)) {
+            espnow.setMotorSource(controllerMac);
+        }
+        
         sdCard.logSetupStep("ESP-NOW", true, espnow.getOwnMacString().c_str());
         
         // Events für Logging registrieren
@@ -63,16 +75,57 @@ void setup() {
             Serial.printf("ESP-NOW: Peer %s disconnected\n", mac.c_str());
         });
         
+        // Not-Aus: Handler läuft direkt im Empfangs-Callback (kein Logging dort!)
+        espnow.setEmergencyStopHandler([](const uint8_t* mac, uint16_t stopId) {
+            motors.emergencyStop();
+        });
+        
+        espnow.onEvent(EspNowEvent::EMERGENCY_STOP, [](EspNowEventData* data) {
+            String mac = EspNowManager::macToString(data->mac);
+            sdCard.logConnection(mac.c_str(), "emergency stop");
+            Serial.printf("ESP-NOW: Not-Aus von %s\n", mac.c_str());
+        });
+        
         espnow.onEvent(EspNowEvent::HEARTBEAT_TIMEOUT, [](EspNowEventData* data) {
             String mac = EspNowManager::macToString(data->mac);
             sdCard.logConnection(mac.c_str(), "timeout");
             Serial.printf("ESP-NOW: Peer %s timeout\n", mac.c_str());
         });
+        
+        // Flight-Recorder: Funkverkehr im PSRAM, Dump bei Verbindungsverlust
+        if (flightRecorder.begin()) {
+            sdCard.logSetupStep("FlightRecorder", true);
+            battery.setShutdownCallback([](float voltage) {
+                // Danach folgt Deep-Sleep: Dump abwarten (Dump-Task hat niedrige Priorität)
+                flightRecorder.trigger(FLIGHT_TRIGGER_BATTERY_SHUTDOWN);
+                if (!flightRecorder.waitForDump(FLIGHT_RECORDER_SHUTDOWN_WAIT_MS)) {
+                    Serial.println("FlightRecorder: ⚠️ Dump vor Shutdown nicht fertig");
+                }
+            });
+        } else {
+            sdCard.logSetupStep("FlightRecorder", false, "No memory");
+        }
+        
+#if ESPNOW_CAPTURE
+        // Protokoll-Debugging: Mitschnitt aller Frames für Wireshark
+        sdCard.logSetupStep("Capture", capture.start());
+#endif
     } else {
         sdCard.logSetupStep("ESP-NOW", false, "WiFi init error");
         sdCard.logError("ESP-NOW", 3, "esp_now_init() failed");
     }
 
+    // ═══════════════════════════════════════════════════════════════
+    // Motor-Ausgabe (eigener Task, unabhängig von loop())
+    // ═══════════════════════════════════════════════════════════════
+    Serial.println("→ Motoren...");
+    if (motors.begin(MOTOR_OUTPUT_RATE_HZ)) {
+        Serial.println("  ✅ Motor-Ausgabe OK");
+        sdCard.logSetupStep("Motors", true);
+    } else {
+        sdCard.logSetupStep("Motors", false, "Task/Timer error");
+    }
+
     // ═══════════════════════════════════════════════════════════════
     // Setup Complete
     // ═══════════════════════════════════════════════════════════════
@@ -124,13 +177,13 @@ void loop() {
   
   // Connection-Stats loggen (alle 5 Minuten)
   if (sdCard.isAvailable() && (millis() - lastConnectionLog > 300000)) {
-      if (espnow.isConnected()) {
-          // Vereinfacht: Stats vom System
-          int rxPending, txPending, resultPending;
-          espnow.getQueueStats(&rxPending, &txPending, &resultPending);
-          
-          String mac = espnow.getOwnMacString();
-          sdCard.logConnectionStats(mac.c_str(), 0, 0, 0, 0, 0, -65);
+      uint8_t mainMac[6];
+      EspNowLinkQuality link;
+      if (espnow.isConnected() &&
+          EspNowManager::stringToMac(ESPNOW_MAIN_DEVICE_MAC, mainMac) &&
+          espnow.getLinkQuality(mainMac, &link)) {
+          sdCard.logConnectionStats(ESPNOW_MAIN_DEVICE_MAC, link.packetsSent,
+                                    link.packetsReceived, link.packetsLost, link.rssiAvg);
       }
       lastConnectionLog = millis();
   }
@@ -8,19 +8,83 @@
 #include "EspNowManager.h"
 #include <esp_wifi.h>
 
+// ═══════════════════════════════════════════════════════════════════════════
+// KOMPAKTE KODIERUNG - HELPER
+// ═══════════════════════════════════════════════════════════════════════════
+
+namespace {
+
+inline uint32_t zigzagEncode(int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t v) {
+    return static_cast<int32_t>((v >> 1) ^ (~(v & 1) + 1));
+}
+
+size_t writeVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = static_cast<uint8_t>(v) | 0x80;
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+bool readVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        v |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Feldbreite 1/2/4 Byte ↔ 2-Bit-Code im Format-Byte
+inline uint8_t widthFromCode(uint8_t code) {
+    return code == 0 ? 1 : (code == 1 ? 2 : 4);
+}
+
+// Format-Byte: [7:6] Codec, [5:4] Breite, [3] Referenz folgt, [2:0] Felder - 1
+const uint8_t CODEC_HAS_REF = 0x08;
+
+}  // namespace
+
+EspNowCodecStats EspNowPacket::codecStats = {};
+
+EspNowCodecStream* EspNowCodecContext::find(DataCmd cmd, bool create) {
+    for (int i = 0; i < streamCount; i++) {
+        if (streams[i].cmd == cmd) return &streams[i];
+    }
+    if (!create || streamCount >= ESPNOW_CODEC_MAX_STREAMS) return nullptr;
+    
+    EspNowCodecStream& stream = streams[streamCount++];
+    memset(&stream, 0, sizeof(stream));
+    stream.cmd = cmd;
+    return &stream;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // ESPNOWPACKET - BUILDER & PARSER
 // ═══════════════════════════════════════════════════════════════════════════
 
 EspNowPacket::EspNowPacket()
-    : entryCount(0)
+    : decodeBuf(nullptr)
+    , decodeSize(0)
+    , decodePos(0)
+    , packedEntry(-1)
+    , hasCodecRefs(false)
+    , entryCount(0)
     , mainCmd(MainCmd::NONE)
     , dataLength(0)
     , writePos(2)  // Nach Header starten
     , valid(false)
 {
-    memset(buffer, 0, ESPNOW_MAX_PACKET_SIZE);
-    memset(entries, 0, sizeof(entries));
+    // Nur der Header muss definiert sein, Nutzdaten werden vor dem Lesen geschrieben
+    buffer[0] = 0;
+    buffer[1] = 0;
 }
 
 EspNowPacket::~EspNowPacket() {
@@ -72,6 +136,7 @@ EspNowPacket& EspNowPacket::add(DataCmd dataCmd, const void* data, size_t len) {
     entries[entryCount].cmd = dataCmd;
     entries[entryCount].offset = writePos - 2;  // Position im Buffer
     entries[entryCount].length = len;
+    entries[entryCount].decoded = false;
     entryCount++;
     
     writePos += len;
@@ -111,10 +176,118 @@ EspNowPacket& EspNowPacket::addFloat(DataCmd dataCmd, float value) {
     return add(dataCmd, &value, 4);
 }
 
+EspNowPacket& EspNowPacket::addPackedInt16(DataCmd dataCmd, const int16_t* values, uint8_t count,
+                                           EspNowCodec codec, EspNowCodecContext* ctx) {
+    if (!values || count == 0 || count > ESPNOW_CODEC_MAX_FIELDS) return *this;
+    
+    int32_t fields[ESPNOW_CODEC_MAX_FIELDS];
+    for (int i = 0; i < count; i++) {
+        fields[i] = values[i];
+    }
+    return addPacked(dataCmd, fields, count, 2, codec, ctx);
+}
+
+EspNowPacket& EspNowPacket::addPacked(DataCmd dataCmd, const int32_t* fields, uint8_t count, uint8_t width,
+                                      EspNowCodec codec, EspNowCodecContext* ctx) {
+    if (!valid || !fields || count == 0 || count > ESPNOW_CODEC_MAX_FIELDS) return *this;
+    if (width != 1 && width != 2 && width != 4) return *this;
+    uint8_t widthCode = (width == 1) ? 0 : (width == 2 ? 1 : 2);
+    
+    // Referenz/Delta aus Kontext bestimmen (Kontext ändert sich erst beim Senden, commitCodec)
+    EspNowCodecStream* stream = ctx ? ctx->find(dataCmd, true) : nullptr;
+    bool isDelta = codec == EspNowCodec::DELTA && stream && stream->valid &&
+                   stream->count == count && stream->sinceAbs < ESPNOW_CODEC_ABS_INTERVAL;
+    if (codec == EspNowCodec::DELTA && !isDelta) {
+        codec = EspNowCodec::VARINT;    // Absolutwert (erster Wert, Resync, kein Kontext)
+    }
+    
+    uint32_t zz[ESPNOW_CODEC_MAX_FIELDS];
+    for (int i = 0; i < count; i++) {
+        zz[i] = zigzagEncode(isDelta ? fields[i] - stream->last[i] : fields[i]);
+    }
+    
+    // Eintrag kodieren: [DataCmd] [Format] [Ref?] [Bits?] [Payload]
+    uint8_t rec[4 + ESPNOW_CODEC_MAX_FIELDS * 5];
+    size_t n = 0;
+    rec[n++] = static_cast<uint8_t>(dataCmd);
+    rec[n++] = (static_cast<uint8_t>(codec) << 6) | (widthCode << 4) |
+               (stream ? CODEC_HAS_REF : 0) | (count - 1);
+    if (stream) {
+        rec[n++] = stream->ref + 1;
+    }
+    
+    if (codec == EspNowCodec::BITPACK) {
+        uint8_t bits = 1;
+        for (int i = 0; i < count; i++) {
+            while (bits < 32 && (zz[i] >> bits)) bits++;
+        }
+        rec[n++] = bits;
+        
+        // LSB-first in Bytes packen
+        size_t bytes = (count * bits + 7) / 8;
+        memset(&rec[n], 0, bytes);
+        uint32_t bitPos = 0;
+        for (int i = 0; i < count; i++) {
+            for (uint8_t b = 0; b < bits; b++, bitPos++) {
+                if ((zz[i] >> b) & 1) rec[n + bitPos / 8] |= 1 << (bitPos % 8);
+            }
+        }
+        n += bytes;
+    } else {
+        for (int i = 0; i < count; i++) {
+            n += writeVarint(&rec[n], zz[i]);
+        }
+    }
+    
+    // An offenen PACKED-Eintrag anhängen oder neuen beginnen
+    bool extend = packedEntry >= 0 &&
+                  entries[packedEntry].offset + 2 + entries[packedEntry].length == writePos &&
+                  entries[packedEntry].length + n <= 255;
+    size_t needed = n + (extend ? 0 : 2);
+    
+    if (writePos + needed > ESPNOW_MAX_PACKET_SIZE) {
+        DEBUG_PRINTLN("EspNowPacket: ❌ Kein Platz mehr im Paket!");
+        return *this;
+    }
+    
+    if (!extend) {
+        if (entryCount >= MAX_ENTRIES) {
+            DEBUG_PRINTLN("EspNowPacket: ❌ Maximale Einträge erreicht!");
+            return *this;
+        }
+        packedEntry = entryCount++;
+        entries[packedEntry].cmd = DataCmd::PACKED;
+        entries[packedEntry].offset = writePos;
+        entries[packedEntry].length = 0;
+        entries[packedEntry].decoded = false;
+        buffer[writePos++] = static_cast<uint8_t>(DataCmd::PACKED);
+        buffer[writePos++] = 0;
+    }
+    
+    memcpy(&buffer[writePos], rec, n);
+    writePos += n;
+    entries[packedEntry].length += n;
+    buffer[entries[packedEntry].offset + 1] = entries[packedEntry].length;
+    
+    dataLength = writePos - 2;
+    buffer[1] = static_cast<uint8_t>(dataLength);
+    
+    codecStats.entriesEncoded++;
+    codecStats.rawBytes += 2 + count * width;
+    codecStats.encodedBytes += needed;
+    
+    return *this;
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // PARSER
 // ─────────────────────────────────────────────────────────────────────────────
 
+void EspNowPacket::setDecodeBuffer(uint8_t* buf, size_t size) {
+    decodeBuf = buf;
+    decodeSize = buf ? size : 0;
+}
+
 bool EspNowPacket::parse(const uint8_t* rawData, size_t len) {
     clear();
     
@@ -156,6 +329,7 @@ bool EspNowPacket::parse(const uint8_t* rawData, size_t len) {
             entries[entryCount].cmd = subCmd;
             entries[entryCount].offset = pos;  // Position im Buffer
             entries[entryCount].length = subLen;
+            entries[entryCount].decoded = false;
             entryCount++;
         }
         
@@ -163,9 +337,163 @@ bool EspNowPacket::parse(const uint8_t* rawData, size_t len) {
     }
     
     valid = true;
+    
+    // Kompakte Einträge ohne Referenz sofort dekodieren
+    decodePacked(nullptr);
+    return true;
+}
+
+void EspNowPacket::resolveDeltas(EspNowCodecContext& ctx) {
+    if (hasCodecRefs) {
+        decodePacked(&ctx);
+    }
+}
+
+void EspNowPacket::commitCodec(EspNowCodecContext& ctx) {
+    if (hasCodecRefs) {
+        decodePacked(&ctx, false);
+    }
+}
+
+void EspNowPacket::decodePacked(EspNowCodecContext* ctx, bool emit) {
+    // Ohne Kontext: VARINT/BITPACK dekodieren, DELTA zurückstellen
+    // Mit Kontext:  Kontext fortschreiben, nur DELTA dekodieren (emit = false: nur Kontext)
+    int rawEntries = entryCount;
+    for (int e = 0; e < rawEntries; e++) {
+        if (entries[e].cmd != DataCmd::PACKED || entries[e].decoded) continue;
+        
+        const uint8_t* p = &buffer[entries[e].offset + 2];
+        const uint8_t* end = p + entries[e].length;
+        
+        while (p + 2 <= end) {
+            DataCmd cmd = static_cast<DataCmd>(p[0]);
+            uint8_t fmt = p[1];
+            p += 2;
+            
+            EspNowCodec codec = static_cast<EspNowCodec>(fmt >> 6);
+            uint8_t widthCode = (fmt >> 4) & 0x03;
+            bool hasRef = fmt & CODEC_HAS_REF;
+            uint8_t count = (fmt & 0x07) + 1;
+            if (widthCode > 2 || static_cast<uint8_t>(codec) > 2) return;   // Unbekanntes Format
+            
+            uint8_t ref = 0;
+            if (hasRef) {
+                if (p >= end) return;
+                ref = *p++;
+                hasCodecRefs = true;
+            }
+            
+            int32_t values[ESPNOW_CODEC_MAX_FIELDS];
+            if (codec == EspNowCodec::BITPACK) {
+                if (p >= end) return;
+                uint8_t bits = *p++;
+                size_t bytes = (count * bits + 7) / 8;
+                if (bits == 0 || bits > 32 || p + bytes > end) return;
+                
+                uint32_t bitPos = 0;
+                for (int i = 0; i < count; i++) {
+                    uint32_t v = 0;
+                    for (uint8_t b = 0; b < bits; b++, bitPos++) {
+                        if ((p[bitPos / 8] >> (bitPos % 8)) & 1) v |= 1UL << b;
+                    }
+                    values[i] = zigzagDecode(v);
+                }
+                p += bytes;
+            } else {
+                for (int i = 0; i < count; i++) {
+                    uint32_t v;
+                    if (!readVarint(p, end, v)) return;
+                    values[i] = zigzagDecode(v);
+                }
+            }
+            
+            if (!ctx) {
+                if (codec != EspNowCodec::DELTA) {
+                    appendDecoded(cmd, values, count, widthFromCode(widthCode));
+                }
+                continue;
+            }
+            
+            // Kontext: nur Einträge mit Referenz
+            if (!hasRef) continue;
+            EspNowCodecStream* stream = ctx->find(cmd, true);
+            if (!stream) continue;
+            
+            // Verspäteter oder doppelter Eintrag (Reorder, FEC-Rekonstruktion):
+            // Referenz nicht zurücksetzen, sonst scheitern alle folgenden Deltas
+            if (stream->valid && static_cast<int8_t>(ref - stream->ref) <= 0) {
+                if (emit && codec == EspNowCodec::DELTA) codecStats.deltaMisses++;
+                continue;
+            }
+            
+            if (codec == EspNowCodec::DELTA) {
+                // Delta nur gegen den unmittelbar vorherigen Wert gültig
+                if (!stream->valid || stream->count != count || static_cast<uint8_t>(stream->ref + 1) != ref) {
+                    stream->valid = false;
+                    if (emit) codecStats.deltaMisses++;
+                    continue;
+                }
+                for (int i = 0; i < count; i++) {
+                    values[i] += stream->last[i];
+                }
+                if (emit) appendDecoded(cmd, values, count, widthFromCode(widthCode));
+            }
+            
+            stream->valid = true;
+            stream->ref = ref;
+            stream->count = count;
+            stream->sinceAbs = codec == EspNowCodec::DELTA ? stream->sinceAbs + 1 : 0;
+            memcpy(stream->last, values, count * sizeof(int32_t));
+        }
+    }
+}
+
+bool EspNowPacket::appendDecoded(DataCmd cmd, const int32_t* values, uint8_t count, uint8_t width) {
+    size_t len = count * width;
+    if (!decodeBuf) return false;   // Kein Dekodier-Puffer: Eintrag bleibt nur als PACKED sichtbar
+    if (entryCount >= MAX_ENTRIES || decodePos + len > decodeSize) {
+        DEBUG_PRINTLN("EspNowPacket: ⚠️ Dekodier-Puffer voll");
+        return false;
+    }
+    
+    // Native Breite (Little-Endian wie memcpy beim Sender)
+    uint8_t* out = &decodeBuf[decodePos];
+    for (int i = 0; i < count; i++) {
+        if (width == 1) {
+            out[i] = static_cast<uint8_t>(values[i]);
+        } else if (width == 2) {
+            int16_t v = static_cast<int16_t>(values[i]);
+            memcpy(&out[i * 2], &v, 2);
+        } else {
+            memcpy(&out[i * 4], &values[i], 4);
+        }
+    }
+    
+    entries[entryCount].cmd = cmd;
+    entries[entryCount].offset = decodePos;
+    entries[entryCount].length = len;
+    entries[entryCount].decoded = true;
+    entryCount++;
+    decodePos += len;
+    
+    codecStats.entriesDecoded++;
+    return true;
+}
+
+bool EspNowPacket::getEntry(int index, DataCmd* cmd, const uint8_t** data, size_t* len) const {
+    if (index < 0 || index >= entryCount) return false;
+    
+    const DataEntry& entry = entries[index];
+    if (cmd) *cmd = entry.cmd;
+    if (len) *len = entry.length;
+    if (data) *data = entry.decoded ? &decodeBuf[entry.offset] : &buffer[entry.offset + 2];
     return true;
 }
 
+void EspNowPacket::getCodecStats(EspNowCodecStats* stats) {
+    if (stats) *stats = codecStats;
+}
+
 bool EspNowPacket::has(DataCmd dataCmd) const {
     return findEntry(dataCmd) >= 0;
 }
@@ -179,6 +507,11 @@ const uint8_t* EspNowPacket::getData(DataCmd dataCmd, size_t* outLen) const {
     
     if (outLen) *outLen = entries[idx].length;
     
+    // Dekodierte Werte liegen direkt in decodeBuf
+    if (entries[idx].decoded) {
+        return &decodeBuf[entries[idx].offset];
+    }
+    
     // Daten beginnen 2 Bytes nach Offset (nach SUB_CMD + LEN)
     return &buffer[entries[idx].offset + 2];
 }
@@ -251,13 +584,16 @@ bool EspNowPacket::getFloat(DataCmd dataCmd, float& outValue) const {
 // ─────────────────────────────────────────────────────────────────────────────
 
 void EspNowPacket::clear() {
-    memset(buffer, 0, ESPNOW_MAX_PACKET_SIZE);
-    memset(entries, 0, sizeof(entries));
+    buffer[0] = 0;
+    buffer[1] = 0;
     entryCount = 0;
     mainCmd = MainCmd::NONE;
     dataLength = 0;
     writePos = 2;
     valid = false;
+    decodePos = 0;
+    packedEntry = -1;
+    hasCodecRefs = false;
 }
 
 int EspNowPacket::findEntry(DataCmd cmd) const {
@@ -294,6 +630,137 @@ void EspNowPacket::print() const {
 }
 
 
+// ═══════════════════════════════════════════════════════════════════════════
+// IMU-BATCHING
+// ═══════════════════════════════════════════════════════════════════════════
+
+EspNowImuBatcher::EspNowImuBatcher(DataCmd dataCmd, uint8_t maxSamples, uint32_t deadlineMs)
+    : cmd(dataCmd)
+    , maxSamples(maxSamples > 0 && maxSamples <= ESPNOW_IMU_BATCH_MAX ? maxSamples : ESPNOW_IMU_BATCH_MAX)
+    , deadlineMs(deadlineMs)
+{
+    reset();
+}
+
+void EspNowImuBatcher::reset() {
+    used = 5;               // BASE_US + COUNT
+    count = 0;
+    full = false;
+    firstMs = 0;
+    memset(&last, 0, sizeof(last));
+}
+
+bool EspNowImuBatcher::addSample(int16_t x, int16_t y, int16_t z, uint32_t timestampUs) {
+    if (full) return false;
+    
+    if (count == 0) {
+        memcpy(buf, &timestampUs, 4);
+        last.timestampUs = timestampUs;
+        firstMs = millis();
+    }
+    
+    used += writeVarint(&buf[used], timestampUs - last.timestampUs);
+    used += writeVarint(&buf[used], zigzagEncode(x - last.x));
+    used += writeVarint(&buf[used], zigzagEncode(y - last.y));
+    used += writeVarint(&buf[used], zigzagEncode(z - last.z));
+    
+    last.timestampUs = timestampUs;
+    last.x = x;
+    last.y = y;
+    last.z = z;
+    count++;
+    
+    // Voll, wenn das nächste Sample im schlechtesten Fall (5 + 3×3 Byte) nicht mehr passt
+    full = (count >= maxSamples) || (used + 14 > sizeof(buf));
+    return true;
+}
+
+bool EspNowImuBatcher::isDue() const {
+    return full || (count > 0 && (millis() - firstMs) >= deadlineMs);
+}
+
+bool EspNowImuBatcher::appendTo(EspNowPacket& packet) {
+    if (count == 0) return false;
+    
+    size_t before = packet.getDataLength();
+    buf[4] = count;
+    packet.add(cmd, buf, used);
+    if (packet.getDataLength() == before) return false;
+    
+    reset();
+    return true;
+}
+
+bool EspNowImuBatcher::flush(const uint8_t* mac, EspNowLane lane) {
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE);
+    if (!appendTo(packet)) return false;
+    
+    EspNowManager& mgr = EspNowManager::getInstance();
+    return mac ? mgr.send(mac, packet, lane) : mgr.broadcast(packet, ESPNOW_GROUP_ALL, lane);
+}
+
+int EspNowImuBatcher::decode(const uint8_t* data, size_t len, EspNowImuSample* out, int maxSamples) {
+    if (!data || !out || len < 5) return 0;
+    
+    EspNowImuSample cur;
+    memcpy(&cur.timestampUs, data, 4);
+    cur.x = cur.y = cur.z = 0;
+    uint8_t n = data[4];
+    
+    const uint8_t* p = data + 5;
+    const uint8_t* end = data + len;
+    int decoded = 0;
+    
+    for (int i = 0; i < n && decoded < maxSamples; i++) {
+        uint32_t dt, dx, dy, dz;
+        if (!readVarint(p, end, dt) || !readVarint(p, end, dx) ||
+            !readVarint(p, end, dy) || !readVarint(p, end, dz)) {
+            break;
+        }
+        cur.timestampUs += dt;
+        cur.x += zigzagDecode(dx);
+        cur.y += zigzagDecode(dy);
+        cur.z += zigzagDecode(dz);
+        out[decoded++] = cur;
+    }
+    return decoded;
+}
+
+bool EspNowImuRing::push(const uint8_t* mac, const EspNowImuSample& sample) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= ESPNOW_IMU_RING_SIZE) {
+        dropped++;
+        return false;
+    }
+    Entry& entry = samples[h % ESPNOW_IMU_RING_SIZE];
+    entry.sample = sample;
+    memcpy(entry.mac, mac, 6);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool EspNowImuRing::pop(EspNowImuSample& sample, uint8_t* mac) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    
+    const Entry& entry = samples[t % ESPNOW_IMU_RING_SIZE];
+    sample = entry.sample;
+    if (mac) memcpy(mac, entry.mac, 6);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+const uint8_t* EspNowImuRing::peekMac() const {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return nullptr;
+    return samples[t % ESPNOW_IMU_RING_SIZE].mac;
+}
+
+int EspNowImuRing::available() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // ESPNOWMANAGER - SINGLETON
 // ═══════════════════════════════════════════════════════════════════════════
@@ -307,21 +774,123 @@ EspNowManager::EspNowManager()
     : initialized(false)
     , wifiChannel(ESPNOW_CHANNEL)
     , peersMutex(nullptr)
+    , hwPeerCount(0)
+    , hwEncryptCount(0)
+    , lruClock(0)
+    , autoDiscovery(false)
     , heartbeatEnabled(false)
     , heartbeatInterval(ESPNOW_HEARTBEAT_INTERVAL)
     , timeoutMs(ESPNOW_TIMEOUT_MS)
     , lastHeartbeatSent(0)
     , rxQueue(nullptr)
-    , txQueue(nullptr)
     , resultQueue(nullptr)
     , workerTaskHandle(nullptr)
     , workerRunning(false)
     , receiveCallback(nullptr)
     , sendCallback(nullptr)
 {
-    for (int i = 0; i < 12; i++) {
-        eventCallbacks[i] = nullptr;
-    }
+    memset(&swapStats, 0, sizeof(swapStats));
+    for (int i = 0; i < 8; i++) {
+        groupMask[i] = 0;
+    }
+    groupFiltered = 0;
+    fecEnabled = false;
+    fecK = ESPNOW_FEC_DEFAULT_K;
+    memset(&fecStats, 0, sizeof(fecStats));
+    
+    // Lanes: Standard-Raten aus config
+    const EspNowLaneConfig defaults[ESPNOW_LANE_COUNT] = {
+        { ESPNOW_LANE_CONTROL_RATE,   ESPNOW_LANE_CONTROL_BURST },
+        { ESPNOW_LANE_TELEMETRY_RATE, ESPNOW_LANE_TELEMETRY_BURST },
+        { ESPNOW_LANE_BULK_RATE,      ESPNOW_LANE_BULK_BURST }
+    };
+    for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+        txQueues[i] = nullptr;
+        txHeldCount[i] = 0;
+        laneConfig[i] = defaults[i];
+        broadcastBuckets[i].tokens = defaults[i].burst;
+        broadcastBuckets[i].lastUs = 0;
+    }
+    memset(laneStats, 0, sizeof(laneStats));
+    
+    // TX-Pool
+    for (int i = 0; i < ESPNOW_TX_POOL_SIZE; i++) {
+        txPool[i].refs.store(0);
+        txPool[i].lane = 0;
+        txPool[i].length = 0;
+    }
+    for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+        txLaneBuffers[i].store(0);
+    }
+    txPoolExhausted = 0;
+    
+    // Replizierter Zustand
+    stateMutex = nullptr;
+    memset(localState, 0, sizeof(localState));
+    localStateCount = 0;
+    memset(remoteStates, 0, sizeof(remoteStates));
+    stateVersion = 0;
+    memset(stateLastMac, 0, sizeof(stateLastMac));
+    memset(&stateStats, 0, sizeof(stateStats));
+    stateSyncEnabled = false;
+    memset(stateTarget, 0, sizeof(stateTarget));
+    stateBroadcast = true;
+    stateKeyframeMs = ESPNOW_STATE_KEYFRAME_MS;
+    stateLane = EspNowLane::CONTROL;
+    lastKeyframeSent = 0;
+    stateVersionSeen = 0;
+    
+    // Empfangspakete dekodieren kompakte Einträge in eigene Puffer
+    for (int i = 0; i < 2; i++) {
+        rxPackets[i].setDecodeBuffer(rxDecodeBuf[i], sizeof(rxDecodeBuf[i]));
+    }
+    
+    // Jitter-Buffer
+    jitterEnabled = false;
+    jitterPeriodUs = ESPNOW_JITTER_PERIOD_MS * 1000UL;
+    playoutCallback = nullptr;
+    memset(&motorCommand, 0, sizeof(motorCommand));
+    motorSeqValid = false;
+    motorSeqlock = 0;
+    motorSource = 0;
+    motorRejected = 0;
+    
+    // Not-Aus
+    stopHandler = nullptr;
+    emergencyStopped = false;
+    lastStopId = 0;
+    memset(lastStopMac, 0, sizeof(lastStopMac));
+    lastStopUs = 0;
+    memset(&stopStats, 0, sizeof(stopStats));
+    stopTxId = 0;
+    memset(stopTxMac, 0xFF, sizeof(stopTxMac));
+    stopRepeatsLeft = 0;
+    stopTxUs = 0;
+    stopNextUs = 0;
+    
+    // Frame-Taps
+    for (int i = 0; i < ESPNOW_MAX_FRAME_TAPS; i++) {
+        frameTaps[i] = nullptr;
+    }
+    
+    // Abonnements
+    for (int i = 0; i < ESPNOW_MAX_SUBSCRIPTIONS; i++) {
+        subscriptions[i].active = false;
+        subscriptions[i].generation = 0;
+    }
+    subscriptionCount = 0;
+    subscriptionsDropped = 0;
+    subsMutex = nullptr;
+    
+    // Event-Bus
+    for (int i = 0; i < ESPNOW_EVENT_MAX_HANDLERS; i++) {
+        eventSlots[i].active = false;
+        eventSlots[i].generation = 0;
+    }
+    eventMask[0] = eventMask[1] = 0;
+    eventMutex = xSemaphoreCreateRecursiveMutex();  // Vor begin(): Abonnieren schon in setup()
+    eventQueue = nullptr;
+    eventsDropped = 0;
 }
 
 EspNowManager::~EspNowManager() {
@@ -346,17 +915,25 @@ bool EspNowManager::begin(uint8_t channel) {
     
     // Mutex für Peer-Liste
     peersMutex = xSemaphoreCreateMutex();
-    if (!peersMutex) {
+    stateMutex = xSemaphoreCreateMutex();
+    subsMutex = xSemaphoreCreateRecursiveMutex();
+    if (!peersMutex || !stateMutex || !subsMutex) {
         DEBUG_PRINTLN("EspNowManager: ❌ Mutex erstellen fehlgeschlagen!");
         return false;
     }
     
     // Queues erstellen
     rxQueue = xQueueCreate(ESPNOW_RX_QUEUE_SIZE, sizeof(RxQueueItem));
-    txQueue = xQueueCreate(ESPNOW_TX_QUEUE_SIZE, sizeof(TxQueueItem));
     resultQueue = xQueueCreate(ESPNOW_RESULT_QUEUE_SIZE, sizeof(ResultQueueItem));
+    eventQueue = xQueueCreate(ESPNOW_EVENT_QUEUE_SIZE, sizeof(EspNowEventData));
+    
+    bool txOk = true;
+    for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+        txQueues[i] = xQueueCreate(ESPNOW_TX_QUEUE_SIZE, sizeof(TxQueueItem));
+        txOk = txOk && txQueues[i];
+    }
     
-    if (!rxQueue || !txQueue || !resultQueue) {
+    if (!rxQueue || !txOk || !resultQueue || !eventQueue) {
         DEBUG_PRINTLN("EspNowManager: ❌ Queue erstellen fehlgeschlagen!");
         end();
         return false;
@@ -383,10 +960,22 @@ bool EspNowManager::begin(uint8_t channel) {
         return false;
     }
 
+    // Not-Aus-Kennung pro Boot variieren (Empfänger dedupliziert nach ID)
+    stopTxId = static_cast<uint16_t>(esp_timer_get_time());
+    
     // Callbacks registrieren
     esp_now_register_recv_cb(onDataRecvStatic);
     esp_now_register_send_cb(onDataSentStatic);
 
+    // Broadcast-Peer dauerhaft registrieren (Discovery, broadcast())
+    esp_now_peer_info_t bcastInfo = {};
+    memset(bcastInfo.peer_addr, 0xFF, 6);
+    bcastInfo.channel = wifiChannel;
+    bcastInfo.encrypt = false;
+    if (esp_now_add_peer(&bcastInfo) != ESP_OK) {
+        DEBUG_PRINTLN("EspNowManager: ⚠️ Broadcast-Peer nicht registriert");
+    }
+
     // ═══════════════════════════════════════════════════════════════════════
     // Worker-Task starten
     // ═══════════════════════════════════════════════════════════════════════
@@ -448,20 +1037,46 @@ void EspNowManager::end() {
         vQueueDelete(rxQueue);
         rxQueue = nullptr;
     }
-    if (txQueue) {
-        vQueueDelete(txQueue);
-        txQueue = nullptr;
+    for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+        if (txQueues[i]) {
+            vQueueDelete(txQueues[i]);
+            txQueues[i] = nullptr;
+        }
+        for (int h = 0; h < txHeldCount[i]; h++) {
+            releaseTxBuffer(txHeld[i][h].buffer);
+        }
+        txHeldCount[i] = 0;
     }
     if (resultQueue) {
         vQueueDelete(resultQueue);
         resultQueue = nullptr;
     }
+    if (eventQueue) {
+        vQueueDelete(eventQueue);
+        eventQueue = nullptr;
+    }
+    
+    // Deskriptoren sind mit den Queues verworfen → Pool freigeben
+    for (int i = 0; i < ESPNOW_TX_POOL_SIZE; i++) {
+        txPool[i].refs.store(0);
+    }
+    for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+        txLaneBuffers[i].store(0);
+    }
     
     // Mutex löschen
     if (peersMutex) {
         vSemaphoreDelete(peersMutex);
         peersMutex = nullptr;
     }
+    if (stateMutex) {
+        vSemaphoreDelete(stateMutex);
+        stateMutex = nullptr;
+    }
+    if (subsMutex) {
+        vSemaphoreDelete(subsMutex);
+        subsMutex = nullptr;
+    }
     
     initialized = false;
     DEBUG_PRINTLN("EspNowManager: ✅ ESP-NOW beendet");
@@ -486,34 +1101,19 @@ bool EspNowManager::addPeer(const uint8_t* mac, bool encrypt) {
         DEBUG_PRINTF("EspNowManager: Peer %s existiert bereits\n", macToString(mac).c_str());
         result = true;
     }
-    else if (peers.size() >= ESPNOW_MAX_PEERS) {
+    else if (ESPNOW_MAX_PEERS > 0 && peers.size() >= (size_t)ESPNOW_MAX_PEERS) {
         DEBUG_PRINTLN("EspNowManager: ❌ Maximale Peer-Anzahl erreicht!");
     }
     else {
-        esp_now_peer_info_t peerInfo = {};
-        memcpy(peerInfo.peer_addr, mac, 6);
-        peerInfo.channel = wifiChannel;
-        peerInfo.encrypt = encrypt;
-
-        esp_err_t espResult = esp_now_add_peer(&peerInfo);
-        if (espResult != ESP_OK) {
-            DEBUG_PRINTF("EspNowManager: ❌ esp_now_add_peer() fehlgeschlagen: %d\n", espResult);
-        }
-        else {
-            EspNowPeer newPeer;
-            memcpy(newPeer.mac, mac, 6);
-            newPeer.connected = false;
-            newPeer.lastSeen = 0;
-            newPeer.packetsReceived = 0;
-            newPeer.packetsSent = 0;
-            newPeer.packetsLost = 0;
-            newPeer.rssi = 0;
-
-            peers.push_back(newPeer);
-            result = true;
+        // Logisch hinzufügen, Treiber-Slot nur belegen wenn frei (kein Swap)
+        EspNowPeer newPeer = makePeer(mac, encrypt);
+        registerPeer(newPeer, false);
 
-            DEBUG_PRINTF("EspNowManager: ✅ Peer hinzugefügt: %s\n", macToString(mac).c_str());
-        }
+        peers.push_back(newPeer);
+        result = true;
+
+        DEBUG_PRINTF("EspNowManager: ✅ Peer hinzugefügt: %s (%s)\n", macToString(mac).c_str(),
+                     newPeer.registered ? "registriert" : "virtuell");
     }
 
     xSemaphoreGive(peersMutex);
@@ -539,7 +1139,7 @@ bool EspNowManager::removePeer(const uint8_t* mac) {
     bool result = false;
     
     if (index >= 0) {
-        esp_now_del_peer(mac);
+        releasePeer(peers[index]);
         peers.erase(peers.begin() + index);
         result = true;
         DEBUG_PRINTF("EspNowManager: ✅ Peer entfernt: %s\n", macToString(mac).c_str());
@@ -563,7 +1163,7 @@ void EspNowManager::removeAllPeers() {
     }
     
     while (!peers.empty()) {
-        esp_now_del_peer(peers[0].mac);
+        releasePeer(peers[0]);
         peers.erase(peers.begin());
     }
     
@@ -616,81 +1216,1484 @@ bool EspNowManager::isPeerConnected(const uint8_t* mac) {
     return result;
 }
 
-// ═══════════════════════════════════════════════════════════════════════════
-// DATEN SENDEN (via TX-Queue)
-// ═══════════════════════════════════════════════════════════════════════════
+void EspNowManager::setAutoDiscovery(bool enabled) {
+    autoDiscovery = enabled;
+    DEBUG_PRINTF("EspNowManager: Auto-Discovery %s\n", enabled ? "AN" : "AUS");
+}
 
-bool EspNowManager::send(const uint8_t* mac, const EspNowPacket& packet) {
-    if (!initialized || !txQueue) {
-        DEBUG_PRINTLN("EspNowManager: ❌ Nicht initialisiert!");
-        return false;
-    }
+bool EspNowManager::sendDiscovery() {
+    EspNowPacket req;
+    req.begin(MainCmd::PAIR_REQUEST);
+    return broadcast(req, ESPNOW_GROUP_ALL, EspNowLane::CONTROL);
+}
 
-    if (!packet.isValid()) {
-        DEBUG_PRINTLN("EspNowManager: ❌ Ungültiges Paket!");
-        return false;
+void EspNowManager::getSwapStats(EspNowSwapStats* stats) {
+    if (!stats) return;
+    
+    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+        memset(stats, 0, sizeof(EspNowSwapStats));
+        return;
     }
+    *stats = swapStats;
+    stats->registeredPeers = hwPeerCount;
+    stats->registeredEncrypted = hwEncryptCount;
+    xSemaphoreGive(peersMutex);
+}
 
-    TxQueueItem item;
-    
-    if (mac) {
-        memcpy(item.mac, mac, 6);
-        item.broadcast = false;
-    } else {
-        memset(item.mac, 0xFF, 6);  // Broadcast-MAC
-        item.broadcast = true;
+// ─────────────────────────────────────────────────────────────────────────────
+// VIRTUELLE PEERS (Treiber-Tabelle, LRU)
+// ─────────────────────────────────────────────────────────────────────────────
+
+EspNowPeer EspNowManager::makePeer(const uint8_t* mac, bool encrypt) {
+    EspNowPeer peer;
+    memcpy(peer.mac, mac, 6);
+    peer.connected = false;
+    peer.lastSeen = 0;
+    peer.packetsReceived = 0;
+    peer.packetsSent = 0;
+    peer.packetsLost = 0;
+    peer.rssi = 0;
+    peer.rssiAvg = 0.0f;
+    peer.rssiMin = 0;
+    peer.rssiMax = 0;
+    peer.lossAvg = 0.0f;
+    peer.rxLost = 0;
+    peer.txSeq = 0;
+    peer.rxSeq = 0;
+    peer.rxSeqValid = false;
+    peer.fec = nullptr;
+    peer.codec = nullptr;
+    peer.txCodec = nullptr;
+    peer.jitter = nullptr;
+    for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+        peer.buckets[i].tokens = laneConfig[i].burst;
+        peer.buckets[i].lastUs = micros();
+    }
+    peer.encrypt = encrypt;
+    peer.registered = false;
+    peer.lastUsed = ++lruClock;
+    return peer;
+}
+
+bool EspNowManager::registerPeer(EspNowPeer& peer, bool allowEvict) {
+    peer.lastUsed = ++lruClock;
+    if (peer.registered) return true;
+
+    unsigned long startUs = micros();
+    
+    // Broadcast-Peer belegt einen Slot dauerhaft
+    const uint8_t unicastSlots = ESPNOW_HW_PEER_SLOTS - 1;
+    
+    // Slot freimachen (verschlüsselte Peers haben eigenes Limit)
+    bool needEvict = hwPeerCount >= unicastSlots ||
+                     (peer.encrypt && hwEncryptCount >= ESPNOW_HW_ENCRYPT_SLOTS);
+    if (needEvict) {
+        if (!allowEvict) return false;
+        
+        bool evictEncrypted = peer.encrypt && hwEncryptCount >= ESPNOW_HW_ENCRYPT_SLOTS;
+        int victim = findLruVictim(evictEncrypted, peer.mac);
+        if (victim < 0) {
+            swapStats.failures++;
+            return false;
+        }
+        unregisterPeer(peers[victim]);
+        swapStats.evictions++;
     }
-    
-    memcpy(item.data, packet.getRawData(), packet.getTotalLength());
-    item.length = packet.getTotalLength();
 
-    // In Queue einreihen (non-blocking)
-    if (xQueueSend(txQueue, &item, 0) != pdTRUE) {
-        DEBUG_PRINTLN("EspNowManager: ⚠️ TX-Queue voll!");
+    esp_now_peer_info_t peerInfo = {};
+    memcpy(peerInfo.peer_addr, peer.mac, 6);
+    peerInfo.channel = wifiChannel;
+    peerInfo.encrypt = peer.encrypt;
+
+    esp_err_t espResult = esp_now_add_peer(&peerInfo);
+    if (espResult != ESP_OK && espResult != ESP_ERR_ESPNOW_EXIST) {
+        DEBUG_PRINTF("EspNowManager: ❌ esp_now_add_peer() fehlgeschlagen: %d\n", espResult);
+        swapStats.failures++;
         return false;
     }
-
+    
+    peer.registered = true;
+    hwPeerCount++;
+    if (peer.encrypt) hwEncryptCount++;
+    
+    // Nur Nachladen beim Senden zählt als Swap (nicht addPeer())
+    if (allowEvict) {
+        uint32_t swapUs = micros() - startUs;
+        swapStats.swapIns++;
+        swapStats.totalSwapUs += swapUs;
+        if (swapUs > swapStats.maxSwapUs) swapStats.maxSwapUs = swapUs;
+    }
+    
     return true;
 }
 
-bool EspNowManager::broadcast(const EspNowPacket& packet) {
-    return send(nullptr, packet);
+void EspNowManager::releasePeer(EspNowPeer& peer) {
+    unregisterPeer(peer);
+    delete peer.fec;
+    peer.fec = nullptr;
+    delete peer.codec;
+    peer.codec = nullptr;
+    delete peer.txCodec;
+    peer.txCodec = nullptr;
+    delete peer.jitter;
+    peer.jitter = nullptr;
 }
 
-void EspNowManager::sendHeartbeat() {
-    EspNowPacket hb;
-    hb.begin(MainCmd::HEARTBEAT);
+void EspNowManager::unregisterPeer(EspNowPeer& peer) {
+    if (!peer.registered) return;
     
-    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-        for (auto& peer : peers) {
-            send(peer.mac, hb);
+    esp_now_del_peer(peer.mac);
+    peer.registered = false;
+    if (hwPeerCount > 0) hwPeerCount--;
+    if (peer.encrypt && hwEncryptCount > 0) hwEncryptCount--;
+}
+
+int EspNowManager::findLruVictim(bool encrypted, const uint8_t* excludeMac) {
+    int victim = -1;
+    uint32_t oldest = UINT32_MAX;
+    
+    for (size_t i = 0; i < peers.size(); i++) {
+        const EspNowPeer& p = peers[i];
+        if (!p.registered || compareMac(p.mac, excludeMac)) continue;
+        if (encrypted && !p.encrypt) continue;
+        
+        if (p.lastUsed < oldest) {
+            oldest = p.lastUsed;
+            victim = i;
         }
-        xSemaphoreGive(peersMutex);
     }
+    return victim;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// HEARTBEAT & TIMEOUT
+// LINK-QUALITÄT
 // ═══════════════════════════════════════════════════════════════════════════
 
-void EspNowManager::setHeartbeat(bool enabled, uint32_t intervalMs) {
-    heartbeatEnabled = enabled;
-    heartbeatInterval = intervalMs;
-    DEBUG_PRINTF("EspNowManager: Heartbeat %s (%dms)\n", enabled ? "AN" : "AUS", intervalMs);
+bool EspNowManager::getLinkQuality(const uint8_t* mac, EspNowLinkQuality* out) {
+    if (!mac || !out) return false;
+    
+    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+        return false;
+    }
+    
+    int index = findPeerIndex(mac);
+    if (index >= 0) {
+        const EspNowPeer& peer = peers[index];
+        out->rssi = peer.rssi;
+        out->rssiAvg = static_cast<int8_t>(lroundf(peer.rssiAvg));
+        out->rssiMin = peer.rssiMin;
+        out->rssiMax = peer.rssiMax;
+        out->lossRate = peer.lossAvg;
+        out->packetsReceived = peer.packetsReceived;
+        out->packetsSent = peer.packetsSent;
+        out->packetsLost = peer.packetsLost + peer.rxLost;
+        out->quality = calcLinkQuality(peer);
+        out->lastSeen = peer.lastSeen;
+    }
+    
+    xSemaphoreGive(peersMutex);
+    return index >= 0;
 }
 
-void EspNowManager::setTimeout(uint32_t timeout) {
-    timeoutMs = timeout;
-    DEBUG_PRINTF("EspNowManager: Timeout: %dms\n", timeout);
+bool EspNowManager::addLinkTelemetry(EspNowPacket& packet, const uint8_t* mac) {
+    EspNowLinkQuality link;
+    if (!getLinkQuality(mac, &link) || link.packetsReceived == 0) {
+        return false;
+    }
+    packet.addInt8(DataCmd::RSSI, link.rssiAvg);
+    return true;
 }
 
-void EspNowManager::checkTimeouts() {
-    unsigned long now = millis();
+void EspNowManager::updateLinkStats(EspNowPeer& peer, int8_t rssi, const EspNowPacket& packet) {
+    // RSSI: letzter Wert, EWMA, Min/Max
+    peer.rssi = rssi;
+    if (peer.packetsReceived <= 1) {
+        peer.rssiAvg = rssi;
+        peer.rssiMin = rssi;
+        peer.rssiMax = rssi;
+    } else {
+        peer.rssiAvg += ESPNOW_LINK_EWMA_ALPHA * (rssi - peer.rssiAvg);
+        if (rssi < peer.rssiMin) peer.rssiMin = rssi;
+        if (rssi > peer.rssiMax) peer.rssiMax = rssi;
+    }
+    
+    // Verlust über Sequenzlücken (nur Unicast trägt SEQUENCE)
+    uint16_t seq;
+    if (!packet.getUInt16(DataCmd::SEQUENCE, seq)) return;
+    
+    if (peer.rxSeqValid) {
+        uint16_t gap = seq - peer.rxSeq - 1;
+        if (gap >= 0x8000) {
+            return;  // Duplikat oder veraltet (Reorder)
+        }
+        peer.rxLost += gap;
+        
+        // Ein Sample pro erwartetem Slot: gap Verluste (1.0), dann dieser Frame (0.0)
+        // Geschlossene Form der gap-fachen EWMA, damit große Lücken O(1) bleiben
+        float keep = powf(1.0f - ESPNOW_LINK_EWMA_ALPHA, static_cast<float>(gap));
+        peer.lossAvg = 1.0f - keep * (1.0f - peer.lossAvg);
+        peer.lossAvg *= 1.0f - ESPNOW_LINK_EWMA_ALPHA;
+    }
+    peer.rxSeq = seq;
+    peer.rxSeqValid = true;
+}
 
-    for (auto& peer : peers) {
-        if (peer.connected) {
-            if (peer.lastSeen > 0 && (now - peer.lastSeen) > timeoutMs) {
-                peer.connected = false;
+uint8_t EspNowManager::calcLinkQuality(const EspNowPeer& peer) {
+    if (peer.packetsReceived == 0) return 0;
+    
+    // RSSI linear auf 0..1 abbilden, mit Zustellrate gewichten
+    float rssiScore = (peer.rssiAvg - ESPNOW_RSSI_FLOOR) / float(ESPNOW_RSSI_CEIL - ESPNOW_RSSI_FLOOR);
+    rssiScore = constrain(rssiScore, 0.0f, 1.0f);
+    
+    return static_cast<uint8_t>(lroundf(rssiScore * (1.0f - peer.lossAvg) * 100.0f));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FEC (XOR-Parity)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void EspNowManager::setFec(bool enabled, uint8_t k) {
+    fecK = constrain<uint8_t>(k, 2, ESPNOW_FEC_MAX_K);
+    fecEnabled = enabled;
+    DEBUG_PRINTF("EspNowManager: FEC %s (k=%d)\n", enabled ? "AN" : "AUS", fecK);
+}
+
+void EspNowManager::getFecStats(EspNowFecStats* stats) {
+    if (!stats) return;
+    
+    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+        memset(stats, 0, sizeof(EspNowFecStats));
+        return;
+    }
+    *stats = fecStats;
+    xSemaphoreGive(peersMutex);
+}
+
+bool EspNowManager::fecProtect(EspNowPeer& peer, uint8_t* frame, size_t& len, EspNowPacket& parityOut) {
+    if (!peer.fec) {
+        peer.fec = new EspNowFecState();
+        memset(peer.fec, 0, sizeof(EspNowFecState));
+    }
+    EspNowFecState& fec = *peer.fec;
+    
+    // FEC_INFO einfügen; zu große Frames laufen ungeschützt durch
+    EspNowFecInfo info = { fec.txGroup, fec.txIndex, fecK, 0 };
+    if (len + 2 + sizeof(info) > ESPNOW_FEC_MAX_FRAME ||
+        !insertEntry(frame, len, DataCmd::FEC_INFO, &info, sizeof(info))) {
+        return false;
+    }
+    
+    if (fec.txIndex == 0) {
+        memset(fec.txParity, 0, sizeof(fec.txParity));
+        fec.txMaxLen = 0;
+        fec.txLenXor = 0;
+        fec.txFirstMs = millis();
+    }
+    
+    for (size_t i = 0; i < len; i++) {
+        fec.txParity[i] ^= frame[i];
+    }
+    if (len > fec.txMaxLen) fec.txMaxLen = len;
+    fec.txLenXor ^= static_cast<uint8_t>(len);
+    fec.txIndex++;
+    fecStats.protectedSent++;
+    
+    // Gruppe voll → Parity-Frame bauen
+    if (fec.txIndex >= fecK) {
+        fecBuildParity(fec, parityOut);
+        return true;
+    }
+    return false;
+}
+
+void EspNowManager::fecBuildParity(EspNowFecState& fec, EspNowPacket& parityOut) {
+    EspNowFecInfo info = { fec.txGroup, fec.txIndex, fec.txIndex, fec.txLenXor };
+    
+    parityOut.begin(MainCmd::FEC_PARITY)
+             .addStruct(DataCmd::FEC_INFO, info)
+             .add(DataCmd::FEC_DATA, fec.txParity, fec.txMaxLen);
+    
+    fec.txGroup++;
+    fec.txIndex = 0;
+    fecStats.paritySent++;
+}
+
+bool EspNowManager::fecReceive(EspNowPeer& peer, const EspNowPacket& packet, const uint8_t* data, size_t len,
+                               uint8_t* recoveredOut, size_t& recoveredLen) {
+    const EspNowFecInfo* info = packet.get<EspNowFecInfo>(DataCmd::FEC_INFO);
+    if (!info || info->k == 0 || info->k > ESPNOW_FEC_MAX_K) return false;
+    
+    if (!peer.fec) {
+        peer.fec = new EspNowFecState();
+        memset(peer.fec, 0, sizeof(EspNowFecState));
+    }
+    EspNowFecState& fec = *peer.fec;
+    
+    // Neue Gruppe → Akkumulator zurücksetzen
+    if (!fec.rxValid || fec.rxGroup != info->group) {
+        fec.rxValid = true;
+        fec.rxGroup = info->group;
+        fec.rxMask = 0;
+        fec.rxLenXor = 0;
+        memset(fec.rxParity, 0, sizeof(fec.rxParity));
+    }
+    
+    // Daten-Frame: in XOR-Akkumulator aufnehmen
+    if (packet.getMainCmd() != MainCmd::FEC_PARITY) {
+        uint32_t bit = 1UL << info->index;
+        if (info->index >= info->k || (fec.rxMask & bit) || len > ESPNOW_FEC_MAX_FRAME) return false;
+        
+        fec.rxMask |= bit;
+        fec.rxLenXor ^= static_cast<uint8_t>(len);
+        for (size_t i = 0; i < len; i++) {
+            fec.rxParity[i] ^= data[i];
+        }
+        return false;
+    }
+    
+    // Parity-Frame: genau ein fehlender Frame ist rekonstruierbar
+    uint32_t fullMask = (info->k >= 32) ? 0xFFFFFFFFUL : ((1UL << info->k) - 1);
+    uint32_t missing = fullMask & ~fec.rxMask;
+    fec.rxValid = false;
+    
+    if (missing == 0) return false;
+    if (missing & (missing - 1)) {
+        fecStats.unrecoverable++;
+        return false;
+    }
+    
+    size_t parityLen;
+    const uint8_t* parity = packet.getData(DataCmd::FEC_DATA, &parityLen);
+    recoveredLen = info->lenXor ^ fec.rxLenXor;
+    if (!parity || recoveredLen < 2 || recoveredLen > parityLen) {
+        fecStats.unrecoverable++;
+        return false;
+    }
+    
+    for (size_t i = 0; i < recoveredLen; i++) {
+        recoveredOut[i] = parity[i] ^ fec.rxParity[i];
+    }
+    fecStats.recovered++;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// REPLIZIERTER ZUSTAND
+// ═══════════════════════════════════════════════════════════════════════════
+
+void EspNowManager::setStateSync(bool enabled, const uint8_t* mac, uint32_t keyframeMs, EspNowLane lane) {
+    stateBroadcast = (mac == nullptr);
+    if (mac) memcpy(stateTarget, mac, 6);
+    stateKeyframeMs = keyframeMs > 0 ? keyframeMs : ESPNOW_STATE_KEYFRAME_MS;
+    stateLane = lane;
+    lastKeyframeSent = 0;       // Ersten Zustand sofort als Keyframe senden
+    stateSyncEnabled = enabled;
+    
+    DEBUG_PRINTF("EspNowManager: Zustands-Sync %s (Keyframe alle %lu ms)\n",
+                 enabled ? "aktiviert" : "deaktiviert", stateKeyframeMs);
+}
+
+bool EspNowManager::setState(DataCmd cmd, const void* data, size_t len) {
+    if (!data || len == 0 || len > ESPNOW_STATE_MAX_VALUE || !stateMutex) return false;
+    
+    if (xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) return false;
+    
+    EspNowStateEntry* entry = nullptr;
+    for (int i = 0; i < localStateCount; i++) {
+        if (localState[i].cmd == cmd) {
+            entry = &localState[i];
+            break;
+        }
+    }
+    
+    bool ok = true;
+    if (!entry) {
+        if (localStateCount < ESPNOW_STATE_MAX_ENTRIES) {
+            entry = &localState[localStateCount++];
+            entry->cmd = cmd;
+            entry->len = 0;
+        } else {
+            ok = false;
+        }
+    }
+    
+    if (entry) {
+        if (entry->len == len && memcmp(entry->value, data, len) == 0) {
+            stateStats.unchanged++;
+        } else {
+            memcpy(entry->value, data, len);
+            entry->len = len;
+            entry->dirty = true;
+        }
+    }
+    
+    xSemaphoreGive(stateMutex);
+    return ok;
+}
+
+bool EspNowManager::getStateSnapshot(EspNowStateSnapshot* out, const uint8_t* mac) {
+    if (!out || !stateMutex) return false;
+    
+    if (xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) return false;
+    EspNowStateSnapshot* state = findStateSource(mac ? mac : stateLastMac, false);
+    if (state) {
+        *out = *state;
+    } else {
+        memset(out, 0, sizeof(EspNowStateSnapshot));
+    }
+    xSemaphoreGive(stateMutex);
+    
+    return out->version > 0;
+}
+
+void EspNowManager::getStateStats(EspNowStateStats* stats) {
+    if (stats) *stats = stateStats;
+}
+
+void EspNowManager::flushState(unsigned long now) {
+    if (!stateSyncEnabled || !stateMutex) return;
+    
+    bool keyframe = (lastKeyframeSent == 0 || (now - lastKeyframeSent) >= stateKeyframeMs);
+    
+    EspNowPacket packet;
+    packet.begin(keyframe ? MainCmd::STATE_KEYFRAME : MainCmd::STATE_DELTA);
+    int entries = 0;
+    
+    if (xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) return;
+    for (int i = 0; i < localStateCount; i++) {
+        EspNowStateEntry& entry = localState[i];
+        if (keyframe || entry.dirty) {
+            packet.add(entry.cmd, entry.value, entry.len);
+            entries++;
+        }
+    }
+    xSemaphoreGive(stateMutex);
+    
+    // Nichts geändert → kein Frame
+    if (entries == 0 && !keyframe) return;
+    
+    // Bei Fehler bleiben die Einträge dirty → nächster Versuch in update()
+    bool ok = stateBroadcast ? broadcast(packet, ESPNOW_GROUP_ALL, stateLane)
+                             : send(stateTarget, packet, stateLane);
+    if (!ok) return;
+    
+    // Nur Einträge zurücksetzen, deren gesendeter Wert noch aktuell ist
+    // (setState() kann zwischendurch einen neueren Wert eingetragen haben)
+    if (xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        for (int i = 0; i < localStateCount; i++) {
+            EspNowStateEntry& entry = localState[i];
+            size_t sentLen;
+            const uint8_t* sent = packet.getData(entry.cmd, &sentLen);
+            if (entry.dirty && sent && sentLen == entry.len && memcmp(sent, entry.value, sentLen) == 0) {
+                entry.dirty = false;
+            }
+        }
+        xSemaphoreGive(stateMutex);
+    }
+    
+    if (keyframe) {
+        stateStats.keyframesSent++;
+        lastKeyframeSent = now;
+    } else {
+        stateStats.deltasSent++;
+    }
+    stateStats.entriesSent += entries;
+}
+
+EspNowStateSnapshot* EspNowManager::findStateSource(const uint8_t* mac, bool create) {
+    EspNowStateSnapshot* oldest = &remoteStates[0];
+    for (auto& state : remoteStates) {
+        if (state.version > 0 && memcmp(state.mac, mac, 6) == 0) {
+            return &state;
+        }
+        // Freie Tabelle bevorzugen, sonst die am längsten nicht aktualisierte
+        if (oldest->version > 0 &&
+            (state.version == 0 || (long)(state.lastUpdateMs - oldest->lastUpdateMs) < 0)) {
+            oldest = &state;
+        }
+    }
+    if (!create) return nullptr;
+    
+    memset(oldest, 0, sizeof(EspNowStateSnapshot));
+    memcpy(oldest->mac, mac, 6);
+    return oldest;
+}
+
+void EspNowManager::applyState(const uint8_t* mac, const EspNowPacket& packet, bool keyframe) {
+    if (!stateMutex || xSemaphoreTake(stateMutex, pdMS_TO_TICKS(10)) != pdTRUE) return;
+    
+    // Eigene Tabelle pro Absender (mehrere Sender überschreiben sich nicht)
+    EspNowStateSnapshot& state = *findStateSource(mac, true);
+    
+    // Verspätet (Reorder, FEC-Rekonstruktion): nur Einträge übernehmen,
+    // die seitdem nicht von einem neueren Frame gesetzt wurden
+    uint16_t seq = 0;
+    bool hasSeq = packet.getUInt16(DataCmd::SEQUENCE, seq);
+    bool stale = hasSeq && state.seqValid && static_cast<int16_t>(seq - state.seq) <= 0;
+    
+    // Keyframe ersetzt die Tabelle (entfernte Einträge verschwinden)
+    if (keyframe && !stale) {
+        state.count = 0;
+    }
+    int applied = 0;
+    
+    // Einträge des Frames übernehmen (Transport-Einträge überspringen)
+    const uint8_t* raw = packet.getRawData();
+    size_t pos = 2;
+    size_t end = packet.getTotalLength();
+    while (pos + 2 <= end) {
+        DataCmd cmd = static_cast<DataCmd>(raw[pos]);
+        uint8_t len = raw[pos + 1];
+        const uint8_t* value = &raw[pos + 2];
+        pos += 2 + len;
+        if (pos > end) break;
+        
+        uint8_t cmdVal = static_cast<uint8_t>(cmd);
+        if ((cmdVal >= 0x60 && cmdVal <= 0x6F) || len == 0 || len > ESPNOW_STATE_MAX_VALUE) continue;
+        
+        EspNowStateEntry* entry = nullptr;
+        for (int i = 0; i < state.count; i++) {
+            if (state.entries[i].cmd == cmd) {
+                entry = &state.entries[i];
+                break;
+            }
+        }
+        if (!entry) {
+            if (state.count >= ESPNOW_STATE_MAX_ENTRIES) continue;
+            entry = &state.entries[state.count++];
+            entry->cmd = cmd;
+            entry->dirty = false;
+        } else if (stale && static_cast<int16_t>(seq - entry->seq) <= 0) {
+            continue;
+        }
+        memcpy(entry->value, value, len);
+        entry->len = len;
+        entry->seq = seq;
+        applied++;
+    }
+    
+    if (stale) {
+        stateStats.staleReceived++;
+        if (applied == 0) {
+            xSemaphoreGive(stateMutex);
+            return;
+        }
+    } else {
+        state.seq = seq;
+        state.seqValid = hasSeq;
+    }
+    
+    unsigned long now = millis();
+    state.lastUpdateMs = now;
+    if (keyframe) {
+        state.lastKeyframeMs = now;
+        stateStats.keyframesReceived++;
+    } else {
+        stateStats.deltasReceived++;
+    }
+    state.version++;
+    stateVersion++;
+    memcpy(stateLastMac, mac, 6);
+    
+    xSemaphoreGive(stateMutex);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMU-BATCHES (Empfang)
+// ═══════════════════════════════════════════════════════════════════════════
+
+EspNowImuRing* EspNowManager::imuRing(DataCmd type) {
+    if (type == DataCmd::ACCEL_BATCH) return &accelRing;
+    if (type == DataCmd::GYRO_BATCH) return &gyroRing;
+    return nullptr;
+}
+
+int EspNowManager::readImuSamples(DataCmd type, EspNowImuSample* out, int maxCount, uint8_t* mac) {
+    EspNowImuRing* ring = imuRing(type);
+    if (!ring || !out) return 0;
+    
+    // Nur Samples eines Absenders (Zeitstempel verschiedener Sender nicht vergleichbar)
+    uint8_t source[6];
+    int count = 0;
+    while (count < maxCount) {
+        const uint8_t* next = ring->peekMac();
+        if (!next || (count > 0 && memcmp(next, source, 6) != 0)) break;
+        ring->pop(out[count], source);
+        count++;
+    }
+    
+    if (mac && count > 0) memcpy(mac, source, 6);
+    return count;
+}
+
+int EspNowManager::getImuAvailable(DataCmd type) {
+    EspNowImuRing* ring = imuRing(type);
+    return ring ? ring->available() : 0;
+}
+
+uint32_t EspNowManager::getImuDropped(DataCmd type) {
+    EspNowImuRing* ring = imuRing(type);
+    return ring ? ring->getDropped() : 0;
+}
+
+void EspNowManager::unpackImuBatches(const uint8_t* mac, const EspNowPacket& packet) {
+    const DataCmd types[] = { DataCmd::ACCEL_BATCH, DataCmd::GYRO_BATCH };
+    EspNowImuSample samples[ESPNOW_IMU_BATCH_MAX];
+    
+    for (DataCmd type : types) {
+        size_t len;
+        const uint8_t* data = packet.getData(type, &len);
+        if (!data) continue;
+        
+        EspNowImuRing* ring = imuRing(type);
+        int n = EspNowImuBatcher::decode(data, len, samples, ESPNOW_IMU_BATCH_MAX);
+        for (int i = 0; i < n; i++) {
+            ring->push(mac, samples[i]);
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JITTER-BUFFER (Motor-Befehle)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void EspNowManager::setJitterBuffer(bool enabled, uint16_t periodMs) {
+    jitterPeriodUs = (periodMs > 0 ? periodMs : ESPNOW_JITTER_PERIOD_MS) * 1000UL;
+    jitterEnabled = enabled;
+    DEBUG_PRINTF("EspNowManager: Jitter-Buffer %s (%d ms)\n",
+                 enabled ? "aktiviert" : "deaktiviert", periodMs);
+}
+
+void EspNowManager::setPlayoutCallback(EspNowPlayoutCallback callback) {
+    playoutCallback = callback;
+}
+
+namespace {
+
+// Motor-Quelle: MAC in Bit 0-47, Bit 48 = festgelegt (0 = ersten Absender übernehmen)
+const uint64_t MOTOR_SOURCE_SET = 1ULL << 48;
+const uint64_t MOTOR_SOURCE_ANY = MOTOR_SOURCE_SET | 0xFFFFFFFFFFFFULL;    // Broadcast-MAC
+
+uint64_t motorSourceKey(const uint8_t* mac) {
+    uint64_t key = MOTOR_SOURCE_SET;
+    for (int i = 0; i < 6; i++) {
+        key |= static_cast<uint64_t>(mac[i]) << (8 * i);
+    }
+    return key;
+}
+
+}  // namespace
+
+void EspNowManager::setMotorSource(const uint8_t* mac) {
+    motorSource.store(mac ? motorSourceKey(mac) : 0);
+    DEBUG_PRINTF("EspNowManager: Motor-Quelle %s\n", mac ? macToString(mac).c_str() : "erster Absender");
+}
+
+bool EspNowManager::getMotorSource(uint8_t* mac) {
+    uint64_t key = motorSource.load();
+    if (!key) return false;
+    if (mac) {
+        for (int i = 0; i < 6; i++) {
+            mac[i] = static_cast<uint8_t>(key >> (8 * i));
+        }
+    }
+    return true;
+}
+
+uint32_t EspNowManager::getMotorRejected() {
+    return motorRejected;
+}
+
+bool EspNowManager::acceptMotorSource(const uint8_t* mac) {
+    uint64_t key = motorSourceKey(mac);
+    uint64_t expected = 0;
+    
+    // Noch keine Quelle → ersten Absender übernehmen
+    if (motorSource.compare_exchange_strong(expected, key) || expected == key ||
+        expected == MOTOR_SOURCE_ANY) {
+        return true;
+    }
+    motorRejected++;
+    return false;
+}
+
+bool EspNowManager::getMotorCommand(EspNowMotorCommand* out) {
+    if (!out) return false;
+    
+    // Seqlock: wiederholen bis ohne gleichzeitiges Schreiben gelesen
+    uint32_t before, after;
+    do {
+        before = motorSeqlock.load(std::memory_order_acquire);
+        memcpy(out, &motorCommand, sizeof(EspNowMotorCommand));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = motorSeqlock.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    
+    return before > 0;
+}
+
+void EspNowManager::storeMotorCommand(const EspNowMotorCommand& command) {
+    motorSeqlock.fetch_add(1, std::memory_order_acq_rel);
+    memcpy(&motorCommand, &command, sizeof(EspNowMotorCommand));
+    motorSeqlock.fetch_add(1, std::memory_order_release);
+}
+
+void EspNowManager::publishMotorCommand(const EspNowMotorCommand& command) {
+    storeMotorCommand(command);
+    motorSeqValid = true;
+    
+    if (playoutCallback) {
+        playoutCallback(command);
+    }
+}
+
+bool EspNowManager::getJitterStats(const uint8_t* mac, EspNowJitterStats* out) {
+    if (!out || !peersMutex) return false;
+    
+    bool found = false;
+    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        int index = findPeerIndex(mac);
+        if (index >= 0 && peers[index].jitter) {
+            *out = peers[index].jitter->stats;
+            found = true;
+        }
+        xSemaphoreGive(peersMutex);
+    }
+    return found;
+}
+
+bool EspNowManager::jitterPush(EspNowPeer& peer, const EspNowPacket& packet, unsigned long nowUs) {
+    uint16_t seq;
+    if (!packet.getUInt16(DataCmd::SEQUENCE, seq)) return false;    // Broadcast: nicht sortierbar
+    
+    EspNowJitterSlot slot;
+    slot.seq = seq;
+    slot.arrivalUs = nowUs;
+    size_t allLen;
+    const uint8_t* all = packet.getData(DataCmd::MOTOR_ALL, &allLen);
+    bool both = all && allLen >= 4;
+    bool hasLeft = packet.getInt16(DataCmd::MOTOR_LEFT, slot.left);
+    bool hasRight = packet.getInt16(DataCmd::MOTOR_RIGHT, slot.right);
+    if (both) {
+        memcpy(&slot.left, all, 2);
+        memcpy(&slot.right, all + 2, 2);
+    } else if (!hasLeft && !hasRight) {
+        return false;
+    }
+    
+    if (!peer.jitter) {
+        peer.jitter = new EspNowJitterBuffer();
+        memset(peer.jitter, 0, sizeof(EspNowJitterBuffer));
+        peer.jitter->stats.delayUs = ESPNOW_JITTER_MIN_DELAY_MS * 1000UL;
+    }
+    EspNowJitterBuffer& jb = *peer.jitter;
+    
+    // Fehlende Achse vom letzten Wert übernehmen
+    if (!both && !hasLeft) slot.left = jb.count > 0 ? jb.slots[jb.count - 1].left : jb.left;
+    if (!both && !hasRight) slot.right = jb.count > 0 ? jb.slots[jb.count - 1].right : jb.right;
+    
+    // Jitter-Schätzung: Abweichung des Ankunftsabstands vom mittleren Sendeabstand
+    // (Senderate unbekannt → aus Ankünften pro Sequenzschritt geschätzt, Verluste
+    // zählen als mehrere Schritte, überholte Frames gehen nicht ein)
+    int16_t steps = (int16_t)(seq - jb.lastArrivalSeq);
+    if (!jb.hasArrival || steps > 0) {
+        if (jb.hasArrival) {
+            float elapsed = (float)(nowUs - jb.lastArrivalUs);
+            if (jb.intervalUs <= 0.0f) {
+                jb.intervalUs = elapsed / steps;
+            } else {
+                float d = fabsf(elapsed - jb.intervalUs * steps);
+                jb.jitterUs += (d - jb.jitterUs) / 16.0f;
+                jb.intervalUs += (elapsed / steps - jb.intervalUs) / 16.0f;
+            }
+        }
+        jb.lastArrivalUs = nowUs;
+        jb.lastArrivalSeq = seq;
+        jb.hasArrival = true;
+    }
+    
+    // Adaptive Verzögerung
+    float delay = ESPNOW_JITTER_FACTOR * jb.jitterUs;
+    delay = constrain(delay, ESPNOW_JITTER_MIN_DELAY_MS * 1000.0f, ESPNOW_JITTER_MAX_DELAY_MS * 1000.0f);
+    jb.stats.delayUs = (uint32_t)delay;
+    jb.stats.jitterUs = (uint32_t)jb.jitterUs;
+    
+    // Bereits ausgegeben oder überholt → zu spät
+    if (jb.started && (int16_t)(seq - jb.lastSeq) <= 0) {
+        jb.stats.late++;
+        return true;
+    }
+    
+    // Sortiert einfügen (Duplikate verwerfen)
+    int pos = jb.count;
+    while (pos > 0 && (int16_t)(jb.slots[pos - 1].seq - seq) > 0) pos--;
+    if (pos > 0 && jb.slots[pos - 1].seq == seq) {
+        jb.stats.late++;
+        return true;
+    }
+    
+    if (jb.count >= ESPNOW_JITTER_SLOTS) {
+        // Voll: ältesten Frame verwerfen
+        memmove(&jb.slots[0], &jb.slots[1], (jb.count - 1) * sizeof(EspNowJitterSlot));
+        jb.count--;
+        jb.stats.overflows++;
+        if (pos > 0) pos--;
+    }
+    
+    memmove(&jb.slots[pos + 1], &jb.slots[pos], (jb.count - pos) * sizeof(EspNowJitterSlot));
+    jb.slots[pos] = slot;
+    jb.count++;
+    jb.stats.received++;
+    jb.stats.depth = jb.count;
+    return true;
+}
+
+bool EspNowManager::jitterPlayout(EspNowPeer& peer, unsigned long nowUs, EspNowMotorCommand& out) {
+    EspNowJitterBuffer& jb = *peer.jitter;
+    
+    if (!jb.started) {
+        // Erste Ausgabe, sobald der älteste Frame die Verzögerung abgewartet hat
+        if (jb.count == 0 || (nowUs - jb.slots[0].arrivalUs) < jb.stats.delayUs) return false;
+        jb.nextPlayUs = nowUs;
+    }
+    
+    if ((long)(nowUs - jb.nextPlayUs) < 0) return false;
+    
+    // Feste Rate; nach längerer Blockade nicht nachholen
+    jb.nextPlayUs += jitterPeriodUs;
+    if ((long)(nowUs - jb.nextPlayUs) > (long)jitterPeriodUs) {
+        jb.nextPlayUs = nowUs + jitterPeriodUs;
+    }
+    
+    memcpy(out.mac, peer.mac, 6);
+    out.playoutUs = nowUs;
+    
+    // Sender schneller als die Ausgabe (Uhrendrift, höhere Rate): Frames, die
+    // länger als Verzögerung + Periode warten, überspringen, solange ein
+    // weiterer fälliger folgt → Alter bleibt begrenzt statt den Puffer zu füllen
+    while (jb.count > 1 && (nowUs - jb.slots[0].arrivalUs) > jb.stats.delayUs + jitterPeriodUs &&
+           (nowUs - jb.slots[1].arrivalUs) >= jb.stats.delayUs) {
+        jb.lastSeq = jb.slots[0].seq;
+        memmove(&jb.slots[0], &jb.slots[1], (jb.count - 1) * sizeof(EspNowJitterSlot));
+        jb.count--;
+        jb.stats.skipped++;
+    }
+    
+    if (jb.count > 0 && (nowUs - jb.slots[0].arrivalUs) >= jb.stats.delayUs) {
+        jb.left = jb.slots[0].left;
+        jb.right = jb.slots[0].right;
+        jb.lastSeq = jb.slots[0].seq;
+        memmove(&jb.slots[0], &jb.slots[1], (jb.count - 1) * sizeof(EspNowJitterSlot));
+        jb.count--;
+        jb.started = true;
+        jb.stats.played++;
+        out.held = false;
+    } else {
+        // Lücke: letzten Wert halten
+        jb.stats.underruns++;
+        out.held = true;
+    }
+    
+    out.left = jb.left;
+    out.right = jb.right;
+    out.seq = jb.lastSeq;
+    jb.stats.depth = jb.count;
+    return true;
+}
+
+void EspNowManager::processJitter() {
+    if (!jitterEnabled) return;
+    
+    unsigned long nowUs = micros();
+    
+    // Peer für Peer: Ausgabe außerhalb des Mutex (Callback darf Manager benutzen),
+    // keine Obergrenze für fällige Peers pro Durchlauf
+    for (size_t i = 0; ; i++) {
+        EspNowMotorCommand command;
+        bool ready = false;
+        
+        if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) != pdTRUE) break;
+        bool more = i < peers.size();
+        if (more && peers[i].jitter) {
+            ready = jitterPlayout(peers[i], nowUs, command);
+        }
+        xSemaphoreGive(peersMutex);
+        
+        if (!more) break;
+        if (ready) publishMotorCommand(command);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ABONNEMENTS (Worker-Kontext)
+// ═══════════════════════════════════════════════════════════════════════════
+
+int EspNowManager::subscribe(DataCmd cmd, EspNowSubscriptionCallback callback, uint32_t budgetUs, bool consume) {
+    return subscribe({ cmd }, callback, budgetUs, consume);
+}
+
+int EspNowManager::subscribe(std::initializer_list<DataCmd> cmds, EspNowSubscriptionCallback callback,
+                             uint32_t budgetUs, bool consume) {
+    if (!callback || !subsMutex || cmds.size() == 0) return 0;
+    if (xSemaphoreTakeRecursive(subsMutex, pdMS_TO_TICKS(10)) != pdTRUE) return 0;
+    
+    int handle = 0;
+    for (int i = 0; i < ESPNOW_MAX_SUBSCRIPTIONS; i++) {
+        Subscription& sub = subscriptions[i];
+        if (sub.active) continue;
+        
+        memset(sub.mask, 0, sizeof(sub.mask));
+        for (DataCmd cmd : cmds) {
+            uint8_t c = static_cast<uint8_t>(cmd);
+            sub.mask[c >> 5] |= 1UL << (c & 31);
+        }
+        sub.callback = callback;
+        sub.budgetUs = budgetUs;
+        sub.consume = consume;
+        sub.overrunStreak = 0;
+        memset(&sub.stats, 0, sizeof(sub.stats));
+        sub.generation++;
+        sub.active = true;
+        subscriptionCount++;
+        handle = (sub.generation << 8) | (i + 1);
+        break;
+    }
+    
+    xSemaphoreGiveRecursive(subsMutex);
+    
+    if (!handle) {
+        DEBUG_PRINTLN("EspNowManager: ⚠️ Keine Abonnement-Slots frei");
+    }
+    return handle;
+}
+
+EspNowManager::Subscription* EspNowManager::findSubscription(int handle) {
+    // Handle: [15:8] Generation, [7:0] Slot + 1 (veraltete Handles treffen keinen neuen Abonnenten)
+    int index = (handle & 0xFF) - 1;
+    if (handle < 1 || index < 0 || index >= ESPNOW_MAX_SUBSCRIPTIONS) return nullptr;
+    
+    Subscription& sub = subscriptions[index];
+    if (!sub.active || sub.generation != (uint8_t)(handle >> 8)) return nullptr;
+    return &sub;
+}
+
+bool EspNowManager::unsubscribe(int handle) {
+    if (!subsMutex) return false;
+    if (xSemaphoreTakeRecursive(subsMutex, pdMS_TO_TICKS(10)) != pdTRUE) return false;
+    
+    Subscription* sub = findSubscription(handle);
+    if (sub) {
+        sub->active = false;
+        sub->callback = nullptr;
+        subscriptionCount--;
+    }
+    
+    xSemaphoreGiveRecursive(subsMutex);
+    return sub != nullptr;
+}
+
+bool EspNowManager::resumeSubscription(int handle) {
+    Subscription* sub = findSubscription(handle);
+    if (!sub) return false;
+    sub->overrunStreak = 0;
+    sub->stats.suspended = false;
+    return true;
+}
+
+bool EspNowManager::getSubscriptionStats(int handle, EspNowSubscriptionStats* out) {
+    if (!out) return false;
+    
+    const Subscription* sub = findSubscription(handle);
+    if (!sub) return false;
+    *out = sub->stats;
+    return true;
+}
+
+bool EspNowManager::dispatchSubscriptions(const uint8_t* mac, const EspNowPacket& packet, bool& motorConsumed) {
+    motorConsumed = false;
+    if (subscriptionCount == 0) return false;
+    if (xSemaphoreTakeRecursive(subsMutex, pdMS_TO_TICKS(5)) != pdTRUE) {
+        // Abonnenten verpassen dieses Paket (Result-Queue bekommt es weiterhin)
+        subscriptionsDropped = subscriptionsDropped + 1;
+        return false;
+    }
+    
+    bool anyData = false;
+    bool allConsumed = true;
+    
+    for (int e = 0; e < packet.getEntryCount(); e++) {
+        DataCmd cmd;
+        const uint8_t* data;
+        size_t len;
+        if (!packet.getEntry(e, &cmd, &data, &len)) continue;
+        
+        // Transport-Einträge gehören dem Manager
+        uint8_t c = static_cast<uint8_t>(cmd);
+        if (c >= 0x60 && c <= 0x6F) continue;
+        anyData = true;
+        
+        bool consumed = false;
+        for (int i = 0; i < ESPNOW_MAX_SUBSCRIPTIONS; i++) {
+            Subscription& sub = subscriptions[i];
+            if (!sub.active || sub.stats.suspended || !(sub.mask[c >> 5] & (1UL << (c & 31)))) continue;
+            
+            uint8_t generation = sub.generation;
+            int64_t startUs = esp_timer_get_time();
+            sub.callback(mac, cmd, data, len);
+            uint32_t elapsed = esp_timer_get_time() - startUs;
+            
+            // Callback kann sich selbst abgemeldet (und den Slot neu vergeben) haben
+            if (!sub.active || sub.generation != generation) continue;
+            
+            sub.stats.calls++;
+            sub.stats.lastUs = elapsed;
+            if (elapsed > sub.stats.maxUs) sub.stats.maxUs = elapsed;
+            
+            if (elapsed > sub.budgetUs) {
+                sub.stats.overruns++;
+                sub.overrunStreak++;
+                if (ESPNOW_SUB_MAX_OVERRUNS > 0 && sub.overrunStreak >= ESPNOW_SUB_MAX_OVERRUNS) {
+                    sub.stats.suspended = true;
+                    DEBUG_PRINTF("EspNowManager: ⚠️ Abonnement %d pausiert (%lu µs > Budget %lu µs)\n",
+                                 (sub.generation << 8) | (i + 1), elapsed, sub.budgetUs);
+                }
+            } else {
+                sub.overrunStreak = 0;
+            }
+            
+            if (sub.consume) consumed = true;
+        }
+        
+        if (!consumed) {
+            allConsumed = false;
+        } else if (cmd == DataCmd::MOTOR_LEFT || cmd == DataCmd::MOTOR_RIGHT || cmd == DataCmd::MOTOR_ALL) {
+            motorConsumed = true;
+        }
+    }
+    
+    xSemaphoreGiveRecursive(subsMutex);
+    return anyData && allConsumed;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NOT-AUS (Fast-Path ohne Queues)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void EspNowManager::setEmergencyStopHandler(EspNowStopHandler handler) {
+    stopHandler = handler;
+}
+
+bool EspNowManager::addFrameTap(EspNowFrameTap tap) {
+    if (!tap) return false;
+    
+    for (auto& slot : frameTaps) {
+        if (slot == tap) return true;
+    }
+    for (auto& slot : frameTaps) {
+        if (!slot) {
+            slot = tap;
+            return true;
+        }
+    }
+    DEBUG_PRINTLN("EspNowManager: ⚠️ Kein Frame-Tap-Slot frei");
+    return false;
+}
+
+void EspNowManager::removeFrameTap(EspNowFrameTap tap) {
+    for (auto& slot : frameTaps) {
+        if (slot == tap) slot = nullptr;
+    }
+}
+
+void EspNowManager::tapFrame(EspNowTapKind kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info) {
+    for (int i = 0; i < ESPNOW_MAX_FRAME_TAPS; i++) {
+        EspNowFrameTap tap = frameTaps[i];
+        if (tap) tap(kind, mac, data, len, info);
+    }
+}
+
+esp_err_t EspNowManager::sendFrame(const uint8_t* mac, const uint8_t* data, size_t len) {
+    esp_err_t result = esp_now_send(mac, data, len);
+    tapFrame(EspNowTapKind::TX, mac, data, len, result == ESP_OK ? 0 : -1);
+    return result;
+}
+
+void EspNowManager::clearEmergencyStop() {
+    emergencyStopped = false;
+    DEBUG_PRINTLN("EspNowManager: Not-Aus freigegeben");
+}
+
+void EspNowManager::getStopStats(EspNowStopStats* stats) {
+    if (stats) *stats = stopStats;
+}
+
+bool EspNowManager::sendEmergencyStop(const uint8_t* mac) {
+    if (!initialized) return false;
+    
+    int64_t startUs = esp_timer_get_time();
+    
+    if (mac) {
+        memcpy(stopTxMac, mac, 6);
+        // Unicast braucht einen Treiber-Slot (Broadcast-Peer ist immer registriert)
+        if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(5)) == pdTRUE) {
+            int index = findPeerIndex(mac);
+            if (index >= 0) registerPeer(peers[index], true);
+            xSemaphoreGive(peersMutex);
+        }
+    } else {
+        memset(stopTxMac, 0xFF, 6);
+    }
+    
+    stopTxId++;
+    stopRepeatsLeft = 0;
+    bool ok = transmitStop();
+    
+    stopTxUs = esp_timer_get_time();
+    stopStats.sent++;
+    stopStats.sendLatencyUs = stopTxUs - startUs;
+    
+    // Weitere Kopien zeitversetzt aus dem Worker
+    stopNextUs = stopTxUs + ESPNOW_ESTOP_SPACING_MS * 1000;
+    stopRepeatsLeft = ESPNOW_ESTOP_REPEATS > 1 ? ESPNOW_ESTOP_REPEATS - 1 : 0;
+    if (workerTaskHandle) {
+        xTaskNotifyGive(workerTaskHandle);
+    }
+    
+    DEBUG_PRINTF("EspNowManager: 🛑 Not-Aus #%u gesendet (%s)\n", stopTxId,
+                 ok ? "OK" : "Fehler");
+    return ok;
+}
+
+bool EspNowManager::transmitStop() {
+    // [EMERGENCY_STOP] [4] [STOP_ID] [2] [ID lo] [ID hi]
+    uint8_t frame[6] = {
+        static_cast<uint8_t>(MainCmd::EMERGENCY_STOP), 4,
+        static_cast<uint8_t>(DataCmd::STOP_ID), 2,
+        static_cast<uint8_t>(stopTxId & 0xFF), static_cast<uint8_t>(stopTxId >> 8)
+    };
+    stopStats.copiesSent++;
+    return sendFrame(stopTxMac, frame, sizeof(frame)) == ESP_OK;
+}
+
+void EspNowManager::processStopRepeats() {
+    if (stopRepeatsLeft == 0 || esp_timer_get_time() < stopNextUs) return;
+    
+    transmitStop();
+    stopRepeatsLeft = stopRepeatsLeft - 1;
+    stopNextUs += ESPNOW_ESTOP_SPACING_MS * 1000;
+}
+
+bool EspNowManager::handleStopFast(const uint8_t* mac, const uint8_t* data, int len, int64_t rxUs) {
+    if (len < 6 || data[2] != static_cast<uint8_t>(DataCmd::STOP_ID) || data[3] != 2) return false;
+    
+    uint16_t id = data[4] | (data[5] << 8);
+    
+    // Redundante Kopie desselben Not-Aus?
+    if (id == lastStopId && memcmp(mac, lastStopMac, 6) == 0 &&
+        (rxUs - lastStopUs) < ESPNOW_ESTOP_DEDUP_MS * 1000LL) {
+        stopStats.duplicates++;
+        return false;
+    }
+    lastStopId = id;
+    memcpy(lastStopMac, mac, 6);
+    lastStopUs = rxUs;
+    emergencyStopped = true;
+    stopStats.received++;
+    
+    // Handler sofort im Callback-Kontext
+    int64_t callUs = esp_timer_get_time();
+    if (stopHandler) {
+        stopHandler(mac, id);
+    }
+    int64_t doneUs = esp_timer_get_time();
+    
+    stopStats.handlerLatencyUs = callUs - rxUs;
+    if (stopStats.handlerLatencyUs > stopStats.maxHandlerLatencyUs) {
+        stopStats.maxHandlerLatencyUs = stopStats.handlerLatencyUs;
+    }
+    stopStats.handlerDurationUs = doneUs - callUs;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATEN SENDEN (via TX-Queue)
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool EspNowManager::send(const uint8_t* mac, const EspNowPacket& packet, EspNowLane lane) {
+    return enqueueTx(mac, packet, ESPNOW_GROUP_ALL, lane);
+}
+
+bool EspNowManager::addPacked(const uint8_t* mac, EspNowPacket& packet, DataCmd dataCmd, const int32_t* fields,
+                              uint8_t count, uint8_t width, EspNowCodec codec) {
+    if (!mac || !packet.isValid()) return false;
+    size_t before = packet.getDataLength();
+    
+    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) != pdTRUE) return false;
+    
+    int index = findPeerIndex(mac);
+    if (index >= 0) {
+        // Kontext nur lesen, fortgeschrieben wird in transmitTx nach dem Senden
+        EspNowPeer& peer = peers[index];
+        if (!peer.txCodec) {
+            peer.txCodec = new EspNowCodecContext();
+        }
+        packet.addPacked(dataCmd, fields, count, width, codec, peer.txCodec);
+    }
+    
+    xSemaphoreGive(peersMutex);
+    return packet.getDataLength() > before;
+}
+
+bool EspNowManager::broadcast(const EspNowPacket& packet, uint8_t groupId, EspNowLane lane) {
+    return enqueueTx(nullptr, packet, groupId, lane);
+}
+
+int EspNowManager::send(std::span<const EspNowMac> macs, const EspNowPacket& packet, EspNowLane lane) {
+    if (macs.empty() || macs.size() > 255) return 0;
+    if (!initialized || !packet.isValid()) {
+        DEBUG_PRINTLN("EspNowManager: ❌ Nicht initialisiert oder ungültiges Paket!");
+        return 0;
+    }
+    
+    int laneIdx = static_cast<int>(lane);
+    if (laneIdx < 0 || laneIdx >= ESPNOW_LANE_COUNT || !txQueues[laneIdx]) return 0;
+    
+    // Ein Buffer für alle Ziele, Referenzen vor dem Einreihen setzen (Worker kann sofort senden)
+    int buffer = allocTxBuffer(packet, static_cast<uint8_t>(macs.size()), lane);
+    if (buffer < 0) return 0;
+    
+    // Mehr Ziele als Queue-Plätze: Worker leeren lassen statt Ziele zu verwerfen
+    // (im Worker selbst würde das Warten nie enden)
+    bool canWait = workerTaskHandle && xTaskGetCurrentTaskHandle() != workerTaskHandle;
+    unsigned long waitStart = millis();
+    
+    int accepted = 0;
+    for (const EspNowMac& mac : macs) {
+        while (canWait && uxQueueSpacesAvailable(txQueues[laneIdx]) == 0 &&
+               (millis() - waitStart) < ESPNOW_TX_FANOUT_WAIT_MS) {
+            xTaskNotifyGive(workerTaskHandle);
+            vTaskDelay(1);
+        }
+        if (enqueueDescriptor(mac.addr, static_cast<uint8_t>(buffer), lane)) {
+            accepted++;
+        } else {
+            releaseTxBuffer(static_cast<uint8_t>(buffer));
+        }
+    }
+    return accepted;
+}
+
+void EspNowManager::sendHeartbeat() {
+    // Ein Broadcast-Frame für alle Peers (Airtime unabhängig von Peer-Anzahl)
+    if (!heartbeatPacket.isValid()) {
+        heartbeatPacket.begin(MainCmd::HEARTBEAT);
+    }
+    broadcast(heartbeatPacket, ESPNOW_GROUP_ALL, EspNowLane::CONTROL);
+}
+
+bool EspNowManager::enqueueTx(const uint8_t* mac, const EspNowPacket& packet, uint8_t groupId, EspNowLane lane) {
+    int laneIdx = static_cast<int>(lane);
+    if (laneIdx < 0 || laneIdx >= ESPNOW_LANE_COUNT) return false;
+    
+    if (!initialized || !txQueues[laneIdx]) {
+        DEBUG_PRINTLN("EspNowManager: ❌ Nicht initialisiert!");
+        return false;
+    }
+
+    if (!packet.isValid()) {
+        DEBUG_PRINTLN("EspNowManager: ❌ Ungültiges Paket!");
+        return false;
+    }
+
+    int buffer = allocTxBuffer(packet, 1, lane);
+    if (buffer < 0) return false;
+    
+    // Gruppen-ID als ersten Eintrag (Empfänger filtert im RX-Callback)
+    if (!mac && groupId != ESPNOW_GROUP_ALL) {
+        EspNowTxBuffer& txBuf = txPool[buffer];
+        size_t length = txBuf.length;
+        if (!insertEntry(txBuf.data, length, DataCmd::GROUP_ID, &groupId, 1)) {
+            DEBUG_PRINTLN("EspNowManager: ❌ Kein Platz für Gruppen-ID!");
+            releaseTxBuffer(static_cast<uint8_t>(buffer));
+            return false;
+        }
+        txBuf.length = static_cast<uint8_t>(length);
+    }
+    
+    if (!enqueueDescriptor(mac, static_cast<uint8_t>(buffer), lane)) {
+        releaseTxBuffer(static_cast<uint8_t>(buffer));
+        return false;
+    }
+    return true;
+}
+
+bool EspNowManager::enqueueDescriptor(const uint8_t* mac, uint8_t buffer, EspNowLane lane, bool raw) {
+    int laneIdx = static_cast<int>(lane);
+    if (laneIdx < 0 || laneIdx >= ESPNOW_LANE_COUNT || !txQueues[laneIdx]) return false;
+    
+    TxQueueItem item;
+    item.buffer = buffer;
+    item.raw = raw;
+    item.lane = lane;
+    item.enqueueUs = micros();
+    
+    if (mac) {
+        memcpy(item.mac, mac, 6);
+        item.broadcast = false;
+    } else {
+        memset(item.mac, 0xFF, 6);  // Broadcast-MAC
+        item.broadcast = true;
+    }
+
+    // In Lane-Queue einreihen (non-blocking)
+    if (xQueueSend(txQueues[laneIdx], &item, 0) != pdTRUE) {
+        laneStats[laneIdx].dropped++;
+        DEBUG_PRINTF("EspNowManager: ⚠️ TX-Queue voll (Lane %d)!\n", laneIdx);
+        return false;
+    }
+    laneStats[laneIdx].enqueued++;
+    
+    // Control: Worker sofort wecken statt auf nächsten Tick zu warten
+    if (lane == EspNowLane::CONTROL && workerTaskHandle) {
+        xTaskNotifyGive(workerTaskHandle);
+    }
+
+    return true;
+}
+
+void EspNowManager::setLaneRate(EspNowLane lane, uint16_t rate, uint8_t burst) {
+    int laneIdx = static_cast<int>(lane);
+    if (laneIdx < 0 || laneIdx >= ESPNOW_LANE_COUNT) return;
+    
+    bool wasUnlimited = laneConfig[laneIdx].rate == 0;
+    laneConfig[laneIdx].rate = rate;
+    laneConfig[laneIdx].burst = burst > 0 ? burst : 1;
+    
+    // Drosselung neu eingeschaltet: Buckets starten voll (bisher nie befüllt)
+    if (wasUnlimited && rate > 0) {
+        bool locked = peersMutex && xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE;
+        unsigned long nowUs = micros();
+        for (auto& peer : peers) {
+            if (!locked) break;
+            peer.buckets[laneIdx].tokens = laneConfig[laneIdx].burst;
+            peer.buckets[laneIdx].lastUs = nowUs;
+        }
+        broadcastBuckets[laneIdx].tokens = laneConfig[laneIdx].burst;
+        broadcastBuckets[laneIdx].lastUs = nowUs;
+        if (locked) xSemaphoreGive(peersMutex);
+    }
+    DEBUG_PRINTF("EspNowManager: Lane %d: %d Frames/s, Burst %d\n", laneIdx, rate, burst);
+}
+
+void EspNowManager::getLaneStats(EspNowLane lane, EspNowLaneStats* stats) {
+    int laneIdx = static_cast<int>(lane);
+    if (!stats || laneIdx < 0 || laneIdx >= ESPNOW_LANE_COUNT) return;
+    
+    *stats = laneStats[laneIdx];
+    stats->pending = txHeldCount[laneIdx] + (txQueues[laneIdx] ? uxQueueMessagesWaiting(txQueues[laneIdx]) : 0);
+}
+
+int EspNowManager::allocTxBuffer(const EspNowPacket& packet, uint8_t refs, EspNowLane lane) {
+    // Kontingent der Lane zuerst (gedrosselte Lane hält höchstens ESPNOW_TX_LANE_BUFFERS)
+    int laneIdx = static_cast<int>(lane);
+    if (txLaneBuffers[laneIdx].fetch_add(1) >= ESPNOW_TX_LANE_BUFFERS) {
+        txLaneBuffers[laneIdx].fetch_sub(1);
+        laneStats[laneIdx].dropped++;
+        DEBUG_PRINTF("EspNowManager: ⚠️ TX-Buffer der Lane %d belegt!\n", laneIdx);
+        return -1;
+    }
+    
+    // Freien Buffer per CAS reservieren (Main und Worker senden beide)
+    for (int i = 0; i < ESPNOW_TX_POOL_SIZE; i++) {
+        uint8_t expected = 0;
+        if (txPool[i].refs.compare_exchange_strong(expected, refs)) {
+            memcpy(txPool[i].data, packet.getRawData(), packet.getTotalLength());
+            txPool[i].length = static_cast<uint8_t>(packet.getTotalLength());
+            txPool[i].lane = static_cast<uint8_t>(laneIdx);
+            return i;
+        }
+    }
+    
+    txLaneBuffers[laneIdx].fetch_sub(1);
+    txPoolExhausted++;
+    DEBUG_PRINTLN("EspNowManager: ⚠️ TX-Pool erschöpft!");
+    return -1;
+}
+
+void EspNowManager::releaseTxBuffer(uint8_t buffer) {
+    if (buffer < ESPNOW_TX_POOL_SIZE && txPool[buffer].refs.load() > 0) {
+        // Letzte Referenz → Buffer zurück ins Kontingent der Lane
+        if (txPool[buffer].refs.fetch_sub(1) == 1) {
+            txLaneBuffers[txPool[buffer].lane].fetch_sub(1);
+        }
+    }
+}
+
+void EspNowManager::getTxPoolStats(int* inUse, uint32_t* exhausted) {
+    if (inUse) {
+        *inUse = 0;
+        for (int i = 0; i < ESPNOW_TX_POOL_SIZE; i++) {
+            if (txPool[i].refs.load() > 0) (*inUse)++;
+        }
+    }
+    if (exhausted) *exhausted = txPoolExhausted;
+}
+
+bool EspNowManager::insertEntry(uint8_t* frame, size_t& len, DataCmd cmd, const void* data, size_t dataLen) {
+    // Eintrag direkt nach dem Header einfügen: [MAIN][LEN][CMD][LEN][DATA] [Rest...]
+    if (len < 2 || len + 2 + dataLen > ESPNOW_MAX_PACKET_SIZE) return false;
+    
+    memmove(&frame[4 + dataLen], &frame[2], len - 2);
+    frame[2] = static_cast<uint8_t>(cmd);
+    frame[3] = static_cast<uint8_t>(dataLen);
+    memcpy(&frame[4], data, dataLen);
+    
+    len += 2 + dataLen;
+    frame[1] = static_cast<uint8_t>(len - 2);
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// GRUPPEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+void EspNowManager::joinGroup(uint8_t groupId) {
+    groupMask[groupId >> 5] |= (1UL << (groupId & 31));
+    DEBUG_PRINTF("EspNowManager: Gruppe %d beigetreten\n", groupId);
+}
+
+void EspNowManager::leaveGroup(uint8_t groupId) {
+    groupMask[groupId >> 5] &= ~(1UL << (groupId & 31));
+    DEBUG_PRINTF("EspNowManager: Gruppe %d verlassen\n", groupId);
+}
+
+bool EspNowManager::isGroupMember(uint8_t groupId) const {
+    if (groupId == ESPNOW_GROUP_ALL) return true;
+    return (groupMask[groupId >> 5] & (1UL << (groupId & 31))) != 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HEARTBEAT & TIMEOUT
+// ═══════════════════════════════════════════════════════════════════════════
+
+void EspNowManager::setHeartbeat(bool enabled, uint32_t intervalMs) {
+    heartbeatEnabled = enabled;
+    heartbeatInterval = intervalMs;
+    DEBUG_PRINTF("EspNowManager: Heartbeat %s (%dms)\n", enabled ? "AN" : "AUS", intervalMs);
+}
+
+void EspNowManager::setTimeout(uint32_t timeout) {
+    timeoutMs = timeout;
+    DEBUG_PRINTF("EspNowManager: Timeout: %dms\n", timeout);
+}
+
+void EspNowManager::checkTimeouts() {
+    unsigned long now = millis();
+
+    for (auto& peer : peers) {
+        if (peer.connected) {
+            if (peer.lastSeen > 0 && (now - peer.lastSeen) > timeoutMs) {
+                peer.connected = false;
                 
                 DEBUG_PRINTF("EspNowManager: ⚠️ Peer %s Timeout!\n", macToString(peer.mac).c_str());
 
@@ -716,24 +2719,135 @@ void EspNowManager::setSendCallback(EspNowSendCallback callback) {
     sendCallback = callback;
 }
 
-void EspNowManager::onEvent(EspNowEvent event, EspNowEventCallback callback) {
-    int idx = static_cast<int>(event);
-    if (idx >= 0 && idx < 12) {
-        eventCallbacks[idx] = callback;
+// ═══════════════════════════════════════════════════════════════════════════
+// EVENT-BUS
+// ═══════════════════════════════════════════════════════════════════════════
+
+EspNowEventToken EspNowManager::onEvent(EspNowEvent event, EspNowEventHandler handler,
+                                        EspNowDispatch dispatch, const uint8_t* mac) {
+    if (!handler || !eventMutex || event == EspNowEvent::NONE) return 0;
+    if (xSemaphoreTakeRecursive(eventMutex, pdMS_TO_TICKS(10)) != pdTRUE) return 0;
+    
+    EspNowEventToken token = 0;
+    for (int i = 0; i < ESPNOW_EVENT_MAX_HANDLERS; i++) {
+        EventSlot& slot = eventSlots[i];
+        if (slot.active) continue;
+        
+        slot.generation++;
+        slot.event = event;
+        slot.dispatch = dispatch;
+        slot.filterMac = (mac != nullptr);
+        if (mac) memcpy(slot.mac, mac, 6);
+        slot.handler = handler;
+        slot.active = true;
+        token = ((uint32_t)slot.generation << 8) | (uint32_t)(i + 1);
+        break;
+    }
+    updateEventMask();
+    
+    xSemaphoreGiveRecursive(eventMutex);
+    
+    if (!token) {
+        DEBUG_PRINTLN("EspNowManager: ⚠️ Keine Event-Slots frei");
+    }
+    return token;
+}
+
+bool EspNowManager::offEvent(EspNowEventToken token) {
+    int index = (int)(token & 0xFF) - 1;
+    if (index < 0 || index >= ESPNOW_EVENT_MAX_HANDLERS || !eventMutex) return false;
+    if (xSemaphoreTakeRecursive(eventMutex, pdMS_TO_TICKS(10)) != pdTRUE) return false;
+    
+    EventSlot& slot = eventSlots[index];
+    bool match = slot.active && slot.generation == (uint8_t)(token >> 8);
+    if (match) {
+        slot.active = false;
+        slot.handler = nullptr;
+        updateEventMask();
     }
+    
+    xSemaphoreGiveRecursive(eventMutex);
+    return match;
 }
 
 void EspNowManager::offEvent(EspNowEvent event) {
-    int idx = static_cast<int>(event);
-    if (idx >= 0 && idx < 12) {
-        eventCallbacks[idx] = nullptr;
+    if (!eventMutex || xSemaphoreTakeRecursive(eventMutex, pdMS_TO_TICKS(10)) != pdTRUE) return;
+    
+    for (auto& slot : eventSlots) {
+        if (slot.active && slot.event == event) {
+            slot.active = false;
+            slot.handler = nullptr;
+        }
+    }
+    updateEventMask();
+    
+    xSemaphoreGiveRecursive(eventMutex);
+}
+
+void EspNowManager::updateEventMask() {
+    uint32_t mask[2] = { 0, 0 };
+    for (const auto& slot : eventSlots) {
+        if (slot.active) {
+            mask[static_cast<int>(slot.dispatch)] |= 1UL << static_cast<int>(slot.event);
+        }
     }
+    eventMask[0] = mask[0];
+    eventMask[1] = mask[1];
 }
 
 void EspNowManager::triggerEvent(EspNowEvent event, EspNowEventData* data) {
-    int idx = static_cast<int>(event);
-    if (idx >= 0 && idx < 12 && eventCallbacks[idx]) {
-        eventCallbacks[idx](data);
+    // Im Main-Thread entstanden → beide Kontexte sofort bedienen
+    data->event = event;
+    tapFrame(EspNowTapKind::EVENT, data->mac, (const uint8_t*)&data->event, 1, data->success);
+    dispatchEvent(data, EspNowDispatch::WORKER);
+    dispatchEvent(data, EspNowDispatch::MAIN);
+}
+
+void EspNowManager::postEvent(EspNowEvent event, EspNowEventData* data) {
+    // Außerhalb des Main-Threads → WORKER sofort, MAIN über die Event-Queue
+    data->event = event;
+    tapFrame(EspNowTapKind::EVENT, data->mac, (const uint8_t*)&data->event, 1, data->success);
+    dispatchEvent(data, EspNowDispatch::WORKER);
+    
+    if (eventQueue && (eventMask[0] & (1UL << static_cast<int>(event)))) {
+        EspNowEventData queued = *data;
+        queued.packet = nullptr;    // Paket lebt nur im erzeugenden Task
+        if (xQueueSend(eventQueue, &queued, 0) != pdTRUE) {
+            eventsDropped = eventsDropped + 1;
+        }
+    }
+}
+
+void EspNowManager::dispatchEvent(EspNowEventData* data, EspNowDispatch dispatch) {
+    int ctx = static_cast<int>(dispatch);
+    if (!(eventMask[ctx] & (1UL << static_cast<int>(data->event)))) return;
+    
+    // Passende Slots unter dem Lock sammeln, Handler ohne Lock aufrufen:
+    // ein langsamer Handler blockiert weder onEvent/offEvent noch den WiFi-Task
+    uint8_t matches[ESPNOW_EVENT_MAX_HANDLERS];
+    uint8_t generations[ESPNOW_EVENT_MAX_HANDLERS];
+    int matchCount = 0;
+    
+    if (xSemaphoreTakeRecursive(eventMutex, pdMS_TO_TICKS(10)) != pdTRUE) return;
+    for (int i = 0; i < ESPNOW_EVENT_MAX_HANDLERS; i++) {
+        const EventSlot& slot = eventSlots[i];
+        if (!slot.active || slot.event != data->event || slot.dispatch != dispatch) continue;
+        if (slot.filterMac && !compareMac(slot.mac, data->mac)) continue;
+        matches[matchCount] = i;
+        generations[matchCount] = slot.generation;
+        matchCount++;
+    }
+    xSemaphoreGiveRecursive(eventMutex);
+    
+    for (int m = 0; m < matchCount; m++) {
+        // Inzwischen abgemeldet (auch von einem vorherigen Handler) → überspringen
+        if (xSemaphoreTakeRecursive(eventMutex, pdMS_TO_TICKS(10)) != pdTRUE) return;
+        const EventSlot& slot = eventSlots[matches[m]];
+        bool current = slot.active && slot.generation == generations[m];
+        EspNowEventHandler handler = slot.handler;
+        xSemaphoreGiveRecursive(eventMutex);
+        
+        if (current) handler(data);
     }
 }
 
@@ -746,20 +2860,43 @@ void EspNowManager::onDataRecvStatic(const esp_now_recv_info_t* info, const uint
     
     if (!mgr.rxQueue || !info || !data || len <= 0) return;
     
+    int8_t rssi = info->rx_ctrl ? info->rx_ctrl->rssi : 0;
+    mgr.tapFrame(EspNowTapKind::RX, info->src_addr, data, len, rssi);
+    
+    // Not-Aus: sofort behandeln, erst danach (nur erste Kopie) normal einreihen
+    if (data[0] == static_cast<uint8_t>(MainCmd::EMERGENCY_STOP)) {
+        int64_t rxUs = esp_timer_get_time();
+        if (!mgr.handleStopFast(info->src_addr, data, len, rxUs)) return;
+    }
+    
+    // Gruppen-Filter: GROUP_ID ist immer der erste Eintrag → fremde Gruppen
+    // verwerfen, bevor sie einen Queue-Slot belegen
+    if (len >= 5 && data[2] == static_cast<uint8_t>(DataCmd::GROUP_ID) && data[3] == 1 &&
+        !mgr.isGroupMember(data[4])) {
+        mgr.groupFiltered++;
+        return;
+    }
+    
     // Direkt in Queue schieben (im WiFi-Interrupt-Kontext!)
     RxQueueItem item;
     memcpy(item.mac, info->src_addr, 6);
     memcpy(item.data, data, len);
     item.length = len;
     item.timestamp = millis();
+    item.rssi = rssi;
     
     // Non-blocking, von ISR aus
     xQueueSendFromISR(mgr.rxQueue, &item, nullptr);
 }
 
 void EspNowManager::onDataSentStatic(const wifi_tx_info_t* tx_info, esp_now_send_status_t status) {
-    // Neue API (ESP32 Arduino Core 3.x)
-    getInstance().handleSendStatus(nullptr, status == ESP_NOW_SEND_SUCCESS);
+    // Neue API (ESP32 Arduino Core 3.x): Ziel-MAC für Abschluss pro Ziel
+    if (!tx_info || !tx_info->des_addr) return;
+    
+    EspNowManager& mgr = getInstance();
+    bool success = status == ESP_NOW_SEND_SUCCESS;
+    mgr.tapFrame(EspNowTapKind::TX_STATUS, tx_info->des_addr, nullptr, 0, success);
+    mgr.handleSendStatus(tx_info->des_addr, success);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -778,8 +2915,14 @@ void EspNowManager::workerTask(void* parameter) {
         // TX-Queue verarbeiten
         mgr->processTxQueue();
         
-        // Kurze Pause um CPU nicht zu blockieren
-        vTaskDelay(pdMS_TO_TICKS(1));
+        // Ausstehende Not-Aus-Wiederholungen
+        mgr->processStopRepeats();
+        
+        // Motor-Befehle mit fester Rate ausgeben
+        mgr->processJitter();
+        
+        // Kurze Pause um CPU nicht zu blockieren (Control-Frames wecken sofort)
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1));
     }
     
     DEBUG_PRINTLN("EspNowManager: Worker-Task beendet");
@@ -791,82 +2934,411 @@ void EspNowManager::processRxQueue() {
     
     // Alle verfügbaren RX-Items verarbeiten
     while (xQueueReceive(rxQueue, &rxItem, 0) == pdTRUE) {
+        handleRxFrame(rxItem.mac, rxItem.data, rxItem.length, rxItem.timestamp, rxItem.rssi, false);
+    }
+}
+
+void EspNowManager::handleRxFrame(const uint8_t* mac, const uint8_t* data, size_t len,
+                                  unsigned long timestamp, int8_t rssi, bool recovered) {
+    // Paket parsen (Worker-eigener Puffer, rekonstruierter Frame im zweiten)
+    EspNowPacket& packet = rxPackets[recovered ? 1 : 0];
+    if (!packet.parse(data, len)) {
+        DEBUG_PRINTLN("EspNowManager: ⚠️ Worker: Paket-Parse fehlgeschlagen");
+        return;
+    }
+    
+    MainCmd cmd = packet.getMainCmd();
+    bool isDiscovery = (cmd == MainCmd::PAIR_REQUEST || cmd == MainCmd::PAIR_RESPONSE);
+    bool known = false;
+    
+    // FEC: rekonstruierter Frame in rxRecovered (nur bei Parity mit genau einem Verlust)
+    size_t recoveredLen = 0;
+    bool hasRecovered = false;
+    bool jitterTaken = false;
+    bool connectedNow = false;
+    unsigned long arrivalUs = micros();
+    
+    // Peer aktualisieren (mit Mutex)
+    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        int index = findPeerIndex(mac);
         
-        // Paket parsen
-        EspNowPacket packet;
-        if (!packet.parse(rxItem.data, rxItem.length)) {
-            DEBUG_PRINTLN("EspNowManager: ⚠️ Worker: Paket-Parse fehlgeschlagen");
-            continue;
+        // Discovery: unbekannten Absender logisch übernehmen (ohne Treiber-Slot)
+        if (index < 0 && autoDiscovery && (isDiscovery || cmd == MainCmd::HEARTBEAT) &&
+            (ESPNOW_MAX_PEERS == 0 || peers.size() < (size_t)ESPNOW_MAX_PEERS)) {
+            peers.push_back(makePeer(mac, false));
+            index = peers.size() - 1;
+            DEBUG_PRINTF("EspNowManager: ✅ Peer entdeckt: %s\n", macToString(mac).c_str());
         }
         
-        // Peer aktualisieren (mit Mutex)
-        if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-            int index = findPeerIndex(rxItem.mac);
-            if (index >= 0) {
-                bool wasDisconnected = !peers[index].connected;
-                peers[index].connected = true;
-                peers[index].lastSeen = rxItem.timestamp;
-                peers[index].packetsReceived++;
-                
-                // Connected-Event später im Main-Thread triggern
-                if (wasDisconnected) {
-                    // Via Result-Queue signalisieren
-                    ResultQueueItem result;
-                    memset(&result, 0, sizeof(result));
-                    memcpy(result.mac, rxItem.mac, 6);
-                    result.mainCmd = MainCmd::NONE;  // Marker für Connect-Event
-                    result.timestamp = rxItem.timestamp;
-                    xQueueSend(resultQueue, &result, 0);
+        if (index >= 0) {
+            known = true;
+            bool wasDisconnected = !peers[index].connected;
+            peers[index].connected = true;
+            peers[index].lastSeen = timestamp;
+            peers[index].packetsReceived++;
+            updateLinkStats(peers[index], rssi, packet);
+            
+            // Kompakte Deltas gegen den Kontext des Absenders auflösen
+            if (packet.needsCodecContext()) {
+                if (!peers[index].codec) {
+                    peers[index].codec = new EspNowCodecContext();
                 }
+                packet.resolveDeltas(*peers[index].codec);
+            }
+            
+            if (!recovered) {
+                hasRecovered = fecReceive(peers[index], packet, data, len, rxRecovered, recoveredLen);
+            }
+            
+            // Connected-Event später im Main-Thread triggern
+            if (wasDisconnected) {
+                connectedNow = true;
+                
+                // Via Result-Queue signalisieren
+                ResultQueueItem result;
+                memset(&result, 0, sizeof(result));
+                memcpy(result.mac, mac, 6);
+                result.mainCmd = MainCmd::NONE;  // Marker für Connect-Event
+                result.timestamp = timestamp;
+                xQueueSend(resultQueue, &result, 0);
             }
-            xSemaphoreGive(peersMutex);
         }
-        
-        // Nach MainCmd verarbeiten
-        MainCmd cmd = packet.getMainCmd();
-        
-        if (cmd == MainCmd::HEARTBEAT) {
-            // Heartbeat - nur Peer-Update (oben bereits gemacht)
-            continue;
+        xSemaphoreGive(peersMutex);
+    }
+    
+    // WORKER-Abonnenten: Events ohne Umweg über update()
+    EspNowEventData eventData = {};
+    memcpy(eventData.mac, mac, 6);
+    if (connectedNow) {
+        eventData.event = EspNowEvent::PEER_CONNECTED;
+        dispatchEvent(&eventData, EspNowDispatch::WORKER);
+    }
+    
+    // Nach MainCmd verarbeiten
+    if (cmd == MainCmd::FEC_PARITY) {
+        // Parity nur für Rekonstruktion, rekonstruierten Frame normal verarbeiten
+        if (hasRecovered) {
+            handleRxFrame(mac, rxRecovered, recoveredLen, timestamp, rssi, true);
         }
-        
-        // User-Callback im Worker-Thread (optional)
-        if (receiveCallback) {
-            receiveCallback(rxItem.mac, packet);
+        return;
+    }
+    
+    if (cmd == MainCmd::PAIR_REQUEST && known) {
+        // Discovery beantworten (Unicast, Peer wird beim Senden eingeswappt)
+        rxReply.begin(MainCmd::PAIR_RESPONSE);
+        send(mac, rxReply, EspNowLane::CONTROL);
+    }
+    
+    if (cmd == MainCmd::HEARTBEAT) {
+        // Heartbeat - nur Peer-Update (oben bereits gemacht)
+        postEvent(EspNowEvent::HEARTBEAT_RECEIVED, &eventData);
+        return;
+    }
+    
+    // Abonnenten sofort im Worker bedienen (vor Result-Queue)
+    bool motorConsumed;
+    bool consumed = dispatchSubscriptions(mac, packet, motorConsumed);
+    
+    if (cmd == MainCmd::EMERGENCY_STOP) {
+        // Handler lief bereits im Callback → Absender bestätigen, Main-Thread informieren
+        uint16_t stopId;
+        if (packet.getUInt16(DataCmd::STOP_ID, stopId)) {
+            rxReply.begin(MainCmd::ACK).addUInt16(DataCmd::STOP_ID, stopId);
+            send(mac, rxReply, EspNowLane::CONTROL);
         }
-        
-        // Daten für Main-Thread aufbereiten
         ResultQueueItem result;
-        packetToResult(rxItem.mac, packet, result);
+        memset(&result, 0, sizeof(result));
+        memcpy(result.mac, mac, 6);
+        result.mainCmd = MainCmd::EMERGENCY_STOP;
+        result.timestamp = timestamp;
+        xQueueSend(resultQueue, &result, 0);
+        
+        eventData.event = EspNowEvent::EMERGENCY_STOP;
+        dispatchEvent(&eventData, EspNowDispatch::WORKER);
+        return;
+    }
+    
+    if (cmd == MainCmd::ACK) {
+        // Not-Aus-Bestätigung → Round-Trip messen
+        uint16_t stopId;
+        if (packet.getUInt16(DataCmd::STOP_ID, stopId) && stopId == stopTxId) {
+            uint32_t rtt = esp_timer_get_time() - stopTxUs;
+            stopStats.acks++;
+            stopStats.ackRttUs = rtt;
+            if (rtt > stopStats.maxAckRttUs) stopStats.maxAckRttUs = rtt;
+            if (stopTxMac[0] != 0xFF) stopRepeatsLeft = 0;  // Unicast bestätigt
+        }
+    }
+    
+    if (cmd == MainCmd::STATE_DELTA || cmd == MainCmd::STATE_KEYFRAME) {
+        // Zustand direkt übernehmen, keine Result-Queue (Main liest Snapshot)
+        applyState(mac, packet, cmd == MainCmd::STATE_KEYFRAME);
+        return;
+    }
+    
+    // Motor-Befehle nur von der Motor-Quelle (bekannter Peer), sonst verwerfen
+    bool motorFrame = !motorConsumed && (packet.has(DataCmd::MOTOR_ALL) ||
+                      packet.has(DataCmd::MOTOR_LEFT) || packet.has(DataCmd::MOTOR_RIGHT));
+    bool motorForeign = motorFrame && (!known || !acceptMotorSource(mac));
+    
+    // Motor-Befehle in den Jitter-Buffer statt direkt in die Result-Queue
+    // (von Abonnenten verbrauchte Motor-Einträge bleiben draußen)
+    if (jitterEnabled && motorFrame && !motorForeign &&
+        xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        int index = findPeerIndex(mac);
+        if (index >= 0) {
+            jitterTaken = jitterPush(peers[index], packet, arrivalUs);
+        }
+        xSemaphoreGive(peersMutex);
+    }
+    
+    // IMU-Batches in Ringpuffer entpacken (App liest über readImuSamples)
+    unpackImuBatches(mac, packet);
+    
+    // User-Callback im Worker-Thread (optional)
+    if (receiveCallback) {
+        receiveCallback(mac, packet);
+    }
+    
+    eventData.event = EspNowEvent::DATA_RECEIVED;
+    eventData.packet = &packet;     // Nur im WORKER-Kontext verfügbar
+    dispatchEvent(&eventData, EspNowDispatch::WORKER);
+    
+    // Vollständig von Abonnenten verarbeitet → kein Result für Main-Thread
+    if (consumed) {
+        return;
+    }
+    
+    // Daten für Main-Thread aufbereiten
+    ResultQueueItem result;
+    packetToResult(mac, packet, result);
+    if (jitterTaken || motorConsumed || motorForeign) {
+        result.data.hasMotor = false;   // Ausgabe über getMotorCommand() bzw. Abonnent
+    } else if (result.data.hasMotor) {
+        // Ohne Jitter-Buffer: neuesten Befehl direkt für Echtzeit-Leser ablegen
+        EspNowMotorCommand command = {};
+        memcpy(command.mac, mac, 6);
+        command.left = result.data.motorLeft;
+        command.right = result.data.motorRight;
+        bool hasSeq = packet.getUInt16(DataCmd::SEQUENCE, command.seq);
+        command.playoutUs = micros();
         
-        // In Result-Queue für Main-Thread
-        if (xQueueSend(resultQueue, &result, pdMS_TO_TICKS(10)) != pdTRUE) {
-            DEBUG_PRINTLN("EspNowManager: ⚠️ Result-Queue voll!");
+        // Älterer Befehl desselben Absenders (Reorder, späte FEC-Rekonstruktion)
+        // darf den neueren nicht überschreiben
+        bool stale = hasSeq && motorSeqValid && memcmp(motorCommand.mac, mac, 6) == 0 &&
+                     static_cast<int16_t>(command.seq - motorCommand.seq) <= 0;
+        if (stale) {
+            result.data.hasMotor = false;
+        } else {
+            storeMotorCommand(command);
+            motorSeqValid = hasSeq;
         }
     }
+    
+    // In Result-Queue für Main-Thread
+    if (xQueueSend(resultQueue, &result, pdMS_TO_TICKS(10)) != pdTRUE) {
+        DEBUG_PRINTLN("EspNowManager: ⚠️ Result-Queue voll!");
+    }
 }
 
 void EspNowManager::processTxQueue() {
     TxQueueItem txItem;
     
-    // Alle verfügbaren TX-Items senden
-    while (xQueueReceive(txQueue, &txItem, 0) == pdTRUE) {
+    // Unvollständige FEC-Gruppen nach ESPNOW_FEC_FLUSH_MS abschließen: Parity
+    // über die Lane der Gruppe (Token-Bucket, Lane-Statistik, Treiber-Slot),
+    // bei voller Lane-Queue oder belegtem Buffer-Kontingent im nächsten Durchlauf
+    if (fecEnabled && xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        unsigned long now = millis();
+        for (auto& peer : peers) {
+            if (!peer.fec || peer.fec->txIndex == 0 ||
+                (now - peer.fec->txFirstMs) < ESPNOW_FEC_FLUSH_MS) {
+                continue;
+            }
+            int laneIdx = static_cast<int>(peer.fec->txLane);
+            if (uxQueueSpacesAvailable(txQueues[laneIdx]) == 0 ||
+                txLaneBuffers[laneIdx].load() >= ESPNOW_TX_LANE_BUFFERS) {
+                continue;
+            }
+            fecBuildParity(*peer.fec, txParity);
+            int buffer = allocTxBuffer(txParity, 1, peer.fec->txLane);
+            if (buffer >= 0 && !enqueueDescriptor(peer.mac, buffer, peer.fec->txLane, true)) {
+                releaseTxBuffer(buffer);
+            }
+        }
+        xSemaphoreGive(peersMutex);
+    }
+    
+    // Strikte Priorität: vor jedem Frame wieder bei CONTROL beginnen
+    while (dequeueTx(txItem)) {
+        transmitTx(txItem);
+    }
+}
+
+bool EspNowManager::dequeueTx(TxQueueItem& item) {
+    for (int lane = 0; lane < ESPNOW_LANE_COUNT; lane++) {
+        if (!txQueues[lane]) continue;
         
-        esp_err_t result = esp_now_send(txItem.mac, txItem.data, txItem.length);
+        // Ziele ohne Token in diesem Durchlauf: ihre späteren Frames bleiben
+        // dahinter (Reihenfolge pro Peer), andere Peers werden nicht blockiert
+        uint8_t blocked[ESPNOW_TX_HELD_SIZE][6];
+        int blockedCount = 0;
         
-        // Statistik aktualisieren
-        if (!txItem.broadcast && xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-            int index = findPeerIndex(txItem.mac);
-            if (index >= 0) {
-                peers[index].packetsSent++;
+        // Zuerst zurückgestellte Frames (älter als alles in der Queue)
+        TxQueueItem* held = txHeld[lane];
+        for (int i = 0; i < txHeldCount[lane]; i++) {
+            if (!macInList(blocked, blockedCount, held[i].mac) && consumeToken(held[i])) {
+                item = held[i];
+                memmove(&held[i], &held[i + 1], (txHeldCount[lane] - i - 1) * sizeof(TxQueueItem));
+                txHeldCount[lane]--;
+                return true;
+            }
+            if (!macInList(blocked, blockedCount, held[i].mac)) {
+                memcpy(blocked[blockedCount++], held[i].mac, 6);
             }
-            xSemaphoreGive(peersMutex);
         }
         
-        if (result != ESP_OK) {
-            DEBUG_PRINTF("EspNowManager: ⚠️ Senden fehlgeschlagen: %d\n", result);
+        // Dann die Queue: gedrosselte Köpfe zurückstellen (einmal gezählt),
+        // bis der Rückstellpuffer voll ist → erst dann wartet die ganze Lane
+        while (xQueuePeek(txQueues[lane], &item, 0) == pdTRUE) {
+            bool isBlocked = macInList(blocked, blockedCount, item.mac);
+            if (!isBlocked && consumeToken(item)) {
+                // Nur der Worker entnimmt → gepeektes Item ist das entnommene
+                xQueueReceive(txQueues[lane], &item, 0);
+                return true;
+            }
+            if (txHeldCount[lane] >= ESPNOW_TX_HELD_SIZE) break;
+            
+            xQueueReceive(txQueues[lane], &held[txHeldCount[lane]], 0);
+            txHeldCount[lane]++;
+            laneStats[lane].throttled++;
+            if (!isBlocked) {
+                memcpy(blocked[blockedCount++], item.mac, 6);
+            }
         }
     }
+    return false;
+}
+
+bool EspNowManager::macInList(const uint8_t (*list)[6], int count, const uint8_t* mac) {
+    for (int i = 0; i < count; i++) {
+        if (memcmp(list[i], mac, 6) == 0) return true;
+    }
+    return false;
+}
+
+bool EspNowManager::consumeToken(const TxQueueItem& item) {
+    int lane = static_cast<int>(item.lane);
+    const EspNowLaneConfig& config = laneConfig[lane];
+    if (config.rate == 0) return true;
+    
+    unsigned long nowUs = micros();
+    if (item.broadcast) {
+        return takeToken(broadcastBuckets[lane], config, nowUs);
+    }
+    
+    bool ok = true;
+    if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        int index = findPeerIndex(item.mac);
+        if (index >= 0) {
+            ok = takeToken(peers[index].buckets[lane], config, nowUs);
+        }
+        xSemaphoreGive(peersMutex);
+    }
+    return ok;
+}
+
+bool EspNowManager::takeToken(EspNowTokenBucket& bucket, const EspNowLaneConfig& config, unsigned long nowUs) {
+    // Auffüllen proportional zur vergangenen Zeit, gedeckelt auf Burst
+    bucket.tokens += (nowUs - bucket.lastUs) * (config.rate / 1000000.0f);
+    if (bucket.tokens > config.burst) bucket.tokens = config.burst;
+    bucket.lastUs = nowUs;
+    
+    if (bucket.tokens < 1.0f) return false;
+    bucket.tokens -= 1.0f;
+    return true;
+}
+
+void EspNowManager::transmitTx(TxQueueItem& txItem) {
+    // Unicast bekommt eine eigene Sequenznummer → Frame pro Ziel zusammensetzen,
+    // Broadcast geht direkt aus dem geteilten Buffer
+    const EspNowTxBuffer& txBuf = txPool[txItem.buffer];
+    uint8_t* frame = txFrame;
+    size_t length = txBuf.length;
+    const uint8_t* out = txBuf.data;
+    
+    // Virtuellen Peer bei Bedarf in Treiber-Tabelle laden (LRU-Swap)
+    bool sendParity = false;
+    bool commitCodec = false;
+    if (!txItem.broadcast && xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        int index = findPeerIndex(txItem.mac);
+        if (index >= 0) {
+            EspNowPeer& peer = peers[index];
+            if (!registerPeer(peer, true)) {
+                DEBUG_PRINTF("EspNowManager: ⚠️ Kein Treiber-Slot für %s\n", macToString(txItem.mac).c_str());
+            }
+            
+            // Fertiger Frame (Parity aus dem FEC-Flush): ohne Sequenz und FEC
+            if (!txItem.raw) {
+                peer.packetsSent++;
+                
+                // Sequenznummer für Verlust-Erkennung beim Empfänger
+                // [MAIN][LEN][SEQUENCE][2][seq] [Rest aus geteiltem Buffer]
+                uint16_t seq = peer.txSeq++;
+                if (length + 4 <= ESPNOW_MAX_PACKET_SIZE) {
+                    frame[0] = txBuf.data[0];
+                    frame[1] = static_cast<uint8_t>(txBuf.data[1] + 4);
+                    frame[2] = static_cast<uint8_t>(DataCmd::SEQUENCE);
+                    frame[3] = 2;
+                    memcpy(&frame[4], &seq, 2);
+                    memcpy(&frame[6], &txBuf.data[2], length - 2);
+                    length += 4;
+                } else {
+                    memcpy(frame, txBuf.data, length);
+                }
+                out = frame;
+                commitCodec = peer.txCodec != nullptr;
+                
+                // FEC nur für Nutzdaten (Heartbeat/Discovery sind ohnehin redundant)
+                MainCmd cmd = static_cast<MainCmd>(frame[0]);
+                if (fecEnabled && cmd != MainCmd::HEARTBEAT &&
+                    cmd != MainCmd::PAIR_REQUEST && cmd != MainCmd::PAIR_RESPONSE) {
+                    sendParity = fecProtect(peer, frame, length, txParity);
+                    if (peer.fec) peer.fec->txLane = txItem.lane;
+                }
+            }
+        }
+        xSemaphoreGive(peersMutex);
+    }
+    
+    esp_err_t result = sendFrame(txItem.mac, out, length);
+    
+    // Delta-Kontext des Ziels erst nach dem Senden fortschreiben (wie beim Empfänger)
+    if (commitCodec && result == ESP_OK && xSemaphoreTake(peersMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        int index = findPeerIndex(txItem.mac);
+        if (index >= 0 && peers[index].txCodec && txCommit.parse(out, length)) {
+            txCommit.commitCodec(*peers[index].txCodec);
+        }
+        xSemaphoreGive(peersMutex);
+    }
+    
+    // esp_now_send() kopiert → Referenz dieses Ziels freigeben
+    releaseTxBuffer(txItem.buffer);
+    
+    // Lane-Statistik (Queue-Latenz)
+    EspNowLaneStats& stats = laneStats[static_cast<int>(txItem.lane)];
+    uint32_t latencyUs = micros() - txItem.enqueueUs;
+    stats.sent++;
+    stats.totalLatencyUs += latencyUs;
+    if (latencyUs > stats.maxLatencyUs) stats.maxLatencyUs = latencyUs;
+    
+    if (result != ESP_OK) {
+        DEBUG_PRINTF("EspNowManager: ⚠️ Senden fehlgeschlagen: %d\n", result);
+    }
+    
+    // Parity direkt hinter dem letzten Frame der Gruppe
+    if (sendParity) {
+        sendFrame(txItem.mac, txParity.getRawData(), txParity.getTotalLength());
+    }
 }
 
 void EspNowManager::packetToResult(const uint8_t* mac, EspNowPacket& packet, ResultQueueItem& result) {
@@ -920,6 +3392,13 @@ void EspNowManager::packetToResult(const uint8_t* mac, EspNowPacket& packet, Res
         result.data.hasButtons = true;
     }
     
+    // Link-Telemetrie der Gegenseite
+    int8_t tempInt8;
+    if (packet.getInt8(DataCmd::RSSI, tempInt8)) {
+        result.data.rssi = tempInt8;
+        result.data.hasRssi = true;
+    }
+    
     // Raw-Daten für Custom-Commands
     if (packet.has(DataCmd::RAW_DATA)) {
         size_t rawLen;
@@ -947,15 +3426,12 @@ void EspNowManager::handleSendStatus(const uint8_t* mac, bool success) {
     eventData.success = success;
 
     if (success) {
-        eventData.event = EspNowEvent::SEND_SUCCESS;
-        triggerEvent(EspNowEvent::SEND_SUCCESS, &eventData);
+        postEvent(EspNowEvent::SEND_SUCCESS, &eventData);
     } else {
-        eventData.event = EspNowEvent::SEND_FAILED;
-        triggerEvent(EspNowEvent::SEND_FAILED, &eventData);
+        postEvent(EspNowEvent::SEND_FAILED, &eventData);
     }
 
-    eventData.event = EspNowEvent::DATA_SENT;
-    triggerEvent(EspNowEvent::DATA_SENT, &eventData);
+    postEvent(EspNowEvent::DATA_SENT, &eventData);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -1004,7 +3480,26 @@ void EspNowManager::update() {
     // Timeouts prüfen
     checkTimeouts();
     
-    // Result-Queue verarbeiten und Events triggern
+    // Geänderten Zustand senden (Delta bzw. Keyframe)
+    flushState(now);
+    
+    // Neue Zustands-Version melden
+    uint32_t version = stateVersion;
+    if (version != stateVersionSeen) {
+        stateVersionSeen = version;
+        EspNowEventData eventData = {};
+        eventData.event = EspNowEvent::STATE_UPDATED;
+        memcpy(eventData.mac, stateLastMac, 6);
+        triggerEvent(EspNowEvent::STATE_UPDATED, &eventData);
+    }
+    
+    // Events aus Worker/WiFi-Task zustellen
+    EspNowEventData queued;
+    while (eventQueue && xQueueReceive(eventQueue, &queued, 0) == pdTRUE) {
+        dispatchEvent(&queued, EspNowDispatch::MAIN);
+    }
+    
+    // Result-Queue verarbeiten und Events triggern (WORKER-Abonnenten liefen bereits)
     ResultQueueItem result;
     while (xQueueReceive(resultQueue, &result, 0) == pdTRUE) {
         
@@ -1015,7 +3510,19 @@ void EspNowManager::update() {
             EspNowEventData eventData = {};
             eventData.event = EspNowEvent::PEER_CONNECTED;
             memcpy(eventData.mac, result.mac, 6);
-            triggerEvent(EspNowEvent::PEER_CONNECTED, &eventData);
+            dispatchEvent(&eventData, EspNowDispatch::MAIN);
+            continue;
+        }
+        
+        // Not-Aus-Event (Logging/UI, der Handler lief bereits)
+        if (result.mainCmd == MainCmd::EMERGENCY_STOP) {
+            DEBUG_PRINTF("EspNowManager: 🛑 Not-Aus von %s (Handler nach %lu µs)\n",
+                         macToString(result.mac).c_str(), stopStats.handlerLatencyUs);
+            
+            EspNowEventData eventData = {};
+            eventData.event = EspNowEvent::EMERGENCY_STOP;
+            memcpy(eventData.mac, result.mac, 6);
+            dispatchEvent(&eventData, EspNowDispatch::MAIN);
             continue;
         }
         
@@ -1024,7 +3531,7 @@ void EspNowManager::update() {
             EspNowEventData eventData = {};
             eventData.event = EspNowEvent::HEARTBEAT_RECEIVED;
             memcpy(eventData.mac, result.mac, 6);
-            triggerEvent(EspNowEvent::HEARTBEAT_RECEIVED, &eventData);
+            dispatchEvent(&eventData, EspNowDispatch::MAIN);
             continue;
         }
         
@@ -1033,13 +3540,19 @@ void EspNowManager::update() {
         eventData.event = EspNowEvent::DATA_RECEIVED;
         memcpy(eventData.mac, result.mac, 6);
         eventData.packet = nullptr;  // Packet nicht mehr verfügbar, Daten in result
-        triggerEvent(EspNowEvent::DATA_RECEIVED, &eventData);
+        dispatchEvent(&eventData, EspNowDispatch::MAIN);
     }
 }
 
 void EspNowManager::getQueueStats(int* rxPending, int* txPending, int* resultPending) {
     if (rxPending) *rxPending = rxQueue ? uxQueueMessagesWaiting(rxQueue) : 0;
-    if (txPending) *txPending = txQueue ? uxQueueMessagesWaiting(txQueue) : 0;
+    if (txPending) {
+        *txPending = 0;
+        for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+            *txPending += txHeldCount[i];
+            if (txQueues[i]) *txPending += uxQueueMessagesWaiting(txQueues[i]);
+        }
+    }
     if (resultPending) *resultPending = resultQueue ? uxQueueMessagesWaiting(resultQueue) : 0;
 }
 
@@ -1111,6 +3624,18 @@ void EspNowManager::printInfo() {
     DEBUG_PRINTF("Kanal:      %d\n", wifiChannel);
     DEBUG_PRINTF("Heartbeat:  %s (%dms)\n", heartbeatEnabled ? "AN" : "AUS", heartbeatInterval);
     DEBUG_PRINTF("Timeout:    %dms\n", timeoutMs);
+    DEBUG_PRINTF("Gruppen:    %lu fremde Frames verworfen\n", groupFiltered);
+    DEBUG_PRINTF("FEC:        %s (k=%d), %lu Parity, %lu rekonstruiert, %lu verloren\n",
+                 fecEnabled ? "AN" : "AUS", fecK, fecStats.paritySent,
+                 fecStats.recovered, fecStats.unrecoverable);
+    DEBUG_PRINTF("Zustand:    %s, %d Einträge, %lu Deltas / %lu Keyframes gesendet, Version %lu empfangen\n",
+                 stateSyncEnabled ? "Sync AN" : "Sync AUS", localStateCount,
+                 stateStats.deltasSent, stateStats.keyframesSent, stateVersion);
+    EspNowCodecStats cs;
+    EspNowPacket::getCodecStats(&cs);
+    DEBUG_PRINTF("Codec:      %lu kodiert (%ld Bytes gespart), %lu dekodiert, %lu Delta-Fehler\n",
+                 cs.entriesEncoded, (long)cs.rawBytes - (long)cs.encodedBytes,
+                 cs.entriesDecoded, cs.deltaMisses);
     DEBUG_PRINTLN("Protokoll:  [MAIN_CMD] [TOTAL_LEN] [SUB_CMD] [LEN] [DATA]...");
     
     // Queue-Statistiken
@@ -1118,21 +3643,65 @@ void EspNowManager::printInfo() {
     getQueueStats(&rxPending, &txPending, &resultPending);
     DEBUG_PRINTLN("\n─── Queues ────────────────────────────────────");
     DEBUG_PRINTF("RX-Queue:      %d / %d\n", rxPending, ESPNOW_RX_QUEUE_SIZE);
-    DEBUG_PRINTF("TX-Queue:      %d / %d\n", txPending, ESPNOW_TX_QUEUE_SIZE);
+    DEBUG_PRINTF("TX-Queue:      %d / %d\n", txPending, ESPNOW_TX_QUEUE_SIZE * ESPNOW_LANE_COUNT);
     DEBUG_PRINTF("Result-Queue:  %d / %d\n", resultPending, ESPNOW_RESULT_QUEUE_SIZE);
+    int poolInUse;
+    uint32_t poolExhausted;
+    getTxPoolStats(&poolInUse, &poolExhausted);
+    DEBUG_PRINTF("TX-Pool:       %d / %d (%lu erschöpft)\n", poolInUse, ESPNOW_TX_POOL_SIZE, poolExhausted);
     DEBUG_PRINTF("Worker-Task:   %s\n", workerRunning ? "✅ Läuft" : "❌ Gestoppt");
     
+    int suspended = 0;
+    uint32_t overruns = 0;
+    for (int i = 0; i < ESPNOW_MAX_SUBSCRIPTIONS; i++) {
+        if (!subscriptions[i].active) continue;
+        if (subscriptions[i].stats.suspended) suspended++;
+        overruns += subscriptions[i].stats.overruns;
+    }
+    DEBUG_PRINTF("Abonnements:   %d / %d (%d pausiert, %lu Überläufe, %lu verpasst)\n",
+                 subscriptionCount, ESPNOW_MAX_SUBSCRIPTIONS, suspended, overruns, subscriptionsDropped);
+    
+    int eventHandlers = 0;
+    for (const auto& slot : eventSlots) {
+        if (slot.active) eventHandlers++;
+    }
+    DEBUG_PRINTF("Event-Bus:     %d / %d Abonnenten, %lu verworfen\n",
+                 eventHandlers, ESPNOW_EVENT_MAX_HANDLERS, eventsDropped);
+    
+    DEBUG_PRINTLN("\n─── TX-Lanes ──────────────────────────────────");
+    const char* laneNames[ESPNOW_LANE_COUNT] = { "Control", "Telemetrie", "Bulk" };
+    for (int i = 0; i < ESPNOW_LANE_COUNT; i++) {
+        EspNowLaneStats ls;
+        getLaneStats(static_cast<EspNowLane>(i), &ls);
+        DEBUG_PRINTF("%-10s %lu ein / %lu gesendet / %lu verworfen / %lu gedrosselt, Latenz Ø %lu µs / max %lu µs\n",
+                     laneNames[i], ls.enqueued, ls.sent, ls.dropped, ls.throttled,
+                     ls.sent > 0 ? ls.totalLatencyUs / ls.sent : 0, ls.maxLatencyUs);
+    }
+    
     DEBUG_PRINTLN("\n─── Peers ─────────────────────────────────────");
     
     if (xSemaphoreTake(peersMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        DEBUG_PRINTF("Anzahl: %d / %d\n", peers.size(), ESPNOW_MAX_PEERS);
+        DEBUG_PRINTF("Anzahl: %d / %d (0 = unbegrenzt)\n", peers.size(), ESPNOW_MAX_PEERS);
+        DEBUG_PRINTF("Treiber:    %d / %d registriert (%d verschlüsselt)\n",
+                     hwPeerCount, ESPNOW_HW_PEER_SLOTS - 1, hwEncryptCount);
+        DEBUG_PRINTF("Swaps:      %lu ein / %lu verdrängt / %lu Fehler\n",
+                     swapStats.swapIns, swapStats.evictions, swapStats.failures);
+        if (swapStats.swapIns > 0) {
+            DEBUG_PRINTF("Swap-Zeit:  Ø %lu µs / max %lu µs\n",
+                         swapStats.totalSwapUs / swapStats.swapIns, swapStats.maxSwapUs);
+        }
         
         for (auto& peer : peers) {
             DEBUG_PRINTF("\n  MAC: %s\n", macToString(peer.mac).c_str());
             DEBUG_PRINTF("  Status:     %s\n", peer.connected ? "✅ Verbunden" : "❌ Getrennt");
+            DEBUG_PRINTF("  Treiber:    %s\n", peer.registered ? "registriert" : "virtuell");
             DEBUG_PRINTF("  LastSeen:   %lums ago\n", peer.lastSeen > 0 ? (millis() - peer.lastSeen) : 0);
             DEBUG_PRINTF("  RX/TX/Lost: %lu / %lu / %lu\n", 
-                         peer.packetsReceived, peer.packetsSent, peer.packetsLost);
+                         peer.packetsReceived, peer.packetsSent, peer.packetsLost + peer.rxLost);
+            DEBUG_PRINTF("  RSSI:       %d dBm (Ø %.1f, %d..%d)\n",
+                         peer.rssi, peer.rssiAvg, peer.rssiMin, peer.rssiMax);
+            DEBUG_PRINTF("  Qualität:   %d%% (Verlust %.1f%%)\n",
+                         calcLinkQuality(peer), peer.lossAvg * 100.0f);
         }
         
         xSemaphoreGive(peersMutex);
@@ -13,6 +13,30 @@
  * - Bidirektionale Kommunikation
  * - Heartbeat mit Timeout-Erkennung
  * - Callbacks + UI-Event-Integration
+ * - Virtuelle Peers: unbegrenzte logische Peer-Liste, LRU-Swapping
+ *   in der Treiber-Peer-Tabelle (max. 20 Einträge, davon 6 verschlüsselt)
+ * - Gruppen-Adressierung: ein Broadcast-Frame pro Gruppe statt N Unicasts
+ * - Link-Qualität pro Peer (RSSI-EWMA, Min/Max, Verlust über Sequenzlücken)
+ * - Optionale XOR-Parity-FEC: ein Parity-Frame pro k Frames, Empfänger
+ *   rekonstruiert einen verlorenen Frame pro Gruppe ohne Round-Trip
+ * - TX-Prioritäts-Lanes (Control/Telemetrie/Bulk) mit Token-Bucket pro Peer
+ * - Replizierter Zustand: Send-on-Change (Deltas) plus periodische Keyframes,
+ *   Empfänger hält pro Absender einen versionierten, konsistenten Snapshot
+ * - Kompakte Einträge: ZigZag-Varints, Deltas pro (Peer, DataCmd) und
+ *   Bit-Packing, beim Parsen transparent zu nativen Werten dekodiert
+ * - IMU-Batching: viele zeitgestempelte Samples pro Frame, Empfänger
+ *   entpackt in einen Ringpuffer pro Sensor (Samples mit Absender-MAC)
+ * - Jitter-Buffer für Motor-Befehle: Sortierung nach Sequenz, Ausgabe mit
+ *   fester Rate und adaptiver Verzögerung, Halten des letzten Werts bei Lücken,
+ *   veraltete Frames werden übersprungen; Motor-Befehle nur von einer Quelle
+ * - Not-Aus-Fast-Path: EMERGENCY_STOP wird direkt im Empfangs-Callback
+ *   erkannt und ruft den Handler ohne Queue auf, Sender wiederholt redundant
+ * - Abonnements pro DataCmd: Callback im Worker direkt nach dem Parsen,
+ *   mit Laufzeit-Budget und Überlauf-Erkennung
+ * - Event-Bus: mehrere Abonnenten pro Event, Inline-Callables ohne Heap,
+ *   Abmelde-Token, Zustellung im Main-Thread oder Worker, MAC-Filter
+ * - Frame-Taps: Mitschnitt aller RX/TX-Frames, Sende-Status und Events
+ *   direkt an der Treiber-Grenze (FlightRecorder, PacketCapture)
  */
 
 #ifndef ESP_NOW_MANAGER_H
@@ -28,6 +52,12 @@
 #include <freertos/semphr.h>
 #include <functional>
 #include <vector>
+#include <initializer_list>
+#include <atomic>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <esp_timer.h>
 #include "config.h"
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -35,7 +65,26 @@
 // ═══════════════════════════════════════════════════════════════════════════
 
 #ifndef ESPNOW_MAX_PEERS
-#define ESPNOW_MAX_PEERS        5       // Maximale Anzahl Peers
+#define ESPNOW_MAX_PEERS        0       // Maximale Anzahl logischer Peers (0 = unbegrenzt)
+#endif
+
+#ifndef ESPNOW_HW_PEER_SLOTS
+#define ESPNOW_HW_PEER_SLOTS    ESP_NOW_MAX_TOTAL_PEER_NUM      // Treiber-Peer-Tabelle (inkl. Broadcast)
+#endif
+
+#ifndef ESPNOW_HW_ENCRYPT_SLOTS
+#define ESPNOW_HW_ENCRYPT_SLOTS ESP_NOW_MAX_ENCRYPT_PEER_NUM    // Davon verschlüsselt
+#endif
+
+// Geteilte TX-Buffer (ein Buffer pro Paket, unabhängig von Zielanzahl, ~250 Bytes):
+// jede Lane belegt höchstens ESPNOW_TX_LANE_BUFFERS, damit eine volle Lane den
+// anderen keine Buffer wegnimmt; die Deskriptor-Queues sind davon unabhängig
+#ifndef ESPNOW_TX_LANE_BUFFERS
+#define ESPNOW_TX_LANE_BUFFERS  14      // Belegte Buffer pro Lane (Pakete, nicht Ziele)
+#endif
+
+#ifndef ESPNOW_TX_POOL_SIZE
+#define ESPNOW_TX_POOL_SIZE     (ESPNOW_LANE_COUNT * ESPNOW_TX_LANE_BUFFERS)
 #endif
 
 #ifndef ESPNOW_RX_QUEUE_SIZE
@@ -43,7 +92,36 @@
 #endif
 
 #ifndef ESPNOW_TX_QUEUE_SIZE
-#define ESPNOW_TX_QUEUE_SIZE    10      // Sende-Queue Größe
+#define ESPNOW_TX_QUEUE_SIZE    32      // Sende-Queue Größe (Deskriptoren à 16 Bytes, pro Lane)
+#endif
+
+#ifndef ESPNOW_TX_FANOUT_WAIT_MS
+#define ESPNOW_TX_FANOUT_WAIT_MS 50     // send() an viele Ziele: max. Wartezeit auf Platz in der Lane-Queue
+#endif
+
+#ifndef ESPNOW_TX_HELD_SIZE
+#define ESPNOW_TX_HELD_SIZE     4       // Zurückgestellte Frames gedrosselter Peers (pro Lane, im Worker)
+#endif
+
+// Token-Bucket pro Peer und Lane (Frames/s, 0 = unbegrenzt)
+// Standard ohne Drosselung; Anwendung aktiviert sie per Build-Flag oder setLaneRate()
+#ifndef ESPNOW_LANE_CONTROL_RATE
+#define ESPNOW_LANE_CONTROL_RATE     0
+#endif
+#ifndef ESPNOW_LANE_CONTROL_BURST
+#define ESPNOW_LANE_CONTROL_BURST    0
+#endif
+#ifndef ESPNOW_LANE_TELEMETRY_RATE
+#define ESPNOW_LANE_TELEMETRY_RATE   0
+#endif
+#ifndef ESPNOW_LANE_TELEMETRY_BURST
+#define ESPNOW_LANE_TELEMETRY_BURST  0
+#endif
+#ifndef ESPNOW_LANE_BULK_RATE
+#define ESPNOW_LANE_BULK_RATE        0
+#endif
+#ifndef ESPNOW_LANE_BULK_BURST
+#define ESPNOW_LANE_BULK_BURST       0
 #endif
 
 #ifndef ESPNOW_RESULT_QUEUE_SIZE
@@ -51,7 +129,7 @@
 #endif
 
 #ifndef ESPNOW_WORKER_STACK_SIZE
-#define ESPNOW_WORKER_STACK_SIZE 4096   // Worker-Task Stack
+#define ESPNOW_WORKER_STACK_SIZE 6144   // Worker-Task Stack (Pakete liegen im Manager, Rest für Callbacks)
 #endif
 
 #ifndef ESPNOW_WORKER_PRIORITY
@@ -82,6 +160,144 @@
 #define ESPNOW_CHANNEL          0       // WiFi-Kanal (0 = auto)
 #endif
 
+#define ESPNOW_GROUP_ALL        0       // Gruppe 0 = alle Geräte (kein GROUP_ID-Eintrag)
+
+#ifndef ESPNOW_LINK_EWMA_ALPHA
+#define ESPNOW_LINK_EWMA_ALPHA  0.1f    // Glättung für RSSI- und Verlust-Mittelwert
+#endif
+
+#ifndef ESPNOW_RSSI_FLOOR
+#define ESPNOW_RSSI_FLOOR       -90     // RSSI für Link-Qualität 0% (dBm)
+#endif
+
+#ifndef ESPNOW_RSSI_CEIL
+#define ESPNOW_RSSI_CEIL        -40     // RSSI für Link-Qualität 100% (dBm)
+#endif
+
+#ifndef ESPNOW_FEC_DEFAULT_K
+#define ESPNOW_FEC_DEFAULT_K    4       // Daten-Frames pro Parity-Frame
+#endif
+
+#ifndef ESPNOW_FEC_MAX_K
+#define ESPNOW_FEC_MAX_K        16      // Maximale Gruppengröße
+#endif
+
+#ifndef ESPNOW_FEC_MAX_FRAME
+#define ESPNOW_FEC_MAX_FRAME    240     // Größter geschützter Frame (Parity-Overhead 10 Byte)
+#endif
+
+#ifndef ESPNOW_FEC_FLUSH_MS
+#define ESPNOW_FEC_FLUSH_MS     30      // Unvollständige Gruppe nach x ms mit Parity abschließen
+#endif
+
+#ifndef ESPNOW_IMU_BATCH_MAX
+#define ESPNOW_IMU_BATCH_MAX     30     // Max. Samples pro Batch-Eintrag
+#endif
+
+#ifndef ESPNOW_IMU_BATCH_BYTES
+#define ESPNOW_IMU_BATCH_BYTES   200    // Max. Nutzdaten pro Batch (Rest für Header/Transport)
+#endif
+
+#ifndef ESPNOW_IMU_BATCH_DEADLINE_MS
+#define ESPNOW_IMU_BATCH_DEADLINE_MS 50 // Batch spätestens x ms nach erstem Sample senden
+#endif
+
+#ifndef ESPNOW_IMU_RING_SIZE
+#define ESPNOW_IMU_RING_SIZE     128    // Empfangs-Ringpuffer pro Sensor (Samples)
+#endif
+
+#ifndef ESPNOW_JITTER_SLOTS
+#define ESPNOW_JITTER_SLOTS      8      // Gepufferte Motor-Frames pro Peer
+#endif
+
+#ifndef ESPNOW_JITTER_PERIOD_MS
+#define ESPNOW_JITTER_PERIOD_MS  20     // Feste Ausgaberate (20ms = 50Hz)
+#endif
+
+#ifndef ESPNOW_JITTER_MIN_DELAY_MS
+#define ESPNOW_JITTER_MIN_DELAY_MS 5    // Minimale Pufferverzögerung
+#endif
+
+#ifndef ESPNOW_JITTER_MAX_DELAY_MS
+#define ESPNOW_JITTER_MAX_DELAY_MS 60   // Maximale Pufferverzögerung
+#endif
+
+#ifndef ESPNOW_JITTER_FACTOR
+#define ESPNOW_JITTER_FACTOR     3.0f   // Verzögerung = Faktor × geschätzter Jitter
+#endif
+
+#ifndef ESPNOW_ESTOP_REPEATS
+#define ESPNOW_ESTOP_REPEATS     4      // Gesendete Kopien pro Not-Aus
+#endif
+
+#ifndef ESPNOW_ESTOP_SPACING_MS
+#define ESPNOW_ESTOP_SPACING_MS  3      // Abstand der Wiederholungen (Zeit-Diversität)
+#endif
+
+#ifndef ESPNOW_ESTOP_DEDUP_MS
+#define ESPNOW_ESTOP_DEDUP_MS    1000   // Gleiche Stop-ID innerhalb x ms = Kopie
+#endif
+
+#ifndef ESPNOW_EVENT_MAX_HANDLERS
+#define ESPNOW_EVENT_MAX_HANDLERS 24    // Event-Abonnenten gesamt
+#endif
+
+#ifndef ESPNOW_EVENT_INLINE_SIZE
+#define ESPNOW_EVENT_INLINE_SIZE  16    // Inline-Speicher pro Event-Callable (Captures, Bytes)
+#endif
+
+#ifndef ESPNOW_MAX_FRAME_TAPS
+#define ESPNOW_MAX_FRAME_TAPS     2     // Gleichzeitige Frame-Taps (Mitschnitt)
+#endif
+
+#ifndef ESPNOW_EVENT_QUEUE_SIZE
+#define ESPNOW_EVENT_QUEUE_SIZE   16    // Events aus Worker/WiFi-Task → Main-Thread
+#endif
+
+#ifndef ESPNOW_MAX_SUBSCRIPTIONS
+#define ESPNOW_MAX_SUBSCRIPTIONS 16     // Gleichzeitige DataCmd-Abonnements
+#endif
+
+#ifndef ESPNOW_SUB_BUDGET_US
+#define ESPNOW_SUB_BUDGET_US     200    // Standard-Laufzeitbudget pro Abonnement-Callback
+#endif
+
+#ifndef ESPNOW_SUB_MAX_OVERRUNS
+#define ESPNOW_SUB_MAX_OVERRUNS  10     // Aufeinanderfolgende Überläufe bis Pausierung (0 = nie)
+#endif
+
+#ifndef ESPNOW_STATE_MAX_ENTRIES
+#define ESPNOW_STATE_MAX_ENTRIES 16     // Einträge im replizierten Zustand
+#endif
+
+#ifndef ESPNOW_STATE_MAX_VALUE
+#define ESPNOW_STATE_MAX_VALUE  8       // Max. Bytes pro Zustands-Eintrag
+#endif
+
+#ifndef ESPNOW_STATE_MAX_SOURCES
+#define ESPNOW_STATE_MAX_SOURCES 4      // Absender mit eigener Zustands-Tabelle (ältester wird ersetzt)
+#endif
+
+#ifndef ESPNOW_CODEC_MAX_FIELDS
+#define ESPNOW_CODEC_MAX_FIELDS  8      // Felder pro kompaktem Eintrag (z.B. 3 für x/y/z)
+#endif
+
+#ifndef ESPNOW_CODEC_MAX_STREAMS
+#define ESPNOW_CODEC_MAX_STREAMS 8      // Delta-Streams (DataCmds) pro Kontext
+#endif
+
+#ifndef ESPNOW_CODEC_ABS_INTERVAL
+#define ESPNOW_CODEC_ABS_INTERVAL 16    // Spätestens nach x Deltas ein Absolutwert (Resync nach Verlust)
+#endif
+
+#ifndef ESPNOW_CODEC_DECODE_SIZE
+#define ESPNOW_CODEC_DECODE_SIZE 250    // Dekodier-Puffer pro Empfangspaket (im Manager, setDecodeBuffer)
+#endif
+
+#ifndef ESPNOW_STATE_KEYFRAME_MS
+#define ESPNOW_STATE_KEYFRAME_MS 1000   // Vollständiger Zustand alle x ms (begrenzt Veralten nach Verlust)
+#endif
+
 // ═══════════════════════════════════════════════════════════════════════════
 // COMMAND ENUMS
 // ═══════════════════════════════════════════════════════════════════════════
@@ -98,6 +314,10 @@ enum class MainCmd : uint8_t {
     PAIR_REQUEST    = 0x05,     // Pairing-Anfrage
     PAIR_RESPONSE   = 0x06,     // Pairing-Antwort
     ERROR           = 0x07,     // Fehlermeldung
+    FEC_PARITY      = 0x08,     // XOR-Parity über eine FEC-Gruppe
+    EMERGENCY_STOP  = 0x09,     // Not-Aus (Fast-Path im Empfangs-Callback)
+    STATE_DELTA     = 0x0A,     // Geänderte Zustands-Einträge
+    STATE_KEYFRAME  = 0x0B,     // Vollständiger Zustand (ersetzt Empfänger-Tabelle)
     
     // User-Commands ab 0x10
     USER_START      = 0x10
@@ -141,6 +361,16 @@ enum class DataCmd : uint8_t {
     DISTANCE        = 0x50,     // uint16_t (mm)
     ACCELERATION    = 0x51,     // struct { int16_t x, y, z; }
     GYROSCOPE       = 0x52,     // struct { int16_t x, y, z; }
+    ACCEL_BATCH     = 0x53,     // IMU-Batch (EspNowImuBatcher), Beschleunigung
+    GYRO_BATCH      = 0x54,     // IMU-Batch (EspNowImuBatcher), Drehrate
+    
+    // Transport (0x60-0x6F, vom Manager verwaltet, immer erster Eintrag)
+    GROUP_ID        = 0x60,     // uint8_t (Ziel-Gruppe eines Broadcasts)
+    SEQUENCE        = 0x61,     // uint16_t (Sequenznummer pro Peer, Unicast)
+    FEC_INFO        = 0x62,     // EspNowFecInfo (Gruppe, Index, k)
+    FEC_DATA        = 0x63,     // XOR-Parity-Bytes (nur in FEC_PARITY)
+    PACKED          = 0x64,     // Kompakte Einträge (EspNowPacket::addPacked, beliebige Position)
+    STOP_ID         = 0x65,     // uint16_t (Not-Aus-Kennung, auch im ACK)
     
     // Custom (0xA0-0xFF)
     CUSTOM_1        = 0xA0,
@@ -149,6 +379,31 @@ enum class DataCmd : uint8_t {
     RAW_DATA        = 0xFF      // Beliebige Rohdaten
 };
 
+/**
+ * TX-Prioritäts-Lanes (strikte Priorität: CONTROL vor TELEMETRY vor BULK)
+ */
+enum class EspNowLane : uint8_t {
+    CONTROL     = 0,    // Steuerbefehle, Heartbeat, Discovery
+    TELEMETRY   = 1,    // Sensorwerte, Status (Standard)
+    BULK        = 2,    // Log-Export, große Datenmengen
+    COUNT       = 3
+};
+
+#define ESPNOW_LANE_COUNT   static_cast<int>(EspNowLane::COUNT)
+
+static_assert(ESPNOW_TX_POOL_SIZE >= ESPNOW_LANE_COUNT * ESPNOW_TX_LANE_BUFFERS,
+              "ESPNOW_TX_POOL_SIZE: volle Lanes würden den Pool für andere Lanes erschöpfen");
+static_assert(ESPNOW_TX_POOL_SIZE <= 255, "ESPNOW_TX_POOL_SIZE: Buffer-Index ist uint8_t");
+
+/**
+ * Kodierung kompakter Einträge
+ */
+enum class EspNowCodec : uint8_t {
+    VARINT      = 0,    // ZigZag-Varint pro Feld
+    DELTA       = 1,    // ZigZag-Varint der Differenz zum vorherigen Wert (braucht Kontext)
+    BITPACK     = 2     // Alle Felder mit gleicher Bitbreite (ZigZag) gepackt
+};
+
 // ═══════════════════════════════════════════════════════════════════════════
 // FORWARD DECLARATIONS
 // ═══════════════════════════════════════════════════════════════════════════
@@ -168,16 +423,36 @@ struct RxQueueItem {
     uint8_t data[ESPNOW_MAX_PACKET_SIZE];
     size_t length;
     unsigned long timestamp;
+    int8_t rssi;                            // RSSI aus rx_ctrl (dBm)
+};
+
+/**
+ * MAC-Adresse als Wert (für Ziel-Listen)
+ */
+struct EspNowMac {
+    uint8_t addr[6];
+};
+
+/**
+ * Geteilter TX-Buffer (Paket einmal kopiert, Referenz pro Ziel)
+ */
+struct EspNowTxBuffer {
+    std::atomic<uint8_t> refs;              // Offene Ziele (0 = frei)
+    uint8_t lane;                           // Kontingent (txLaneBuffers)
+    uint8_t length;
+    uint8_t data[ESPNOW_MAX_PACKET_SIZE];
 };
 
 /**
- * Zu sendendes Paket für Queue (Main → Worker → WiFi)
+ * Sende-Deskriptor für Queue (Main → Worker → WiFi)
  */
 struct TxQueueItem {
     uint8_t mac[6];
-    uint8_t data[ESPNOW_MAX_PACKET_SIZE];
-    size_t length;
+    uint8_t buffer;                         // Index im TX-Pool
     bool broadcast;
+    bool raw;                               // Fertiger Frame (FEC-Parity): ohne SEQUENCE/FEC senden
+    EspNowLane lane;                        // Prioritäts-Lane
+    unsigned long enqueueUs;                // Zeitpunkt Einreihen (micros)
 };
 
 /**
@@ -205,6 +480,9 @@ struct ResultQueueItem {
         uint8_t buttonState;
         bool hasButtons;
         
+        int8_t rssi;                        // Vom Absender gemeldeter RSSI
+        bool hasRssi;
+        
         // Raw-Daten für custom Commands
         uint8_t rawData[64];
         size_t rawDataLen;
@@ -213,10 +491,62 @@ struct ResultQueueItem {
     unsigned long timestamp;
 };
 
+// ═══════════════════════════════════════════════════════════════════════════
+// KOMPAKTE KODIERUNG (Varint / Delta / Bit-Packing)
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Delta-Stream eines DataCmd (letzter Wert + Referenzzähler)
+ */
+struct EspNowCodecStream {
+    DataCmd cmd;
+    bool valid;                 // last[] gültig
+    uint8_t ref;                // Referenzzähler des letzten Eintrags
+    uint8_t count;              // Anzahl Felder
+    uint8_t sinceAbs;           // Deltas seit letztem Absolutwert
+    int32_t last[ESPNOW_CODEC_MAX_FIELDS];
+};
+
+/**
+ * Delta-Kontext (Sender: pro Ziel, Empfänger: pro Peer im Manager)
+ */
+struct EspNowCodecContext {
+    EspNowCodecStream streams[ESPNOW_CODEC_MAX_STREAMS];
+    uint8_t streamCount;
+    
+    EspNowCodecContext() : streamCount(0) {}
+    
+    /**
+     * Stream suchen (optional anlegen, nullptr wenn voll)
+     */
+    EspNowCodecStream* find(DataCmd cmd, bool create);
+};
+
+/**
+ * Codec-Statistik (global, Zähler ohne Lock)
+ */
+struct EspNowCodecStats {
+    uint32_t entriesEncoded;    // Kodierte Einträge
+    uint32_t rawBytes;          // Größe als normale TLV-Einträge
+    uint32_t encodedBytes;      // Tatsächliche Größe (inkl. PACKED-Header)
+    uint32_t entriesDecoded;    // Dekodierte Einträge
+    uint32_t deltaMisses;       // Deltas ohne passende Referenz (verworfen)
+};
+
 // ═══════════════════════════════════════════════════════════════════════════
 // PAKET-KLASSE MIT BUILDER & PARSER
 // ═══════════════════════════════════════════════════════════════════════════
 
+/**
+ * Typisiertes Feld eines Paket-Templates (Offset der Nutzdaten im Buffer)
+ */
+template<typename T>
+struct EspNowField {
+    uint8_t offset;             // 0 = ungültig (Header belegt Offset 0..1)
+    
+    bool isValid() const { return offset != 0; }
+};
+
 /**
  * ESP-NOW Paket mit Builder-Pattern und Parser
  * 
@@ -290,10 +620,86 @@ public:
         return add(dataCmd, &data, sizeof(T));
     }
     
+    /**
+     * Kompakten Eintrag hinzufügen
+     * Aufeinanderfolgende kompakte Einträge teilen sich einen PACKED-Header.
+     * Der Empfänger sieht nach parse() normale Einträge mit nativer Breite
+     * (Pakete des Managers haben einen Dekodier-Puffer, siehe setDecodeBuffer).
+     * @param dataCmd Daten-Identifier
+     * @param fields Feldwerte
+     * @param count Anzahl Felder (1 bis ESPNOW_CODEC_MAX_FIELDS)
+     * @param width Native Feldbreite beim Empfänger (1, 2 oder 4 Byte)
+     * @param codec Kodierung (DELTA ohne Kontext fällt auf VARINT zurück)
+     * @param ctx Delta-Kontext des Ziels (nullptr = ohne Referenz); bleibt
+     *            unverändert, fortgeschrieben wird erst nach dem Senden
+     *            (commitCodec bzw. EspNowManager::addPacked)
+     * @return Referenz für Method-Chaining
+     */
+    EspNowPacket& addPacked(DataCmd dataCmd, const int32_t* fields, uint8_t count, uint8_t width,
+                            EspNowCodec codec = EspNowCodec::VARINT, EspNowCodecContext* ctx = nullptr);
+    
+    /**
+     * int16_t-Felder kompakt hinzufügen (Joystick-Achsen, IMU-Tripel)
+     */
+    EspNowPacket& addPackedInt16(DataCmd dataCmd, const int16_t* values, uint8_t count,
+                                 EspNowCodec codec = EspNowCodec::VARINT, EspNowCodecContext* ctx = nullptr);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // TEMPLATES (Layout einmal bauen, pro Zyklus nur Werte patchen)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    /**
+     * Feld mit fester Größe anlegen und Handle zurückgeben
+     * Beispiel (einmalig):
+     *   ctrl.begin(MainCmd::DATA_RESPONSE);
+     *   auto left  = ctrl.addField<int16_t>(DataCmd::MOTOR_LEFT);
+     *   auto right = ctrl.addField<int16_t>(DataCmd::MOTOR_RIGHT);
+     * pro Zyklus:
+     *   ctrl.set(left, l); ctrl.set(right, r); espnow.send(mac, ctrl);
+     * @return Handle (ungültig wenn kein Platz)
+     */
+    template<typename T>
+    EspNowField<T> addField(DataCmd dataCmd, const T& initial = T()) {
+        EspNowField<T> field = { 0 };
+        int before = entryCount;
+        size_t pos = writePos + 2;
+        add(dataCmd, &initial, sizeof(T));
+        if (entryCount > before) field.offset = static_cast<uint8_t>(pos);
+        return field;
+    }
+    
+    /**
+     * Feldwert in-place setzen (keine Neuserialisierung)
+     */
+    template<typename T>
+    void set(EspNowField<T> field, const T& value) {
+        if (field.offset) memcpy(&buffer[field.offset], &value, sizeof(T));
+    }
+    
+    /**
+     * Feldwert lesen
+     */
+    template<typename T>
+    T value(EspNowField<T> field) const {
+        T result = T();
+        if (field.offset) memcpy(&result, &buffer[field.offset], sizeof(T));
+        return result;
+    }
+    
     // ═══════════════════════════════════════════════════════════════════════
     // PARSER
     // ═══════════════════════════════════════════════════════════════════════
     
+    /**
+     * Puffer für dekodierte kompakte Einträge (native Breite) setzen
+     * Der Puffer gehört dem Aufrufer und bleibt über parse() hinweg gesetzt
+     * (Kopien des Pakets teilen ihn). Ohne Puffer werden kompakte Einträge
+     * nicht dekodiert und bleiben nur als PACKED-Eintrag sichtbar.
+     * @param buf Puffer (nullptr = keiner)
+     * @param size Größe, z.B. ESPNOW_CODEC_DECODE_SIZE
+     */
+    void setDecodeBuffer(uint8_t* buf, size_t size);
+    
     /**
      * Paket aus Rohdaten parsen
      * @param rawData Empfangene Rohdaten
@@ -302,6 +708,23 @@ public:
      */
     bool parse(const uint8_t* rawData, size_t len);
     
+    /**
+     * Kompakte Einträge mit Referenz gegen einen Delta-Kontext auflösen
+     * (nach parse(), vom Manager mit dem Kontext des Absenders aufgerufen)
+     */
+    void resolveDeltas(EspNowCodecContext& ctx);
+    
+    /**
+     * Delta-Kontext des Senders nach erfolgreichem Senden fortschreiben
+     * (gleiche Regeln wie beim Empfänger, der Kontext folgt dessen Stand)
+     */
+    void commitCodec(EspNowCodecContext& ctx);
+    
+    /**
+     * Enthält das Paket kompakte Einträge mit Referenz?
+     */
+    bool needsCodecContext() const { return hasCodecRefs; }
+    
     /**
      * Prüfen ob DataCmd vorhanden ist
      */
@@ -389,13 +812,19 @@ public:
      */
     int getEntryCount() const { return entryCount; }
     
+    /**
+     * Eintrag nach Index abrufen (inkl. dekodierter kompakter Einträge)
+     * @return false bei ungültigem Index
+     */
+    bool getEntry(int index, DataCmd* cmd, const uint8_t** data, size_t* len) const;
+    
     /**
      * Ist Paket gültig?
      */
     bool isValid() const { return valid; }
     
     /**
-     * Paket zurücksetzen
+     * Paket zurücksetzen (nur Status, Buffer wird nicht gelöscht)
      */
     void clear();
     
@@ -403,16 +832,29 @@ public:
      * Debug-Ausgabe
      */
     void print() const;
+    
+    /**
+     * Codec-Statistik abrufen (alle Pakete)
+     */
+    static void getCodecStats(EspNowCodecStats* stats);
 
 private:
     // Paket-Buffer
     uint8_t buffer[ESPNOW_MAX_PACKET_SIZE];
     
+    // Dekodierte Werte kompakter Einträge (native Breite, Puffer des Aufrufers)
+    uint8_t* decodeBuf;
+    size_t decodeSize;
+    size_t decodePos;
+    int packedEntry;        // Offener PACKED-Eintrag beim Bauen (-1 = keiner)
+    bool hasCodecRefs;
+    
     // Parsed Data Index (für schnellen Zugriff)
     struct DataEntry {
         DataCmd cmd;
-        uint8_t offset;     // Offset im Buffer (nach Header)
+        uint8_t offset;     // Offset im Buffer (nach Header) bzw. in decodeBuf
         uint8_t length;
+        bool decoded;       // Wert liegt in decodeBuf
     };
     static const int MAX_ENTRIES = 20;
     DataEntry entries[MAX_ENTRIES];
@@ -426,87 +868,557 @@ private:
     
     // Helper
     int findEntry(DataCmd cmd) const;
+    void decodePacked(EspNowCodecContext* ctx, bool emit = true);
+    bool appendDecoded(DataCmd cmd, const int32_t* values, uint8_t count, uint8_t width);
+    
+    static EspNowCodecStats codecStats;
 };
 
 // ═══════════════════════════════════════════════════════════════════════════
-// PEER-STRUKTUR
+// TX-LANES & TOKEN-BUCKET
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * Peer-Information
+ * Token-Bucket (Frames/s mit Burst)
  */
-struct EspNowPeer {
-    uint8_t mac[6];             // MAC-Adresse
-    bool connected;             // Verbindungsstatus
-    unsigned long lastSeen;     // Letzter Empfang (millis)
-    uint32_t packetsReceived;   // Empfangene Pakete
-    uint32_t packetsSent;       // Gesendete Pakete
-    uint32_t packetsLost;       // Verlorene Pakete
-    int8_t rssi;                // Signalstärke (falls verfügbar)
+struct EspNowTokenBucket {
+    float tokens;               // Verfügbare Frames
+    unsigned long lastUs;       // Letztes Auffüllen (micros)
+};
+
+/**
+ * Lane-Konfiguration
+ */
+struct EspNowLaneConfig {
+    uint16_t rate;              // Frames/s pro Peer (0 = unbegrenzt)
+    uint8_t burst;              // Maximale Token
+};
+
+/**
+ * Lane-Statistik
+ */
+struct EspNowLaneStats {
+    uint32_t enqueued;          // Eingereiht
+    uint32_t dropped;           // Verworfen (Queue voll)
+    uint32_t sent;              // An esp_now_send() übergeben
+    uint32_t throttled;         // Frames, die auf ein Token ihres Peers warten mussten
+    uint32_t totalLatencyUs;    // Summe Queue-Latenz (µs)
+    uint32_t maxLatencyUs;      // Maximale Queue-Latenz (µs)
+    uint8_t pending;            // Aktuell in der Queue (inkl. zurückgestellt)
 };
 
 // ═══════════════════════════════════════════════════════════════════════════
-// EVENT-SYSTEM
+// FEC (XOR-Parity)
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * ESP-NOW Event-Typen
+ * FEC-Eintrag in Daten- und Parity-Frames
  */
-enum class EspNowEvent : uint8_t {
-    NONE = 0,
-    DATA_RECEIVED,      // Daten empfangen
-    DATA_SENT,          // Daten gesendet (mit Status)
-    PEER_CONNECTED,     // Peer verbunden
-    PEER_DISCONNECTED,  // Peer getrennt (Timeout)
-    PEER_ADDED,         // Neuer Peer hinzugefügt
-    PEER_REMOVED,       // Peer entfernt
-    SEND_SUCCESS,       // Senden erfolgreich
-    SEND_FAILED,        // Senden fehlgeschlagen
-    HEARTBEAT_RECEIVED, // Heartbeat empfangen
-    HEARTBEAT_TIMEOUT   // Heartbeat-Timeout
+struct __attribute__((packed)) EspNowFecInfo {
+    uint8_t group;              // Gruppen-Nummer (rollierend)
+    uint8_t index;              // Index in der Gruppe (== k bei Parity)
+    uint8_t k;                  // Anzahl Daten-Frames der Gruppe
+    uint8_t lenXor;             // XOR der Frame-Längen (nur Parity)
 };
 
 /**
- * Event-Daten Struktur
+ * FEC-Zustand pro Peer (wird bei Bedarf angelegt)
  */
-struct EspNowEventData {
-    EspNowEvent event;          // Event-Typ
-    uint8_t mac[6];             // MAC des Peers
-    EspNowPacket* packet;       // Parsed Packet (nur bei DATA_RECEIVED)
-    bool success;               // Erfolg (bei SEND)
+struct EspNowFecState {
+    // Sender
+    uint8_t txGroup;            // Aktuelle Gruppe
+    uint8_t txIndex;            // Bereits gesendete Frames der Gruppe
+    uint8_t txMaxLen;           // Längster Frame der Gruppe
+    uint8_t txLenXor;           // XOR der Längen
+    unsigned long txFirstMs;    // Erster Frame der Gruppe (für Flush)
+    EspNowLane txLane;          // Lane des letzten Frames (Parity beim Flush)
+    uint8_t txParity[ESPNOW_FEC_MAX_FRAME];
+    
+    // Empfänger
+    bool rxValid;               // rxGroup gültig?
+    uint8_t rxGroup;            // Aktuelle Gruppe
+    uint32_t rxMask;            // Empfangene Indizes (Bitmaske)
+    uint8_t rxLenXor;           // XOR der empfangenen Längen
+    uint8_t rxParity[ESPNOW_FEC_MAX_FRAME];
 };
 
-// Callback-Typen
-typedef std::function<void(const uint8_t* mac, EspNowPacket& packet)> EspNowReceiveCallback;
-typedef std::function<void(const uint8_t* mac, bool success)> EspNowSendCallback;
-typedef std::function<void(EspNowEventData* eventData)> EspNowEventCallback;
+/**
+ * FEC-Statistik
+ */
+struct EspNowFecStats {
+    uint32_t protectedSent;     // Gesendete Frames mit FEC_INFO
+    uint32_t paritySent;        // Gesendete Parity-Frames
+    uint32_t recovered;         // Rekonstruierte Frames
+    uint32_t unrecoverable;     // Gruppen mit >1 Verlust
+};
 
 // ═══════════════════════════════════════════════════════════════════════════
-// HAUPTKLASSE
+// REPLIZIERTER ZUSTAND
 // ═══════════════════════════════════════════════════════════════════════════
 
-class EspNowManager {
-public:
-    /**
-     * Singleton-Instance abrufen
-     */
-    static EspNowManager& getInstance();
+/**
+ * Zustands-Eintrag (Wert eines DataCmd)
+ */
+struct EspNowStateEntry {
+    DataCmd cmd;                // Schlüssel
+    uint8_t len;                // Wertlänge
+    bool dirty;                 // Seit letztem Senden geändert (nur Sender)
+    uint16_t seq;               // Sequenz des Frames, der den Wert gesetzt hat (nur Empfänger)
+    uint8_t value[ESPNOW_STATE_MAX_VALUE];
+};
 
+/**
+ * Konsistenter Snapshot des empfangenen Zustands (eine Tabelle pro Absender)
+ */
+struct EspNowStateSnapshot {
+    uint32_t version;           // Erhöht pro angewendetem Delta/Keyframe (0 = noch nichts)
+    uint8_t mac[6];             // Absender (Schlüssel der Tabelle)
+    unsigned long lastUpdateMs; // Letztes Delta/Keyframe (millis)
+    unsigned long lastKeyframeMs;// Letzter Keyframe (millis, 0 = noch keiner)
+    uint16_t seq;               // Neueste angewendete Sequenz
+    bool seqValid;              // seq gültig (Unicast mit SEQUENCE)
+    uint8_t count;
+    EspNowStateEntry entries[ESPNOW_STATE_MAX_ENTRIES];
+    
     /**
-     * ESP-NOW initialisieren
-     * @param channel WiFi-Kanal (0 = auto)
-     * @return true bei Erfolg
+     * Wert als Template-Typ abrufen (nullptr wenn nicht vorhanden oder zu kurz)
      */
-    bool begin(uint8_t channel = ESPNOW_CHANNEL);
+    template<typename T>
+    const T* get(DataCmd cmd) const {
+        for (int i = 0; i < count; i++) {
+            if (entries[i].cmd == cmd) {
+                return entries[i].len >= sizeof(T) ? reinterpret_cast<const T*>(entries[i].value) : nullptr;
+            }
+        }
+        return nullptr;
+    }
+};
 
-    /**
-     * ESP-NOW beenden und aufräumen
-     */
-    void end();
+/**
+ * Statistik des replizierten Zustands
+ */
+struct EspNowStateStats {
+    uint32_t deltasSent;        // Gesendete Delta-Frames
+    uint32_t keyframesSent;     // Gesendete Keyframes
+    uint32_t entriesSent;       // Gesendete Einträge (Deltas + Keyframes)
+    uint32_t unchanged;         // setState() ohne Änderung (kein Frame nötig)
+    uint32_t deltasReceived;    // Angewendete Deltas
+    uint32_t keyframesReceived; // Angewendete Keyframes
+    uint32_t staleReceived;     // Verspätete Frames (nur neuere Einträge übernommen)
+};
 
-    /**
-     * Ist ESP-NOW initialisiert?
-     */
+// ═══════════════════════════════════════════════════════════════════════════
+// JITTER-BUFFER (Motor-Befehle)
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Ausgegebener Motor-Befehl (feste Rate, Worker-Thread)
+ */
+struct EspNowMotorCommand {
+    uint8_t mac[6];             // Absender
+    int16_t left;               // -100 bis +100
+    int16_t right;              // -100 bis +100
+    uint16_t seq;               // Sequenznummer des Frames (bei Halten: letzter Frame)
+    bool held;                  // true = Frame fehlte, letzter Wert gehalten
+    unsigned long playoutUs;    // Ausgabezeitpunkt (micros)
+};
+
+/**
+ * Jitter-Buffer Statistik
+ */
+struct EspNowJitterStats {
+    uint32_t received;          // Eingereihte Frames
+    uint32_t played;            // Ausgegebene Frames
+    uint32_t late;              // Zu spät/doppelt (verworfen)
+    uint32_t underruns;         // Ausgabe ohne Frame (Wert gehalten)
+    uint32_t overflows;         // Puffer voll, ältester Frame verworfen
+    uint32_t skipped;           // Veraltet übersprungen (Sender schneller als Ausgabe)
+    uint32_t jitterUs;          // Geschätzter Ankunfts-Jitter (µs)
+    uint32_t delayUs;           // Aktuelle Pufferverzögerung (µs)
+    uint8_t depth;              // Aktuell gepufferte Frames
+};
+
+/**
+ * Gepufferter Motor-Frame
+ */
+struct EspNowJitterSlot {
+    uint16_t seq;
+    unsigned long arrivalUs;
+    int16_t left;
+    int16_t right;
+};
+
+/**
+ * Jitter-Buffer pro Peer (wird bei Bedarf angelegt)
+ */
+struct EspNowJitterBuffer {
+    EspNowJitterSlot slots[ESPNOW_JITTER_SLOTS];    // Aufsteigend nach Sequenz
+    uint8_t count;
+    bool started;               // Erster Frame ausgegeben
+    uint16_t lastSeq;           // Zuletzt ausgegebene Sequenz
+    bool hasArrival;
+    unsigned long lastArrivalUs;
+    uint16_t lastArrivalSeq;    // Sequenz des zuletzt angekommenen Frames
+    unsigned long nextPlayUs;   // Nächster Ausgabezeitpunkt
+    float intervalUs;           // Mittlerer Sendeabstand pro Sequenzschritt (aus Ankünften)
+    float jitterUs;             // Jitter-Schätzung (RFC 3550)
+    int16_t left;               // Zuletzt ausgegebener Wert
+    int16_t right;
+    EspNowJitterStats stats;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NOT-AUS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Not-Aus-Statistik (Latenzen in µs)
+ */
+struct EspNowStopStats {
+    uint32_t sent;              // Gesendete Not-Aus (ohne Wiederholungen)
+    uint32_t copiesSent;        // Gesendete Kopien
+    uint32_t sendLatencyUs;     // sendEmergencyStop() → erste Kopie an Treiber übergeben
+    uint32_t received;          // Empfangene Not-Aus (ohne Kopien)
+    uint32_t duplicates;        // Empfangene redundante Kopien
+    uint32_t handlerLatencyUs;  // Empfangs-Callback → Handler-Aufruf (letzter)
+    uint32_t maxHandlerLatencyUs;
+    uint32_t handlerDurationUs; // Laufzeit des Handlers (letzter)
+    uint32_t acks;              // Empfangene Bestätigungen
+    uint32_t ackRttUs;          // Senden → ACK (letzter, Round-Trip)
+    uint32_t maxAckRttUs;
+};
+
+// Not-Aus-Handler: läuft im WiFi-Task (Empfangs-Callback)! Kurz halten,
+// nicht blockieren, keine Mutexe, kein Serial/SD.
+typedef void (*EspNowStopHandler)(const uint8_t* mac, uint16_t stopId);
+
+/**
+ * Art eines mitgeschnittenen Vorgangs
+ */
+enum class EspNowTapKind : uint8_t {
+    RX = 0,             // Empfangener Frame (info = RSSI)
+    TX,                 // An den Treiber übergebener Frame (info = 0 OK, -1 Fehler)
+    TX_STATUS,          // Sende-Bestätigung ohne Daten (info = 1 Erfolg, 0 Fehler)
+    EVENT               // Event (data[0] = EspNowEvent, info = success)
+};
+
+// Frame-Tap: läuft im WiFi-Task (RX, TX_STATUS), im Worker (TX) bzw. im
+// auslösenden Task (EVENT)! Nur kopieren, nicht blockieren, kein Serial/SD.
+typedef void (*EspNowFrameTap)(EspNowTapKind kind, const uint8_t* mac,
+                               const uint8_t* data, size_t len, int8_t info);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PEER-STRUKTUR
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Peer-Information
+ */
+struct EspNowPeer {
+    uint8_t mac[6];             // MAC-Adresse
+    bool connected;             // Verbindungsstatus
+    unsigned long lastSeen;     // Letzter Empfang (millis)
+    uint32_t packetsReceived;   // Empfangene Pakete
+    uint32_t packetsSent;       // Gesendete Pakete
+    uint32_t packetsLost;       // Verlorene Pakete
+    int8_t rssi;                // Signalstärke letzter Frame (dBm)
+    
+    // Link-Qualität
+    float rssiAvg;              // RSSI-EWMA (dBm)
+    int8_t rssiMin;             // Minimaler RSSI
+    int8_t rssiMax;             // Maximaler RSSI
+    float lossAvg;              // Verlustrate-EWMA pro erwartetem Frame (0.0 - 1.0)
+    uint32_t rxLost;            // Fehlende Frames (Sequenzlücken)
+    uint16_t txSeq;             // Nächste Sende-Sequenznummer
+    uint16_t rxSeq;             // Letzte empfangene Sequenznummer
+    bool rxSeqValid;            // rxSeq gültig?
+    EspNowFecState* fec;        // FEC-Zustand (nullptr = noch nicht benutzt)
+    EspNowCodecContext* codec;  // Delta-Kontext Empfang (nullptr = noch nicht benutzt)
+    EspNowCodecContext* txCodec;    // Delta-Kontext Senden (addPacked, nach dem Senden fortgeschrieben)
+    EspNowJitterBuffer* jitter; // Jitter-Buffer (nullptr = noch nicht benutzt)
+    EspNowTokenBucket buckets[ESPNOW_LANE_COUNT];   // Rate-Limit pro Lane
+    
+    // Virtuelle Peers (Treiber-Tabelle)
+    bool encrypt;               // Verschlüsselung gewünscht
+    bool registered;            // Aktuell in der Treiber-Peer-Tabelle
+    uint32_t lastUsed;          // LRU-Zähler (höher = kürzlich benutzt)
+};
+
+/**
+ * Link-Qualität eines Peers (Snapshot)
+ */
+struct EspNowLinkQuality {
+    int8_t rssi;                // Letzter RSSI (dBm)
+    int8_t rssiAvg;             // Geglätteter RSSI (dBm)
+    int8_t rssiMin;             // Minimum seit addPeer (dBm)
+    int8_t rssiMax;             // Maximum seit addPeer (dBm)
+    float lossRate;             // Geglättete Verlustrate (0.0 - 1.0)
+    uint32_t packetsReceived;   // Empfangene Frames
+    uint32_t packetsSent;       // Gesendete Frames
+    uint32_t packetsLost;       // Verloren (Sequenzlücken + Sendefehler)
+    uint8_t quality;            // Kombinierte Link-Qualität (0-100)
+    unsigned long lastSeen;     // Letzter Empfang (millis)
+};
+
+/**
+ * Statistik für das Swapping der Treiber-Peer-Tabelle
+ */
+struct EspNowSwapStats {
+    uint32_t swapIns;           // Peers in Treiber-Tabelle geladen
+    uint32_t evictions;         // Peers verdrängt (LRU)
+    uint32_t failures;          // esp_now_add_peer() fehlgeschlagen
+    uint32_t totalSwapUs;       // Summe Swap-Dauer (µs)
+    uint32_t maxSwapUs;         // Längster Swap (µs)
+    uint8_t registeredPeers;    // Aktuell registrierte Peers (ohne Broadcast)
+    uint8_t registeredEncrypted;// Davon verschlüsselt
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// EVENT-SYSTEM
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * ESP-NOW Event-Typen
+ */
+enum class EspNowEvent : uint8_t {
+    NONE = 0,
+    DATA_RECEIVED,      // Daten empfangen
+    DATA_SENT,          // Daten gesendet (mit Status)
+    PEER_CONNECTED,     // Peer verbunden
+    PEER_DISCONNECTED,  // Peer getrennt (Timeout)
+    PEER_ADDED,         // Neuer Peer hinzugefügt
+    PEER_REMOVED,       // Peer entfernt
+    SEND_SUCCESS,       // Senden erfolgreich
+    SEND_FAILED,        // Senden fehlgeschlagen
+    HEARTBEAT_RECEIVED, // Heartbeat empfangen
+    HEARTBEAT_TIMEOUT,  // Heartbeat-Timeout
+    STATE_UPDATED,      // Replizierter Zustand geändert (neue Version)
+    EMERGENCY_STOP      // Not-Aus empfangen (Handler lief bereits im Callback)
+};
+
+/**
+ * Event-Daten Struktur
+ */
+struct EspNowEventData {
+    EspNowEvent event;          // Event-Typ
+    uint8_t mac[6];             // MAC des Peers
+    EspNowPacket* packet;       // Parsed Packet (nur bei DATA_RECEIVED)
+    bool success;               // Erfolg (bei SEND)
+};
+
+// Callback-Typen
+typedef std::function<void(const uint8_t* mac, EspNowPacket& packet)> EspNowReceiveCallback;
+typedef std::function<void(const uint8_t* mac, bool success)> EspNowSendCallback;
+typedef std::function<void(const EspNowMotorCommand& command)> EspNowPlayoutCallback;
+typedef std::function<void(const uint8_t* mac, DataCmd cmd, const uint8_t* data, size_t len)> EspNowSubscriptionCallback;
+
+/**
+ * Zustellungs-Kontext eines Event-Abonnenten
+ */
+enum class EspNowDispatch : uint8_t {
+    MAIN = 0,   // Im Main-Thread via update() (Standard, UI/Logging)
+    WORKER      // Sofort im erzeugenden Task (Worker bzw. WiFi-Task, kurz halten!)
+};
+
+// Abmelde-Token (0 = ungültig)
+typedef uint32_t EspNowEventToken;
+
+/**
+ * Event-Callable mit festem Inline-Speicher (keine Heap-Allokation)
+ * Nimmt Funktionszeiger und Lambdas auf, deren Captures trivial kopierbar
+ * sind und in ESPNOW_EVENT_INLINE_SIZE Bytes passen (Prüfung zur Compile-Zeit).
+ */
+class EspNowEventHandler {
+public:
+    EspNowEventHandler() : invoker(nullptr) {}
+    EspNowEventHandler(std::nullptr_t) : invoker(nullptr) {}
+    
+    template<typename F, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<F>::type, EspNowEventHandler>::value>::type>
+    EspNowEventHandler(F callable) {
+        static_assert(sizeof(F) <= ESPNOW_EVENT_INLINE_SIZE,
+                      "Event-Callable zu groß: Captures verkleinern oder ESPNOW_EVENT_INLINE_SIZE erhöhen");
+        static_assert(alignof(F) <= alignof(void*), "Event-Callable: Ausrichtung nicht unterstützt");
+        static_assert(std::is_trivially_copyable<F>::value && std::is_trivially_destructible<F>::value,
+                      "Event-Callable: nur trivial kopierbare Captures (Zeiger, Zahlen)");
+        new (storage) F(callable);
+        invoker = &invoke<F>;
+    }
+    
+    void operator()(EspNowEventData* data) const {
+        if (invoker) invoker(storage, data);
+    }
+    
+    explicit operator bool() const { return invoker != nullptr; }
+
+private:
+    template<typename F>
+    static void invoke(const void* storage, EspNowEventData* data) {
+        (*const_cast<F*>(static_cast<const F*>(storage)))(data);
+    }
+    
+    alignas(void*) uint8_t storage[ESPNOW_EVENT_INLINE_SIZE];
+    void (*invoker)(const void* storage, EspNowEventData* data);
+};
+
+// Kompatibilität zu bestehendem Code
+typedef EspNowEventHandler EspNowEventCallback;
+
+/**
+ * Statistik eines DataCmd-Abonnements
+ */
+struct EspNowSubscriptionStats {
+    uint32_t calls;             // Aufrufe
+    uint32_t overruns;          // Aufrufe über dem Budget
+    uint32_t lastUs;            // Laufzeit letzter Aufruf
+    uint32_t maxUs;             // Längste Laufzeit
+    bool suspended;             // Pausiert nach ESPNOW_SUB_MAX_OVERRUNS Überläufen in Folge
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMU-BATCHING
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * IMU-Sample mit Zeitstempel (Zeitbasis des Senders)
+ */
+struct EspNowImuSample {
+    uint32_t timestampUs;       // micros() beim Sender
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+/**
+ * Sammelt IMU-Samples und kodiert sie als ein Batch-Eintrag
+ * 
+ * Format: [BASE_US 4B] [COUNT 1B] { [dt] [dx] [dy] [dz] } * COUNT
+ * dt = µs seit vorherigem Sample (Varint), dx/dy/dz = Differenz zum
+ * vorherigen Sample (ZigZag-Varint). Jeder Batch ist in sich geschlossen,
+ * ein verlorener Frame betrifft nur seine eigenen Samples.
+ * 
+ * Nicht thread-safe: ein Batcher pro Sensor-Task.
+ */
+class EspNowImuBatcher {
+public:
+    /**
+     * @param dataCmd DataCmd::ACCEL_BATCH oder DataCmd::GYRO_BATCH
+     * @param maxSamples Flush nach x Samples (max. ESPNOW_IMU_BATCH_MAX)
+     * @param deadlineMs Flush spätestens x ms nach dem ersten Sample
+     */
+    EspNowImuBatcher(DataCmd dataCmd, uint8_t maxSamples = ESPNOW_IMU_BATCH_MAX,
+                     uint32_t deadlineMs = ESPNOW_IMU_BATCH_DEADLINE_MS);
+    
+    /**
+     * Sample hinzufügen
+     * @return false wenn Batch voll (vorher flush aufrufen)
+     */
+    bool addSample(int16_t x, int16_t y, int16_t z, uint32_t timestampUs);
+    
+    /**
+     * Batch voll oder Deadline erreicht?
+     */
+    bool isDue() const;
+    
+    /**
+     * Anzahl gesammelter Samples
+     */
+    uint8_t getCount() const { return count; }
+    
+    /**
+     * Batch als Eintrag an Paket anhängen und zurücksetzen
+     * @return false wenn leer oder kein Platz im Paket
+     */
+    bool appendTo(EspNowPacket& packet);
+    
+    /**
+     * Batch als eigenes Paket über den Manager senden und zurücksetzen
+     * @param mac Ziel-MAC (nullptr = Broadcast)
+     * @param lane Prioritäts-Lane
+     * @return true wenn in Queue eingereiht
+     */
+    bool flush(const uint8_t* mac, EspNowLane lane = EspNowLane::TELEMETRY);
+    
+    /**
+     * Batch-Eintrag dekodieren
+     * @return Anzahl Samples (0 bei ungültigen Daten)
+     */
+    static int decode(const uint8_t* data, size_t len, EspNowImuSample* out, int maxSamples);
+
+private:
+    DataCmd cmd;
+    uint8_t maxSamples;
+    uint32_t deadlineMs;
+    
+    uint8_t buf[5 + ESPNOW_IMU_BATCH_BYTES];
+    size_t used;
+    uint8_t count;
+    bool full;
+    unsigned long firstMs;      // Erstes Sample (millis, für Deadline)
+    EspNowImuSample last;       // Vorheriges Sample (Delta-Basis)
+    
+    void reset();
+};
+
+/**
+ * Lock-freier Ringpuffer (Single Producer: Worker, Single Consumer: App)
+ * Jedes Sample trägt die MAC seines Absenders (Zeitstempel in dessen Zeitbasis).
+ * Bei vollem Puffer wird das neue Sample verworfen und gezählt.
+ */
+class EspNowImuRing {
+public:
+    EspNowImuRing() : head(0), tail(0), dropped(0) {}
+    
+    bool push(const uint8_t* mac, const EspNowImuSample& sample);
+    bool pop(EspNowImuSample& sample, uint8_t* mac = nullptr);
+    
+    /**
+     * Absender des nächsten Samples (nur Consumer)
+     * @return nullptr wenn leer
+     */
+    const uint8_t* peekMac() const;
+    
+    int available() const;
+    uint32_t getDropped() const { return dropped; }
+
+private:
+    struct Entry {
+        EspNowImuSample sample;
+        uint8_t mac[6];
+    };
+    
+    Entry samples[ESPNOW_IMU_RING_SIZE];
+    std::atomic<uint32_t> head;     // Nächste Schreibposition (Producer)
+    std::atomic<uint32_t> tail;     // Nächste Leseposition (Consumer)
+    uint32_t dropped;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HAUPTKLASSE
+// ═══════════════════════════════════════════════════════════════════════════
+
+class EspNowManager {
+public:
+    /**
+     * Singleton-Instance abrufen
+     */
+    static EspNowManager& getInstance();
+
+    /**
+     * ESP-NOW initialisieren
+     * @param channel WiFi-Kanal (0 = auto)
+     * @return true bei Erfolg
+     */
+    bool begin(uint8_t channel = ESPNOW_CHANNEL);
+
+    /**
+     * ESP-NOW beenden und aufräumen
+     */
+    void end();
+
+    /**
+     * Ist ESP-NOW initialisiert?
+     */
     bool isInitialized() const { return initialized; }
 
     // ═══════════════════════════════════════════════════════════════════════
@@ -514,7 +1426,11 @@ public:
     // ═══════════════════════════════════════════════════════════════════════
 
     /**
-     * Peer hinzufügen
+     * Peer hinzufügen (logisch)
+     * 
+     * Der Peer wird sofort in die Treiber-Tabelle eingetragen, falls ein Slot
+     * frei ist. Sonst erfolgt das Eintragen beim nächsten Senden (LRU-Swap).
+     * 
      * @param mac MAC-Adresse (6 Bytes)
      * @param encrypt Verschlüsselung aktivieren
      * @return true bei Erfolg
@@ -556,6 +1472,308 @@ public:
      */
     bool isPeerConnected(const uint8_t* mac);
 
+    /**
+     * Auto-Discovery aktivieren/deaktivieren
+     * Unbekannte Absender von PAIR_REQUEST/PAIR_RESPONSE/HEARTBEAT werden
+     * automatisch als logische Peers übernommen.
+     */
+    void setAutoDiscovery(bool enabled);
+
+    /**
+     * Discovery-Broadcast senden (PAIR_REQUEST an alle)
+     * @return true wenn in Queue eingereiht
+     */
+    bool sendDiscovery();
+
+    /**
+     * Swap-Statistiken der Treiber-Peer-Tabelle abrufen
+     */
+    void getSwapStats(EspNowSwapStats* stats);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // LINK-QUALITÄT
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Link-Qualität eines Peers abrufen (Thread-safe Snapshot)
+     * @param mac Peer-MAC
+     * @param out Ziel-Struktur
+     * @return true wenn Peer bekannt
+     */
+    bool getLinkQuality(const uint8_t* mac, EspNowLinkQuality* out);
+
+    /**
+     * Eigenen RSSI-Mittelwert für einen Peer als DataCmd::RSSI anhängen
+     * (Telemetrie an die Gegenseite)
+     * @return true wenn Peer bekannt und Eintrag hinzugefügt
+     */
+    bool addLinkTelemetry(EspNowPacket& packet, const uint8_t* mac);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // FEC (Forward Error Correction)
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * XOR-Parity-FEC für Unicast-Frames aktivieren/deaktivieren
+     * Nach je k Daten-Frames an einen Peer folgt ein Parity-Frame.
+     * Der Empfänger rekonstruiert damit einen verlorenen Frame pro Gruppe.
+     * @param enabled FEC an/aus
+     * @param k Daten-Frames pro Parity-Frame (2 bis ESPNOW_FEC_MAX_K)
+     */
+    void setFec(bool enabled, uint8_t k = ESPNOW_FEC_DEFAULT_K);
+
+    /**
+     * FEC-Statistik abrufen
+     */
+    void getFecStats(EspNowFecStats* stats);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // REPLIZIERTER ZUSTAND
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Zustands-Synchronisation konfigurieren (Sender)
+     * update() sendet geänderte Einträge als STATE_DELTA und alle
+     * keyframeMs den vollständigen Zustand als STATE_KEYFRAME.
+     * @param enabled Synchronisation an/aus
+     * @param mac Ziel-MAC (nullptr = Broadcast an alle)
+     * @param keyframeMs Keyframe-Intervall
+     * @param lane Prioritäts-Lane
+     */
+    void setStateSync(bool enabled, const uint8_t* mac = nullptr,
+                      uint32_t keyframeMs = ESPNOW_STATE_KEYFRAME_MS,
+                      EspNowLane lane = EspNowLane::CONTROL);
+
+    /**
+     * Zustands-Eintrag setzen (Sender)
+     * Nur bei geändertem Wert wird der Eintrag im nächsten Delta gesendet.
+     * @return false wenn Tabelle voll oder Wert zu groß
+     */
+    bool setState(DataCmd cmd, const void* data, size_t len);
+
+    /**
+     * Zustands-Eintrag setzen (Template)
+     */
+    template<typename T>
+    bool setState(DataCmd cmd, const T& value) {
+        return setState(cmd, &value, sizeof(T));
+    }
+
+    /**
+     * Konsistenten Snapshot des empfangenen Zustands abrufen (Thread-safe)
+     * Jeder Absender hat eine eigene Tabelle (bis ESPNOW_STATE_MAX_SOURCES).
+     * @param out Ziel
+     * @param mac Absender (nullptr = zuletzt aktualisierter Absender)
+     * @return true wenn von diesem Absender bereits ein Delta/Keyframe empfangen wurde
+     */
+    bool getStateSnapshot(EspNowStateSnapshot* out, const uint8_t* mac = nullptr);
+
+    /**
+     * Anzahl aller angewendeten Deltas/Keyframes über alle Absender (0 = noch nichts)
+     */
+    uint32_t getStateVersion() const { return stateVersion; }
+
+    /**
+     * Statistik des replizierten Zustands abrufen
+     */
+    void getStateStats(EspNowStateStats* stats);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // IMU-BATCHES (Empfang)
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Empfangene IMU-Samples aus dem Ringpuffer lesen (ein Leser pro Sensor)
+     * Ein Aufruf liefert nur Samples eines Absenders; wechselt der Absender,
+     * endet der Aufruf vorher (Rest beim nächsten Aufruf).
+     * @param type DataCmd::ACCEL_BATCH oder DataCmd::GYRO_BATCH
+     * @param out Ziel-Array
+     * @param maxCount Array-Größe
+     * @param mac Absender der gelesenen Samples (6 Bytes, optional)
+     * @return Anzahl gelesener Samples
+     */
+    int readImuSamples(DataCmd type, EspNowImuSample* out, int maxCount, uint8_t* mac = nullptr);
+
+    /**
+     * Anzahl wartender IMU-Samples
+     */
+    int getImuAvailable(DataCmd type);
+
+    /**
+     * Verworfene IMU-Samples (Ringpuffer voll)
+     */
+    uint32_t getImuDropped(DataCmd type);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // JITTER-BUFFER (Motor-Befehle)
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Jitter-Buffer für Motor-Befehle aktivieren/deaktivieren
+     * Unicast-Frames mit MOTOR_LEFT/MOTOR_RIGHT/MOTOR_ALL werden pro Peer
+     * nach Sequenz sortiert und im Worker mit fester Rate ausgegeben.
+     * Die Motor-Werte erscheinen dann nicht mehr im ResultQueueItem.
+     * Die Pufferverzögerung folgt dem gemessenen Ankunfts-Jitter; die Senderate
+     * wird aus den Ankunftsabständen geschätzt und muss nicht periodMs entsprechen.
+     * Sendet der Peer schneller als periodMs, werden veraltete Frames übersprungen.
+     * @param enabled An/aus
+     * @param periodMs Ausgabeperiode
+     */
+    void setJitterBuffer(bool enabled, uint16_t periodMs = ESPNOW_JITTER_PERIOD_MS);
+
+    /**
+     * Callback für jeden ausgegebenen Motor-Befehl (im Worker-Thread, feste Rate!)
+     */
+    void setPlayoutCallback(EspNowPlayoutCallback callback);
+
+    /**
+     * Zuletzt ausgegebenen Motor-Befehl lesen (lock-frei, beliebiger Thread)
+     * Ohne Jitter-Buffer: zuletzt empfangener Befehl (direkt aus dem Worker).
+     * @return false wenn noch kein Befehl ausgegeben wurde
+     */
+    bool getMotorCommand(EspNowMotorCommand* out);
+
+    /**
+     * Jitter-Buffer Statistik eines Peers abrufen
+     * @return false wenn Peer unbekannt oder kein Jitter-Buffer aktiv
+     */
+    bool getJitterStats(const uint8_t* mac, EspNowJitterStats* out);
+    
+    /**
+     * Quelle der Motor-Befehle festlegen (Jitter-Buffer, getMotorCommand, Result-Queue)
+     * Motor-Einträge anderer Absender werden verworfen und gezählt.
+     * @param mac Gekoppelter Controller, nullptr = ersten bekannten Absender übernehmen,
+     *            FF:FF:FF:FF:FF:FF = alle bekannten Peers (jeweils neuester Befehl gilt)
+     */
+    void setMotorSource(const uint8_t* mac);
+    
+    /**
+     * Aktuelle Motor-Quelle lesen
+     * @return false wenn noch keine festgelegt oder übernommen
+     */
+    bool getMotorSource(uint8_t* mac);
+    
+    /**
+     * Verworfene Motor-Befehle fremder Absender
+     */
+    uint32_t getMotorRejected();
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // NOT-AUS (Fast-Path ohne Queues)
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Not-Aus-Handler registrieren
+     * Wird direkt im ESP-NOW Empfangs-Callback aufgerufen (vor jeder Queue).
+     * Redundante Kopien desselben Not-Aus lösen ihn nur einmal aus.
+     */
+    void setEmergencyStopHandler(EspNowStopHandler handler);
+
+    /**
+     * Not-Aus senden (umgeht die TX-Queues)
+     * Die erste Kopie geht sofort an den Treiber, weitere ESPNOW_ESTOP_REPEATS - 1
+     * Kopien folgen im Abstand von ESPNOW_ESTOP_SPACING_MS aus dem Worker.
+     * @param mac Ziel-MAC (nullptr = Broadcast an alle, unabhängig von Gruppen)
+     * @return true wenn die erste Kopie gesendet wurde
+     */
+    bool sendEmergencyStop(const uint8_t* mac = nullptr);
+
+    /**
+     * Wurde ein Not-Aus empfangen? (bleibt gesetzt bis clearEmergencyStop)
+     */
+    bool isEmergencyStopped() const { return emergencyStopped; }
+
+    /**
+     * Not-Aus-Zustand zurücksetzen (bewusste Freigabe durch die Anwendung)
+     */
+    void clearEmergencyStop();
+
+    /**
+     * Not-Aus-Statistik abrufen
+     */
+    void getStopStats(EspNowStopStats* stats);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // FRAME-TAPS (Mitschnitt an der Treiber-Grenze)
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Frame-Tap registrieren (max. ESPNOW_MAX_FRAME_TAPS)
+     * Sieht jeden empfangenen Frame vor allen Filtern, jeden an den Treiber
+     * übergebenen Frame (inkl. Parity und Not-Aus), Sende-Status und Events.
+     * @return false wenn kein Slot frei
+     */
+    bool addFrameTap(EspNowFrameTap tap);
+
+    /**
+     * Frame-Tap entfernen
+     */
+    void removeFrameTap(EspNowFrameTap tap);
+
+    // ═══════════════════════════════════════════════════════════════════════
+    // ABONNEMENTS (Worker-Kontext)
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * DataCmd abonnieren
+     * Der Callback läuft im Worker direkt nach dem Parsen (vor Result-Queue
+     * und packetToResult). Er muss innerhalb von budgetUs zurückkehren;
+     * Überschreitungen werden gezählt, nach ESPNOW_SUB_MAX_OVERRUNS in Folge
+     * wird das Abonnement pausiert (resumeSubscription).
+     * @param cmd Daten-Identifier
+     * @param callback Callback (Worker-Thread!)
+     * @param budgetUs Laufzeitbudget pro Aufruf
+     * @param consume true = Einträge gelten als verarbeitet; besteht ein Paket
+     *                nur aus verarbeiteten Einträgen, entfällt die Result-Queue;
+     *                verarbeitete Motor-Einträge gehen weder in den Jitter-Buffer
+     *                noch an getMotorCommand()
+     * @return Handle (> 0, mit Generation: nach unsubscribe() ungültig, auch
+     *         wenn der Slot neu vergeben wird) oder 0 wenn keine Slots frei
+     */
+    int subscribe(DataCmd cmd, EspNowSubscriptionCallback callback,
+                  uint32_t budgetUs = ESPNOW_SUB_BUDGET_US, bool consume = false);
+
+    /**
+     * Mehrere DataCmds mit einem Callback abonnieren
+     */
+    int subscribe(std::initializer_list<DataCmd> cmds, EspNowSubscriptionCallback callback,
+                  uint32_t budgetUs = ESPNOW_SUB_BUDGET_US, bool consume = false);
+
+    /**
+     * DataCmd mit typisiertem Wert abonnieren (zu kurze Einträge werden ignoriert)
+     */
+    template<typename T>
+    int subscribeValue(DataCmd cmd, std::function<void(const uint8_t* mac, const T& value)> callback,
+                       uint32_t budgetUs = ESPNOW_SUB_BUDGET_US, bool consume = false) {
+        return subscribe(cmd, [callback](const uint8_t* mac, DataCmd, const uint8_t* data, size_t len) {
+            if (len >= sizeof(T)) {
+                T value;
+                memcpy(&value, data, sizeof(T));
+                callback(mac, value);
+            }
+        }, budgetUs, consume);
+    }
+
+    /**
+     * Abonnement beenden (auch aus dem eigenen Callback möglich)
+     */
+    bool unsubscribe(int handle);
+
+    /**
+     * Pausiertes Abonnement fortsetzen
+     */
+    bool resumeSubscription(int handle);
+
+    /**
+     * Statistik eines Abonnements abrufen
+     */
+    bool getSubscriptionStats(int handle, EspNowSubscriptionStats* out);
+    
+    /**
+     * Pakete, die Abonnenten verpasst haben (Lock nicht rechtzeitig frei)
+     */
+    uint32_t getSubscriptionsDropped() const { return subscriptionsDropped; }
+
     // ═══════════════════════════════════════════════════════════════════════
     // DATEN SENDEN (Thread-safe, via Queue)
     // ═══════════════════════════════════════════════════════════════════════
@@ -564,21 +1782,89 @@ public:
      * Paket an Peer senden (async via Queue)
      * @param mac Ziel-MAC (nullptr = Broadcast)
      * @param packet Zu sendendes Paket
+     * @param lane Prioritäts-Lane
      * @return true wenn in Queue eingereiht
      */
-    bool send(const uint8_t* mac, const EspNowPacket& packet);
+    bool send(const uint8_t* mac, const EspNowPacket& packet, EspNowLane lane = EspNowLane::TELEMETRY);
+
+    /**
+     * Kompakten Eintrag mit dem Delta-Kontext des Ziels hinzufügen
+     * Der Kontext wird erst fortgeschrieben, wenn das Paket an dieses Ziel
+     * tatsächlich gesendet wurde (nicht gesendete Pakete stören den Empfänger nicht).
+     * @param mac Ziel-MAC (Peer muss existieren)
+     * @param packet Paket im Aufbau
+     * @param dataCmd Daten-Identifier
+     * @param fields Feldwerte
+     * @param count Anzahl Felder (1 bis ESPNOW_CODEC_MAX_FIELDS)
+     * @param width Native Feldbreite beim Empfänger (1, 2 oder 4 Byte)
+     * @param codec Kodierung
+     * @return true wenn der Eintrag geschrieben wurde
+     */
+    bool addPacked(const uint8_t* mac, EspNowPacket& packet, DataCmd dataCmd, const int32_t* fields,
+                   uint8_t count, uint8_t width, EspNowCodec codec = EspNowCodec::DELTA);
+    
+    /**
+     * Paket an mehrere Peers senden (ein Buffer, ein Deskriptor pro Ziel)
+     * Abschluss pro Ziel über Sende-Callback bzw. SEND_SUCCESS/SEND_FAILED.
+     * Mehr Ziele als Platz in der Lane-Queue: wartet bis ESPNOW_TX_FANOUT_WAIT_MS
+     * auf den Worker (nicht aus dem Worker selbst, dort nur so viele wie Platz ist).
+     * @param macs Ziel-MACs
+     * @param packet Zu sendendes Paket (wird genau einmal kopiert)
+     * @param lane Prioritäts-Lane
+     * @return Anzahl eingereihter Ziele
+     */
+    int send(std::span<const EspNowMac> macs, const EspNowPacket& packet,
+             EspNowLane lane = EspNowLane::TELEMETRY);
 
     /**
-     * Paket an alle Peers senden
+     * Paket als ein Broadcast-Frame an eine Gruppe senden
+     * @param packet Zu sendendes Paket
+     * @param groupId Ziel-Gruppe (ESPNOW_GROUP_ALL = alle Geräte)
+     * @param lane Prioritäts-Lane
      * @return true wenn in Queue eingereiht
      */
-    bool broadcast(const EspNowPacket& packet);
+    bool broadcast(const EspNowPacket& packet, uint8_t groupId = ESPNOW_GROUP_ALL,
+                   EspNowLane lane = EspNowLane::TELEMETRY);
+
+    /**
+     * Rate-Limit einer Lane setzen (gilt pro Peer, Broadcast zählt als ein Peer)
+     * Standard: alle Lanes unbegrenzt (ESPNOW_LANE_*_RATE), z.B. BULK mit
+     * setLaneRate(EspNowLane::BULK, 50, 5) drosseln, damit CONTROL Vorrang behält
+     * @param lane Lane
+     * @param rate Frames/s (0 = unbegrenzt)
+     * @param burst Maximale Frames am Stück
+     */
+    void setLaneRate(EspNowLane lane, uint16_t rate, uint8_t burst);
+
+    /**
+     * Lane-Statistik abrufen
+     */
+    void getLaneStats(EspNowLane lane, EspNowLaneStats* stats);
 
     /**
-     * Heartbeat manuell senden
+     * Heartbeat manuell senden (ein Broadcast-Frame an alle)
      */
     void sendHeartbeat();
 
+    // ═══════════════════════════════════════════════════════════════════════
+    // GRUPPEN
+    // ═══════════════════════════════════════════════════════════════════════
+
+    /**
+     * Gruppe beitreten (Broadcasts an diese Gruppe werden angenommen)
+     */
+    void joinGroup(uint8_t groupId);
+
+    /**
+     * Gruppe verlassen
+     */
+    void leaveGroup(uint8_t groupId);
+
+    /**
+     * Mitglied einer Gruppe? (ESPNOW_GROUP_ALL immer true)
+     */
+    bool isGroupMember(uint8_t groupId) const;
+
     // ═══════════════════════════════════════════════════════════════════════
     // DATEN EMPFANGEN (Thread-safe, via Queue)
     // ═══════════════════════════════════════════════════════════════════════
@@ -632,15 +1918,33 @@ public:
     void setSendCallback(EspNowSendCallback callback);
 
     /**
-     * Event-Callback setzen (UI-Integration, im Main-Thread via update())
+     * Event abonnieren (mehrere Abonnenten pro Event möglich)
+     * @param event Event-Typ
+     * @param handler Callable (Inline-Speicher, kein Heap)
+     * @param dispatch MAIN = im Main-Thread via update(), WORKER = sofort im
+     *                 erzeugenden Task (Empfang/Senden: Worker bzw. WiFi-Task)
+     * @param mac Nur Events dieses Peers (nullptr = alle)
+     * @return Token für offEvent() oder 0 wenn keine Slots frei
+     */
+    EspNowEventToken onEvent(EspNowEvent event, EspNowEventHandler handler,
+                             EspNowDispatch dispatch = EspNowDispatch::MAIN,
+                             const uint8_t* mac = nullptr);
+
+    /**
+     * Einzelnen Abonnenten entfernen (auch aus dem eigenen Handler möglich)
      */
-    void onEvent(EspNowEvent event, EspNowEventCallback callback);
+    bool offEvent(EspNowEventToken token);
 
     /**
-     * Event-Callback entfernen
+     * Alle Abonnenten eines Events entfernen
      */
     void offEvent(EspNowEvent event);
 
+    /**
+     * Verworfene Main-Thread-Events (Event-Queue voll)
+     */
+    uint32_t getEventsDropped() const { return eventsDropped; }
+
     // ═══════════════════════════════════════════════════════════════════════
     // UPDATE & STATUS
     // ═══════════════════════════════════════════════════════════════════════
@@ -683,7 +1987,17 @@ public:
      */
     void getQueueStats(int* rxPending, int* txPending, int* resultPending);
 
+    /**
+     * TX-Pool-Statistik
+     * @param inUse Belegte Buffer
+     * @param exhausted Abgewiesene Pakete (Pool leer)
+     */
+    void getTxPoolStats(int* inUse, uint32_t* exhausted);
+
 private:
+    // Host-Tests (test/host/espnow_test.h) führen Worker-Schritte ohne Task aus
+    friend class EspNowManagerTest;
+    
     // Singleton
     EspNowManager();
     ~EspNowManager();
@@ -697,16 +2011,116 @@ private:
     // Peers (mit Mutex geschützt)
     std::vector<EspNowPeer> peers;
     SemaphoreHandle_t peersMutex;
+    
+    // Treiber-Peer-Tabelle (virtuelle Peers, mit peersMutex geschützt)
+    uint8_t hwPeerCount;            // Registrierte Unicast-Peers
+    uint8_t hwEncryptCount;         // Davon verschlüsselt
+    uint32_t lruClock;              // LRU-Zähler
+    EspNowSwapStats swapStats;
+    bool autoDiscovery;
+
+    // Gruppen-Mitgliedschaft (Bitmaske, 256 Gruppen)
+    uint32_t groupMask[8];
+    uint32_t groupFiltered;            // Verworfene Frames fremder Gruppen
+
+    // FEC
+    bool fecEnabled;
+    uint8_t fecK;
+    EspNowFecStats fecStats;
+
+    // Replizierter Zustand (mit stateMutex geschützt)
+    SemaphoreHandle_t stateMutex;
+    EspNowStateEntry localState[ESPNOW_STATE_MAX_ENTRIES];
+    uint8_t localStateCount;
+    EspNowStateSnapshot remoteStates[ESPNOW_STATE_MAX_SOURCES];    // Pro Absender (version 0 = frei)
+    uint32_t stateVersion;          // Summe der Versionen aller Absender
+    uint8_t stateLastMac[6];        // Absender des letzten Updates
+    EspNowStateStats stateStats;
+    bool stateSyncEnabled;
+    uint8_t stateTarget[6];
+    bool stateBroadcast;
+    uint32_t stateKeyframeMs;
+    EspNowLane stateLane;
+    unsigned long lastKeyframeSent;
+    uint32_t stateVersionSeen;      // Zuletzt per STATE_UPDATED gemeldete Version
+
+    // IMU-Batches (Worker schreibt, App liest)
+    EspNowImuRing accelRing;
+    EspNowImuRing gyroRing;
+
+    // Jitter-Buffer (Puffer mit peersMutex geschützt)
+    bool jitterEnabled;
+    uint32_t jitterPeriodUs;
+    EspNowPlayoutCallback playoutCallback;
+    EspNowMotorCommand motorCommand;        // Letzter Befehl (Seqlock)
+    bool motorSeqValid;                     // motorCommand.seq aus SEQUENCE (Reihenfolge prüfbar, nur Worker)
+    std::atomic<uint32_t> motorSeqlock;     // Ungerade = Schreiben läuft
+    std::atomic<uint64_t> motorSource;      // Erlaubter Absender (0 = ersten übernehmen)
+    uint32_t motorRejected;                 // Motor-Befehle fremder Absender (nur Worker)
+
+    // Not-Aus (Empfang im WiFi-Task, Senden aus App + Worker)
+    EspNowStopHandler stopHandler;
+    volatile bool emergencyStopped;
+    uint16_t lastStopId;                    // Letzter empfangener Not-Aus
+    uint8_t lastStopMac[6];
+    int64_t lastStopUs;
+    EspNowStopStats stopStats;              // Zähler ohne Lock (nur Statistik)
+    uint16_t stopTxId;                      // Kennung des letzten gesendeten Not-Aus
+    uint8_t stopTxMac[6];
+    volatile uint8_t stopRepeatsLeft;       // Ausstehende Wiederholungen (Worker)
+    int64_t stopTxUs;                       // Zeitpunkt erste Kopie
+    int64_t stopNextUs;                     // Nächste Wiederholung
+
+    // Frame-Taps (Zeiger-Schreiben ist atomar, Aufruf ohne Lock)
+    EspNowFrameTap frameTaps[ESPNOW_MAX_FRAME_TAPS];
+
+    // Abonnements (rekursiver Mutex: Callbacks dürfen unsubscribe aufrufen)
+    struct Subscription {
+        bool active;
+        uint8_t generation;                 // Schützt vor veralteten Handles
+        uint32_t mask[8];                   // DataCmd-Bitmaske
+        EspNowSubscriptionCallback callback;
+        uint32_t budgetUs;
+        bool consume;
+        uint8_t overrunStreak;
+        EspNowSubscriptionStats stats;
+    };
+    Subscription subscriptions[ESPNOW_MAX_SUBSCRIPTIONS];
+    int subscriptionCount;                  // Aktive Abonnements (Fast-Path ohne Lock)
+    volatile uint32_t subscriptionsDropped; // Pakete ohne Zustellung an Abonnenten
+    SemaphoreHandle_t subsMutex;
+
+    // TX-Lanes
+    EspNowLaneConfig laneConfig[ESPNOW_LANE_COUNT];
+    EspNowLaneStats laneStats[ESPNOW_LANE_COUNT];   // Zähler ohne Lock (nur Statistik)
+    EspNowTokenBucket broadcastBuckets[ESPNOW_LANE_COUNT];
+    
+    // Worker-eigene Pakete (nicht auf dem Worker-Stack)
+    EspNowPacket rxPackets[2];              // [0] Empfang, [1] FEC-rekonstruierter Frame
+    uint8_t rxDecodeBuf[2][ESPNOW_CODEC_DECODE_SIZE];   // Dekodierte Werte von rxPackets
+    EspNowPacket rxReply;                   // PAIR_RESPONSE, Not-Aus-ACK
+    EspNowPacket txParity;                  // FEC-Parity beim Senden
+    EspNowPacket txCommit;                  // Gesendeter Frame für den Delta-Kontext
+    uint8_t rxRecovered[ESPNOW_FEC_MAX_FRAME];
+    uint8_t txFrame[ESPNOW_MAX_PACKET_SIZE];
+
+    // Geteilte TX-Buffer (lock-frei über Referenzzähler)
+    EspNowTxBuffer txPool[ESPNOW_TX_POOL_SIZE];
+    std::atomic<uint8_t> txLaneBuffers[ESPNOW_LANE_COUNT];  // Belegte Buffer pro Lane
+    uint32_t txPoolExhausted;
 
     // Heartbeat
     bool heartbeatEnabled;
     uint32_t heartbeatInterval;
     uint32_t timeoutMs;
     unsigned long lastHeartbeatSent;
+    EspNowPacket heartbeatPacket;   // Template, einmalig gebaut
 
     // FreeRTOS Queues
     QueueHandle_t rxQueue;          // WiFi-Callback → Worker
-    QueueHandle_t txQueue;          // Main → Worker → WiFi
+    QueueHandle_t txQueues[ESPNOW_LANE_COUNT];  // Main → Worker → WiFi (pro Lane)
+    TxQueueItem txHeld[ESPNOW_LANE_COUNT][ESPNOW_TX_HELD_SIZE];  // Gedrosselte Köpfe (nur Worker)
+    uint8_t txHeldCount[ESPNOW_LANE_COUNT];
     QueueHandle_t resultQueue;      // Worker → Main
 
     // Worker Task
@@ -716,7 +2130,22 @@ private:
     // Callbacks
     EspNowReceiveCallback receiveCallback;
     EspNowSendCallback sendCallback;
-    EspNowEventCallback eventCallbacks[12];
+    
+    // Event-Bus (Mutex nur für die Slots, Handler laufen ohne Lock)
+    struct EventSlot {
+        bool active;
+        uint8_t generation;                 // Schützt vor veralteten Token
+        EspNowEvent event;
+        EspNowDispatch dispatch;
+        bool filterMac;
+        uint8_t mac[6];
+        EspNowEventHandler handler;
+    };
+    EventSlot eventSlots[ESPNOW_EVENT_MAX_HANDLERS];
+    uint32_t eventMask[2];                  // Events mit Abonnenten je Kontext (Fast-Path ohne Lock)
+    SemaphoreHandle_t eventMutex;
+    QueueHandle_t eventQueue;               // Worker/WiFi-Task → Main
+    volatile uint32_t eventsDropped;
 
     // Statische Callbacks für ESP-NOW
     static void onDataRecvStatic(const esp_now_recv_info_t* info, const uint8_t* data, int len);
@@ -726,14 +2155,74 @@ private:
     static void workerTask(void* parameter);
     void processRxQueue();
     void processTxQueue();
+    bool dequeueTx(TxQueueItem& item);
+    static bool macInList(const uint8_t (*list)[6], int count, const uint8_t* mac);
+    bool consumeToken(const TxQueueItem& item);
+    static bool takeToken(EspNowTokenBucket& bucket, const EspNowLaneConfig& config, unsigned long nowUs);
+    void transmitTx(TxQueueItem& item);
+    esp_err_t sendFrame(const uint8_t* mac, const uint8_t* data, size_t len);
+    void tapFrame(EspNowTapKind kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info);
+    void handleRxFrame(const uint8_t* mac, const uint8_t* data, size_t len,
+                       unsigned long timestamp, int8_t rssi, bool recovered);
 
     // Interne Methoden
+    bool enqueueTx(const uint8_t* mac, const EspNowPacket& packet, uint8_t groupId, EspNowLane lane);
+    bool enqueueDescriptor(const uint8_t* mac, uint8_t buffer, EspNowLane lane, bool raw = false);
+    int allocTxBuffer(const EspNowPacket& packet, uint8_t refs, EspNowLane lane);
+    void releaseTxBuffer(uint8_t buffer);
+    static bool insertEntry(uint8_t* frame, size_t& len, DataCmd cmd, const void* data, size_t dataLen);
     void handleSendStatus(const uint8_t* mac, bool success);
     void checkTimeouts();
-    void triggerEvent(EspNowEvent event, EspNowEventData* data);
+    void triggerEvent(EspNowEvent event, EspNowEventData* data);     // aus dem Main-Thread
+    void postEvent(EspNowEvent event, EspNowEventData* data);        // aus Worker/WiFi-Task
+    void dispatchEvent(EspNowEventData* data, EspNowDispatch dispatch);
+    void updateEventMask();
     int findPeerIndex(const uint8_t* mac);
     bool compareMac(const uint8_t* mac1, const uint8_t* mac2);
     
+    // Virtuelle Peers (peersMutex muss gehalten werden!)
+    EspNowPeer makePeer(const uint8_t* mac, bool encrypt);
+    bool registerPeer(EspNowPeer& peer, bool allowEvict);
+    void unregisterPeer(EspNowPeer& peer);
+    int findLruVictim(bool encrypted, const uint8_t* excludeMac);
+    
+    // Link-Qualität (peersMutex muss gehalten werden!)
+    void updateLinkStats(EspNowPeer& peer, int8_t rssi, const EspNowPacket& packet);
+    static uint8_t calcLinkQuality(const EspNowPeer& peer);
+    void releasePeer(EspNowPeer& peer);
+    
+    // FEC (peersMutex muss gehalten werden!)
+    bool fecProtect(EspNowPeer& peer, uint8_t* frame, size_t& len, EspNowPacket& parityOut);
+    void fecBuildParity(EspNowFecState& fec, EspNowPacket& parityOut);
+    bool fecReceive(EspNowPeer& peer, const EspNowPacket& packet, const uint8_t* data, size_t len,
+                    uint8_t* recoveredOut, size_t& recoveredLen);
+    
+    // Jitter-Buffer (peersMutex muss gehalten werden, außer processJitter/publishMotorCommand)
+    bool jitterPush(EspNowPeer& peer, const EspNowPacket& packet, unsigned long nowUs);
+    bool jitterPlayout(EspNowPeer& peer, unsigned long nowUs, EspNowMotorCommand& out);
+    void processJitter();
+    void publishMotorCommand(const EspNowMotorCommand& command);
+    void storeMotorCommand(const EspNowMotorCommand& command);
+    bool acceptMotorSource(const uint8_t* mac);
+    
+    // Abonnements (im Worker), motorConsumed: Motor-Eintrag von Abonnent verbraucht
+    bool dispatchSubscriptions(const uint8_t* mac, const EspNowPacket& packet, bool& motorConsumed);
+    Subscription* findSubscription(int handle);
+    
+    // Not-Aus
+    bool handleStopFast(const uint8_t* mac, const uint8_t* data, int len, int64_t rxUs);
+    bool transmitStop();
+    void processStopRepeats();
+    
+    // IMU-Batches
+    EspNowImuRing* imuRing(DataCmd type);
+    void unpackImuBatches(const uint8_t* mac, const EspNowPacket& packet);
+    
+    // Replizierter Zustand (stateMutex muss gehalten werden, außer flushState)
+    void flushState(unsigned long now);
+    EspNowStateSnapshot* findStateSource(const uint8_t* mac, bool create);
+    void applyState(const uint8_t* mac, const EspNowPacket& packet, bool keyframe);
+    
     // Paket zu Result konvertieren (im Worker-Thread)
     void packetToResult(const uint8_t* mac, EspNowPacket& packet, ResultQueueItem& result);
 };
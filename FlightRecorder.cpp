@@ -0,0 +1,360 @@
+/**
+ * FlightRecorder.cpp
+ *
+ * Implementation des Flight-Recorders
+ */
+
+#include "FlightRecorder.h"
+#include <esp_heap_caps.h>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+
+static_assert((FLIGHT_RECORDER_SLOTS & (FLIGHT_RECORDER_SLOTS - 1)) == 0, "FLIGHT_RECORDER_SLOTS muss eine Zweierpotenz sein");
+static_assert((FLIGHT_RECORDER_FALLBACK_SLOTS & (FLIGHT_RECORDER_FALLBACK_SLOTS - 1)) == 0, "FLIGHT_RECORDER_FALLBACK_SLOTS muss eine Zweierpotenz sein");
+static_assert(FLIGHT_RECORDER_CHUNK_SIZE >= sizeof(FlightRecordHeader) + ESPNOW_MAX_PACKET_SIZE, "FLIGHT_RECORDER_CHUNK_SIZE zu klein");
+static_assert(static_cast<int>(EspNowTapKind::RX) == FLIGHT_KIND_RX &&
+              static_cast<int>(EspNowTapKind::TX) == FLIGHT_KIND_TX &&
+              static_cast<int>(EspNowTapKind::TX_STATUS) == FLIGHT_KIND_TX_STATUS &&
+              static_cast<int>(EspNowTapKind::EVENT) == FLIGHT_KIND_EVENT, "FLIGHT_KIND_* passt nicht zu EspNowTapKind");
+
+FlightRecorder* FlightRecorder::instance = nullptr;
+
+FlightRecorder::FlightRecorder(SDCardHandler& sdCard)
+    : sd(sdCard)
+    , slots(nullptr)
+    , slotMask(0)
+    , inPsram(false)
+    , nextSeq(0)
+    , recordCycles(0)
+    , dumpHandle(nullptr)
+    , dumpRunning(false)
+    , dumpPending(false)
+    , dumpExited(nullptr)
+    , pendingTrigger(FLIGHT_TRIGGER_MANUAL)
+    , triggerUs(0)
+    , triggerSeq(0)
+    , nextDumpId(0)
+    , chunk(nullptr)
+    , disconnectToken(0)
+    , timeoutToken(0)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool FlightRecorder::begin() {
+    DEBUG_PRINTLN("FlightRecorder: Initialisiere...");
+    
+    if (slots) return true;
+    
+    // Ring bevorzugt im PSRAM, sonst klein im internen RAM
+    uint32_t count = FLIGHT_RECORDER_SLOTS;
+    slots = (FlightSlot*)heap_caps_calloc(count, sizeof(FlightSlot), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    inPsram = slots != nullptr;
+    if (!slots) {
+        count = FLIGHT_RECORDER_FALLBACK_SLOTS;
+        slots = (FlightSlot*)heap_caps_calloc(count, sizeof(FlightSlot), MALLOC_CAP_8BIT);
+        if (!slots) {
+            DEBUG_PRINTLN("FlightRecorder: ❌ Kein Speicher für den Ring!");
+            return false;
+        }
+        DEBUG_PRINTF("FlightRecorder: ⚠️ Kein PSRAM, nur %lu Slots im internen RAM\n", count);
+    }
+    slotMask = count - 1;
+    nextSeq = 0;
+    
+    chunk = new uint8_t[FLIGHT_RECORDER_CHUNK_SIZE];
+    scanDumps();
+    
+    if (!dumpExited) dumpExited = xSemaphoreCreateBinary();
+    if (!dumpExited) {
+        DEBUG_PRINTLN("FlightRecorder: ❌ Semaphore erstellen fehlgeschlagen!");
+        end();
+        return false;
+    }
+    
+    // Dump-Task mit niedriger Priorität (SD-Zugriff blockiert)
+    dumpRunning = true;
+    BaseType_t taskResult = xTaskCreatePinnedToCore(
+        dumpTask,                       // Task-Funktion
+        "FlightDump",                   // Name
+        FLIGHT_RECORDER_STACK_SIZE,     // Stack-Größe
+        this,                           // Parameter (this-Pointer)
+        FLIGHT_RECORDER_PRIORITY,       // Priorität
+        &dumpHandle,                    // Task-Handle
+        FLIGHT_RECORDER_CORE            // Core
+    );
+    
+    if (taskResult != pdPASS) {
+        DEBUG_PRINTLN("FlightRecorder: ❌ Dump-Task erstellen fehlgeschlagen!");
+        dumpRunning = false;
+        dumpHandle = nullptr;
+        end();
+        return false;
+    }
+    
+    // Am EspNowManager anmelden: alle Frames und Events, Dump bei Verbindungsverlust
+    instance = this;
+    EspNowManager& espnow = EspNowManager::getInstance();
+    espnow.addFrameTap(tap);
+    disconnectToken = espnow.onEvent(EspNowEvent::PEER_DISCONNECTED, [this](EspNowEventData*) {
+        trigger(FLIGHT_TRIGGER_PEER_DISCONNECTED);
+    }, EspNowDispatch::WORKER);
+    timeoutToken = espnow.onEvent(EspNowEvent::HEARTBEAT_TIMEOUT, [this](EspNowEventData*) {
+        trigger(FLIGHT_TRIGGER_HEARTBEAT_TIMEOUT);
+    }, EspNowDispatch::WORKER);
+    
+    DEBUG_PRINTF("FlightRecorder: ✅ %lu Slots (%lu KB %s)\n", count,
+                 (unsigned long)(count * sizeof(FlightSlot) / 1024), inPsram ? "PSRAM" : "RAM");
+    return true;
+}
+
+void FlightRecorder::end() {
+    EspNowManager& espnow = EspNowManager::getInstance();
+    espnow.removeFrameTap(tap);
+    if (disconnectToken) espnow.offEvent(disconnectToken);
+    if (timeoutToken) espnow.offEvent(timeoutToken);
+    disconnectToken = timeoutToken = 0;
+    if (instance == this) instance = nullptr;
+    
+    if (dumpHandle) {
+        dumpRunning = false;
+        xTaskNotifyGive(dumpHandle);
+        
+        // Laufenden Dump abschließen lassen, erst nach dem Task-Ende freigeben
+        dumpHandle = nullptr;
+        if (xSemaphoreTake(dumpExited, pdMS_TO_TICKS(FLIGHT_RECORDER_SHUTDOWN_WAIT_MS)) != pdTRUE) {
+            // Task schreibt noch (SD hängt): Ring und Puffer nicht freigeben
+            DEBUG_PRINTLN("FlightRecorder: ⚠️ Dump-Task beendet sich nicht, Speicher bleibt belegt");
+            return;
+        }
+    }
+    
+    heap_caps_free(slots);
+    slots = nullptr;
+    delete[] chunk;
+    chunk = nullptr;
+}
+
+bool FlightRecorder::trigger(FlightTrigger reason) {
+    if (!dumpHandle || !slots) return false;
+    
+    // Nur ein Dump gleichzeitig (mehrere Auslöser kommen oft zusammen)
+    if (dumpPending.exchange(true)) {
+        stats.triggersIgnored++;
+        return false;
+    }
+    
+    pendingTrigger = reason;
+    triggerUs = esp_timer_get_time();
+    triggerSeq = nextSeq.load();
+    xTaskNotifyGive(dumpHandle);
+    return true;
+}
+
+bool FlightRecorder::waitForDump(uint32_t timeoutMs) {
+    unsigned long start = millis();
+    while (dumpPending && millis() - start < timeoutMs) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return !dumpPending;
+}
+
+void FlightRecorder::record(uint8_t kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info) {
+    FlightSlot* ring = slots;
+    if (!ring) return;
+    
+    uint32_t startCycles = esp_cpu_get_cycle_count();
+    
+    // Slot reservieren, als "in Arbeit" markieren, füllen, mit Sequenz freigeben
+    uint32_t seq = nextSeq.fetch_add(1, std::memory_order_relaxed) + 1;
+    FlightSlot& slot = ring[(seq - 1) & slotMask];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    if (len > ESPNOW_MAX_PACKET_SIZE) len = ESPNOW_MAX_PACKET_SIZE;
+    slot.header.timeUs = esp_timer_get_time();
+    slot.header.seq = seq;
+    slot.header.len = len;
+    slot.header.kind = kind;
+    slot.header.info = info;
+    if (mac) {
+        memcpy(slot.header.mac, mac, 6);
+    } else {
+        memset(slot.header.mac, 0, 6);
+    }
+    if (data && len > 0) memcpy(slot.data, data, len);
+    
+    slot.seq.store(seq, std::memory_order_release);
+    
+    recordCycles.fetch_add(esp_cpu_get_cycle_count() - startCycles, std::memory_order_relaxed);
+}
+
+void FlightRecorder::getStats(FlightRecorderStats* out) {
+    if (!out) return;
+    
+    *out = stats;
+    out->recorded = nextSeq.load();
+    out->capacity = slots ? slotMask + 1 : 0;
+    out->psram = inPsram;
+    if (out->recorded > 0) {
+        out->avgRecordNs = (uint32_t)(recordCycles.load() * 1000 / ESP.getCpuFreqMHz() / out->recorded);
+    }
+}
+
+void FlightRecorder::printInfo() {
+    DEBUG_PRINTLN("\n╔═══════════════════════════════════════════════╗");
+    DEBUG_PRINTLN("║            FLIGHT RECORDER INFO               ║");
+    DEBUG_PRINTLN("╚═══════════════════════════════════════════════╝");
+    
+    FlightRecorderStats s;
+    getStats(&s);
+    DEBUG_PRINTF("Ring:       %lu Slots im %s (%lu KB)\n", s.capacity, s.psram ? "PSRAM" : "RAM",
+                 (unsigned long)(s.capacity * sizeof(FlightSlot) / 1024));
+    DEBUG_PRINTF("Erfasst:    %lu Vorgänge, Ø %lu ns pro Eintrag\n", s.recorded, s.avgRecordNs);
+    DEBUG_PRINTF("Dumps:      %lu (%lu Fehler, %lu Auslöser ignoriert)%s\n",
+                 s.dumps, s.dumpErrors, s.triggersIgnored, dumpPending ? " - läuft" : "");
+    DEBUG_PRINTF("Letzter:    %lu Einträge in %lu ms, %lu überschrieben (gesamt)\n",
+                 s.lastDumpRecords, s.lastDumpMs, s.lost);
+    
+    DEBUG_PRINTLN("═══════════════════════════════════════════════\n");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME-TAP & DUMP-TASK
+// ═══════════════════════════════════════════════════════════════════════════
+
+void FlightRecorder::tap(EspNowTapKind kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info) {
+    FlightRecorder* recorder = instance;
+    if (recorder) recorder->record(static_cast<uint8_t>(kind), mac, data, len, info);
+}
+
+void FlightRecorder::dumpTask(void* parameter) {
+    FlightRecorder* recorder = static_cast<FlightRecorder*>(parameter);
+    
+    DEBUG_PRINTLN("FlightRecorder: Dump-Task gestartet");
+    
+    while (recorder->dumpRunning) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        if (recorder->dumpPending) {
+            recorder->writeDump();
+            recorder->dumpPending = false;
+        }
+    }
+    
+    // end() gibt Ring und Puffer erst danach frei
+    xSemaphoreGive(recorder->dumpExited);
+    vTaskDelete(nullptr);
+}
+
+bool FlightRecorder::writeDump() {
+    unsigned long start = millis();
+    
+    if (!sd.isAvailable()) {
+        stats.dumpErrors++;
+        return false;
+    }
+    
+    // Bereich: bis zum Auslöser, höchstens ein Ring, höchstens das Zeitfenster
+    uint32_t last = triggerSeq;
+    uint32_t capacity = slotMask + 1;
+    uint32_t first = last > capacity ? last - capacity + 1 : 1;
+    int64_t fromUs = triggerUs - (int64_t)FLIGHT_RECORDER_DUMP_WINDOW_MS * 1000;
+    while (first <= last) {
+        const FlightSlot& slot = slots[(first - 1) & slotMask];
+        if (slot.seq.load(std::memory_order_acquire) == first && slot.header.timeUs >= fromUs) break;
+        first++;
+    }
+    
+    char path[SD_MAX_PATH];
+    dumpPath(nextDumpId, path, sizeof(path));
+    File file = sd.openFile(path, FILE_WRITE);
+    if (!file) {
+        DEBUG_PRINTF("FlightRecorder: ❌ Kann %s nicht anlegen\n", path);
+        stats.dumpErrors++;
+        return false;
+    }
+    
+    // Header vorab, Zähler werden am Ende nachgetragen
+    FlightDumpHeader header = {};
+    memcpy(header.magic, FLIGHT_DUMP_MAGIC, sizeof(header.magic));
+    header.version = FLIGHT_DUMP_VERSION;
+    header.trigger = pendingTrigger;
+    header.dumpId = nextDumpId;
+    header.triggerUs = triggerUs;
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    
+    size_t fill = 0;
+    for (uint32_t seq = first; ok && seq <= last; seq++) {
+        const FlightSlot& slot = slots[(seq - 1) & slotMask];
+        if (slot.seq.load(std::memory_order_acquire) != seq) {
+            header.lost++;
+            continue;
+        }
+        
+        if (fill + sizeof(FlightRecordHeader) + ESPNOW_MAX_PACKET_SIZE > FLIGHT_RECORDER_CHUNK_SIZE) {
+            ok = file.write(chunk, fill) == fill;
+            fill = 0;
+        }
+        
+        // Kopieren, danach prüfen ob der Slot inzwischen überschrieben wurde
+        FlightRecordHeader* record = (FlightRecordHeader*)&chunk[fill];
+        memcpy(record, &slot.header, sizeof(*record));
+        size_t len = record->len <= ESPNOW_MAX_PACKET_SIZE ? record->len : ESPNOW_MAX_PACKET_SIZE;
+        memcpy(&chunk[fill + sizeof(*record)], slot.data, len);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seq) {
+            header.lost++;
+            continue;
+        }
+        
+        record->len = len;
+        fill += sizeof(*record) + len;
+        header.records++;
+    }
+    
+    if (ok && fill > 0) ok = file.write(chunk, fill) == fill;
+    ok = ok && file.seek(0) && file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    file.close();
+    
+    stats.lost += header.lost;
+    if (!ok) {
+        DEBUG_PRINTF("FlightRecorder: ❌ Dump %s unvollständig\n", path);
+        stats.dumpErrors++;
+        return false;
+    }
+    
+    stats.dumps++;
+    stats.lastDumpRecords = header.records;
+    stats.lastDumpMs = millis() - start;
+    nextDumpId++;
+    
+    DEBUG_PRINTF("FlightRecorder: ✅ %s (%s): %lu Einträge, %lu überschrieben, %lu ms\n",
+                 path, flightTriggerName(header.trigger), header.records, header.lost, stats.lastDumpMs);
+    return true;
+}
+
+void FlightRecorder::scanDumps() {
+    nextDumpId = 0;
+    if (!sd.isAvailable()) return;
+    
+    // Höchste vorhandene Nummer + 1 (Dateien werden reihum überschrieben)
+    for (uint32_t i = 0; i < FLIGHT_RECORDER_MAX_DUMPS; i++) {
+        char path[SD_MAX_PATH];
+        dumpPath(i, path, sizeof(path));
+        if (!sd.fileExists(path)) continue;
+        
+        File file = sd.openFile(path, FILE_READ);
+        FlightDumpHeader header;
+        if (file && file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            memcmp(header.magic, FLIGHT_DUMP_MAGIC, sizeof(header.magic)) == 0 &&
+            header.dumpId + 1 > nextDumpId) {
+            nextDumpId = header.dumpId + 1;
+        }
+        if (file) file.close();
+    }
+}
+
+void FlightRecorder::dumpPath(uint32_t dumpId, char* path, size_t size) {
+    snprintf(path, size, "/flight%lu.bin", (unsigned long)(dumpId % FLIGHT_RECORDER_MAX_DUMPS));
+}
\ No newline at end of file
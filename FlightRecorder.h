@@ -0,0 +1,199 @@
+/**
+ * FlightRecorder.h
+ *
+ * Flight-Recorder für ESP-NOW: die letzten Sekunden Funkverkehr im PSRAM
+ *
+ * Features:
+ * - Ring fester Slots im PSRAM (ESP32-S3-N16R8: 8 MB, sonst nicht genutzt)
+ * - Jeder RX/TX-Frame (Header + Nutzdaten), Sende-Status und EspNowEvent
+ *   mit µs-Zeitstempel, erfasst über einen Frame-Tap des EspNowManagers
+ * - Lock-frei auf dem Hot-Path: Slot per atomarem Zähler, Kopie, Sequenz als
+ *   Freigabe (mehrere Produzenten: WiFi-Task, Worker, Main)
+ * - Dump auf SD asynchron in eigenem Task bei PEER_DISCONNECTED,
+ *   HEARTBEAT_TIMEOUT, Battery-Shutdown oder manuell (trigger())
+ * - Dateiformat in LogSchema.h (Decoder: tools/logdecode)
+ */
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "config.h"
+#include "SDCardHandler.h"
+#include "ESPNowManager.h"
+#include "LogSchema.h"
+
+#ifndef FLIGHT_RECORDER_SLOTS
+#define FLIGHT_RECORDER_SLOTS           8192    // Slots im PSRAM (Zweierpotenz, à 276 Bytes ≈ 2.2 MB)
+#endif
+
+#ifndef FLIGHT_RECORDER_FALLBACK_SLOTS
+#define FLIGHT_RECORDER_FALLBACK_SLOTS  256     // Ohne PSRAM im internen RAM (Zweierpotenz)
+#endif
+
+#ifndef FLIGHT_RECORDER_DUMP_WINDOW_MS
+#define FLIGHT_RECORDER_DUMP_WINDOW_MS  10000   // Nur die letzten x ms vor dem Auslöser dumpen
+#endif
+
+#ifndef FLIGHT_RECORDER_MAX_DUMPS
+#define FLIGHT_RECORDER_MAX_DUMPS       4       // Dump-Dateien (reihum überschrieben)
+#endif
+
+#ifndef FLIGHT_RECORDER_SHUTDOWN_WAIT_MS
+#define FLIGHT_RECORDER_SHUTDOWN_WAIT_MS    5000    // Max. Wartezeit auf den Dump vor dem Abschalten
+#endif
+
+#ifndef FLIGHT_RECORDER_CHUNK_SIZE
+#define FLIGHT_RECORDER_CHUNK_SIZE      4096    // Schreibpuffer des Dump-Tasks
+#endif
+
+#ifndef FLIGHT_RECORDER_PRIORITY
+#define FLIGHT_RECORDER_PRIORITY        1       // Wie LogWriter, unter dem ESP-NOW Worker
+#endif
+
+#ifndef FLIGHT_RECORDER_CORE
+#define FLIGHT_RECORDER_CORE            0
+#endif
+
+#ifndef FLIGHT_RECORDER_STACK_SIZE
+#define FLIGHT_RECORDER_STACK_SIZE      4096
+#endif
+
+/**
+ * Slot im Ring
+ */
+struct FlightSlot {
+    std::atomic<uint32_t> seq;          // Sequenz des Inhalts (0 = wird geschrieben)
+    FlightRecordHeader header;
+    uint8_t data[ESPNOW_MAX_PACKET_SIZE];
+};
+
+/**
+ * Statistik
+ */
+struct FlightRecorderStats {
+    uint32_t recorded;          // Erfasste Vorgänge gesamt
+    uint32_t capacity;          // Slots im Ring
+    bool psram;                 // Ring liegt im PSRAM
+    uint32_t dumps;             // Geschriebene Dumps
+    uint32_t dumpErrors;        // Fehlgeschlagene Dumps
+    uint32_t lastDumpRecords;   // Einträge im letzten Dump
+    uint32_t lastDumpMs;        // Dauer des letzten Dumps
+    uint32_t lost;              // Während Dumps überschriebene Einträge
+    uint32_t triggersIgnored;   // Auslöser während eines laufenden Dumps
+    uint32_t avgRecordNs;       // Mittlere Kosten pro Eintrag (Hot-Path)
+};
+
+class FlightRecorder {
+public:
+    /**
+     * Konstruktor
+     * @param sdCard Referenz zum SDCardHandler
+     */
+    FlightRecorder(SDCardHandler& sdCard);
+    
+    /**
+     * Ring anlegen, Dump-Task starten, am EspNowManager anmelden
+     * (Frame-Tap, PEER_DISCONNECTED und HEARTBEAT_TIMEOUT lösen einen Dump aus)
+     * @return true bei Erfolg
+     */
+    bool begin();
+    
+    /**
+     * Abmelden, Dump-Task stoppen, Ring freigeben
+     */
+    void end();
+    
+    /**
+     * Dump auslösen (kehrt sofort zurück, nicht aus ISR)
+     * Gedumpt werden die Einträge bis zum Auslöser, maximal
+     * FLIGHT_RECORDER_DUMP_WINDOW_MS.
+     * @param reason Auslöser (steht im Datei-Header)
+     * @return false wenn bereits ein Dump läuft oder nicht gestartet
+     */
+    bool trigger(FlightTrigger reason = FLIGHT_TRIGGER_MANUAL);
+    
+    /**
+     * Läuft gerade ein Dump?
+     */
+    bool isDumping() const { return dumpPending; }
+    
+    /**
+     * Auf das Ende eines laufenden Dumps warten (z.B. vor Deep-Sleep)
+     * @param timeoutMs Maximale Wartezeit
+     * @return true wenn kein Dump mehr läuft
+     */
+    bool waitForDump(uint32_t timeoutMs);
+    
+    /**
+     * Vorgang erfassen (Hot-Path, lock-frei)
+     * @param kind FLIGHT_KIND_*
+     * @param mac Peer-MAC (nullptr = unbekannt)
+     * @param data Frame bzw. Event (max. ESPNOW_MAX_PACKET_SIZE)
+     * @param len Länge
+     * @param info RSSI bzw. Status
+     */
+    void record(uint8_t kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info);
+    
+    /**
+     * Statistik abrufen
+     */
+    void getStats(FlightRecorderStats* stats);
+    
+    /**
+     * Debug-Info ausgeben
+     */
+    void printInfo();
+
+private:
+    SDCardHandler& sd;
+    
+    // Ring (PSRAM)
+    FlightSlot* slots;
+    uint32_t slotMask;                  // Slots - 1
+    bool inPsram;
+    std::atomic<uint32_t> nextSeq;      // Zuletzt vergebene Sequenz
+    std::atomic<uint64_t> recordCycles; // CPU-Zyklen im Hot-Path (nur Statistik, alle Cores)
+    
+    // Dump
+    TaskHandle_t dumpHandle;
+    volatile bool dumpRunning;
+    std::atomic<bool> dumpPending;
+    SemaphoreHandle_t dumpExited;       // Vom Dump-Task vor vTaskDelete gegeben
+    FlightTrigger pendingTrigger;
+    int64_t triggerUs;
+    uint32_t triggerSeq;                // Letzte Sequenz vor dem Auslöser
+    uint32_t nextDumpId;
+    uint8_t* chunk;                     // Schreibpuffer
+    
+    // Anmeldung am EspNowManager
+    EspNowEventToken disconnectToken;
+    EspNowEventToken timeoutToken;
+    
+    FlightRecorderStats stats;
+    
+    static FlightRecorder* instance;    // Für den Frame-Tap
+    
+    static void tap(EspNowTapKind kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info);
+    static void dumpTask(void* parameter);
+    
+    /**
+     * Ring bis zum Auslöser in die nächste Dump-Datei schreiben (Dump-Task)
+     */
+    bool writeDump();
+    
+    /**
+     * Nächste Dump-Nummer aus vorhandenen Dateien bestimmen
+     */
+    void scanDumps();
+    
+    /**
+     * Dateiname einer Dump-Nummer
+     */
+    static void dumpPath(uint32_t dumpId, char* path, size_t size);
+};
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,173 @@
+/**
+ * LogCompress.h
+ *
+ * LZ-Kompression für Log-Blöcke (kleines Fenster, byte-orientiert)
+ *
+ * Gemeinsam genutzt von CircularLog (Firmware) und tools/logdecode (Linux).
+ * Nur <stdint.h>/<string.h>, keine Arduino-Abhängigkeiten, kein Heap.
+ *
+ * Jeder Ringblock wird für sich komprimiert (Fenster = Rohdaten des Blocks),
+ * ist also ohne Vorgänger dekodierbar. Records werden einzeln angehängt
+ * (logLzCompress pro Record), Treffer dürfen auf frühere Records im selben
+ * Block verweisen.
+ *
+ * Format (Folge von Tokens):
+ *   0LLLLLLL                Literal-Lauf: L+1 Bytes folgen (1..128)
+ *   1LLLLOOO OOOOOOOO [E]   Treffer: Offset = O+1 (1..LOG_LZ_WINDOW)
+ *                           Länge = L+3 (3..17), bei L=15: 18+E (18..273)
+ */
+
+#ifndef LOG_COMPRESS_H
+#define LOG_COMPRESS_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define LOG_LZ_WINDOW       2048    // Max. Rohdaten pro Block (11 Bit Offset)
+#define LOG_LZ_MIN_MATCH    3
+#define LOG_LZ_MAX_MATCH    (18 + 255)
+#define LOG_LZ_HASH_BITS    9       // 512 Einträge à 2 Bytes
+
+// Maximale Größe nach Kompression (nur Literale)
+#define LOG_LZ_BOUND(n)     ((n) + ((n) + 127) / 128)
+
+/**
+ * Kompressor-Zustand eines Blocks (Hash → letzte Position + 1, 0 = leer)
+ */
+struct LogLzState {
+    uint16_t head[1 << LOG_LZ_HASH_BITS];
+};
+
+static inline void logLzReset(LogLzState* state) {
+    memset(state->head, 0, sizeof(state->head));
+}
+
+static inline uint32_t logLzHash(const uint8_t* p) {
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+    return (v * 2654435761u) >> (32 - LOG_LZ_HASH_BITS);
+}
+
+/**
+ * Position in die Hash-Tabelle eintragen (Wiederaufbau nach Neustart)
+ * @param src Rohdaten des Blocks
+ * @param pos Position (pos + LOG_LZ_MIN_MATCH <= Länge)
+ */
+static inline void logLzInsert(LogLzState* state, const uint8_t* src, uint32_t pos) {
+    state->head[logLzHash(&src[pos])] = (uint16_t)(pos + 1);
+}
+
+/**
+ * Literal-Lauf ausgeben
+ * @return Neue Ausgabeposition, -1 wenn cap überschritten
+ */
+static inline int logLzLiterals(const uint8_t* src, uint32_t len, uint8_t* out, int o, uint32_t cap) {
+    while (len > 0) {
+        uint32_t n = len > 128 ? 128 : len;
+        if (o + 1 + n > cap) return -1;
+        out[o++] = (uint8_t)(n - 1);
+        memcpy(&out[o], src, n);
+        o += n;
+        src += n;
+        len -= n;
+    }
+    return o;
+}
+
+/**
+ * Rohdaten src[start..end) komprimieren, Treffer im Bereich src[0..end)
+ * @param state Zustand des Blocks (über alle Records eines Blocks)
+ * @param src Rohdaten des Blocks (end <= LOG_LZ_WINDOW)
+ * @param out Ausgabe
+ * @param cap Platz in out
+ * @return Geschriebene Bytes, -1 wenn cap nicht reicht (Zustand dann verwerfen)
+ */
+static inline int logLzCompress(LogLzState* state, const uint8_t* src, uint32_t start, uint32_t end,
+                                uint8_t* out, uint32_t cap) {
+    int o = 0;
+    uint32_t pos = start;
+    uint32_t literal = start;
+    
+    while (pos + LOG_LZ_MIN_MATCH <= end) {
+        uint32_t h = logLzHash(&src[pos]);
+        uint32_t candidate = state->head[h];
+        state->head[h] = (uint16_t)(pos + 1);
+        
+        // Nur ein Kandidat pro Hash (schnell, reicht für wiederkehrende Log-Texte)
+        uint32_t len = 0;
+        if (candidate > 0) {
+            uint32_t from = candidate - 1;
+            uint32_t max = end - pos;
+            if (max > LOG_LZ_MAX_MATCH) max = LOG_LZ_MAX_MATCH;
+            while (len < max && src[from + len] == src[pos + len]) len++;
+        }
+        if (len < LOG_LZ_MIN_MATCH) {
+            pos++;
+            continue;
+        }
+        
+        o = logLzLiterals(&src[literal], pos - literal, out, o, cap);
+        if (o < 0 || o + 3 > (int)cap) return -1;
+        
+        uint32_t offset = pos - (candidate - 1) - 1;
+        uint32_t code = len - LOG_LZ_MIN_MATCH;
+        if (code >= 15) {
+            out[o++] = 0x80 | (15 << 3) | (offset >> 8);
+            out[o++] = offset & 0xFF;
+            out[o++] = (uint8_t)(len - 18);
+        } else {
+            out[o++] = 0x80 | (code << 3) | (offset >> 8);
+            out[o++] = offset & 0xFF;
+        }
+        
+        // Übersprungene Positionen eintragen
+        for (uint32_t i = 1; i < len && pos + i + LOG_LZ_MIN_MATCH <= end; i++) {
+            logLzInsert(state, src, pos + i);
+        }
+        pos += len;
+        literal = pos;
+    }
+    
+    return logLzLiterals(&src[literal], end - literal, out, o, cap);
+}
+
+/**
+ * Block dekomprimieren
+ * @param in Komprimierte Daten
+ * @param inLen Länge
+ * @param out Ausgabe (mind. LOG_LZ_WINDOW)
+ * @param cap Platz in out
+ * @return Rohdaten-Bytes, -1 bei ungültigen Daten
+ */
+static inline int logLzDecompress(const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t cap) {
+    uint32_t i = 0;
+    uint32_t o = 0;
+    
+    while (i < inLen) {
+        uint8_t token = in[i++];
+        if (token < 0x80) {
+            uint32_t n = token + 1;
+            if (i + n > inLen || o + n > cap) return -1;
+            memcpy(&out[o], &in[i], n);
+            i += n;
+            o += n;
+            continue;
+        }
+        
+        if (i >= inLen) return -1;
+        uint32_t offset = (((token & 0x07) << 8) | in[i++]) + 1;
+        uint32_t len = ((token >> 3) & 0x0F) + LOG_LZ_MIN_MATCH;
+        if (len == 18) {
+            if (i >= inLen) return -1;
+            len += in[i++];
+        }
+        if (offset > o || o + len > cap) return -1;
+        
+        // Byteweise (Überlappung erlaubt)
+        for (uint32_t k = 0; k < len; k++, o++) {
+            out[o] = out[o - offset];
+        }
+    }
+    return (int)o;
+}
+
+#endif // LOG_COMPRESS_H
@@ -0,0 +1,132 @@
+/**
+ * LogFormat.cpp
+ *
+ * Implementation der allokationsfreien Log-Formatierung
+ */
+
+#include "LogFormat.h"
+
+LogLine::LogLine(char* buffer, size_t capacity)
+    : buf(buffer)
+    , cap(capacity)
+    , len(0)
+    , truncated(false)
+{
+    if (buf && cap > 0) buf[0] = '\0';
+}
+
+void LogLine::reset() {
+    len = 0;
+    truncated = false;
+    if (buf && cap > 0) buf[0] = '\0';
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TYPISIERTE AUSGABE
+// ═══════════════════════════════════════════════════════════════════════════
+
+LogLine& LogLine::operator<<(const char* text) {
+    if (text) append(text, strlen(text));
+    return *this;
+}
+
+LogLine& LogLine::operator<<(char c) {
+    append(&c, 1);
+    return *this;
+}
+
+LogLine& LogLine::operator<<(bool value) {
+    return *this << (value ? "true" : "false");
+}
+
+LogLine& LogLine::operator<<(const LogFixed& fixed) {
+    float value = fixed.value;
+    
+    if (isnan(value)) return *this << "nan";
+    if (isinf(value)) return *this << (value < 0 ? "-inf" : "inf");
+    
+    // Gerundet auf Festkomma skalieren, Vorzeichen separat
+    static const uint32_t scales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    uint32_t scale = scales[fixed.decimals];
+    bool negative = value < 0.0f;
+    uint64_t scaled = (uint64_t)((negative ? -value : value) * scale + 0.5f);
+    
+    if (negative && scaled > 0) *this << '-';
+    
+    uint64_t whole = scaled / scale;
+    if (whole > 0xFFFFFFFFULL) return *this << "ovf";
+    appendUnsigned((uint32_t)whole);
+    
+    if (fixed.decimals > 0) {
+        char frac[8];
+        uint32_t rest = (uint32_t)(scaled % scale);
+        frac[0] = '.';
+        for (int i = fixed.decimals; i >= 1; i--) {
+            frac[i] = '0' + (rest % 10);
+            rest /= 10;
+        }
+        append(frac, fixed.decimals + 1);
+    }
+    return *this;
+}
+
+LogLine& LogLine::operator<<(const LogHex& hex) {
+    static const char digits[] = "0123456789abcdef";
+    char tmp[8];
+    int n = 0;
+    uint32_t value = hex.value;
+    
+    do {
+        tmp[7 - n++] = digits[value & 0x0F];
+        value >>= 4;
+    } while (value && n < 8);
+    
+    append(&tmp[8 - n], n);
+    return *this;
+}
+
+LogLine& LogLine::operator<<(const LogTime& time) {
+    *this << '[';
+    appendUnsigned(time.ms);
+    return *this << "ms]";
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRIVATE METHODEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+LogLine& LogLine::appendSigned(int32_t value) {
+    if (value < 0) {
+        *this << '-';
+        // Über uint32 negieren (INT32_MIN sicher)
+        return appendUnsigned(0u - (uint32_t)value);
+    }
+    return appendUnsigned((uint32_t)value);
+}
+
+LogLine& LogLine::appendUnsigned(uint32_t value) {
+    char tmp[10];
+    int n = 0;
+    
+    do {
+        tmp[9 - n++] = '0' + (value % 10);
+        value /= 10;
+    } while (value);
+    
+    append(&tmp[10 - n], n);
+    return *this;
+}
+
+void LogLine::append(const char* text, size_t n) {
+    if (!buf || cap == 0) return;
+    
+    size_t space = cap - 1 - len;
+    if (n > space) {
+        n = space;
+        truncated = true;
+    }
+    
+    memcpy(&buf[len], text, n);
+    len += n;
+    buf[len] = '\0';
+}
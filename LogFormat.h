@@ -0,0 +1,130 @@
+/**
+ * LogFormat.h
+ *
+ * Allokationsfreie Formatierung von Log-Zeilen
+ *
+ * Features:
+ * - Schreibt in einen vom Aufrufer gestellten festen Buffer (kein Heap, kein String)
+ * - Typen werden zur Compile-Zeit über Überladungen gewählt (kein Format-String,
+ *   kein Typ-Mismatch wie bei printf möglich)
+ * - Formatierungs-Specs als Typen: LogFixed (Nachkommastellen), LogHex, LogTime
+ * - Überlauf kürzt die Zeile und wird gemeldet (isTruncated)
+ *
+ * Beispiel:
+ *   char buf[LOG_RECORD_SIZE];
+ *   LogLine line(buf, sizeof(buf));
+ *   line << LogTime(millis()) << " INFO - Battery | Voltage: " << LogFixed(v, 2) << "V";
+ */
+
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+/**
+ * Festkomma-Ausgabe einer Fließkommazahl (z.B. LogFixed(14.823f, 2) → "14.82")
+ */
+struct LogFixed {
+    float value;
+    uint8_t decimals;       // 0..6
+    
+    LogFixed(float v, uint8_t d) : value(v), decimals(d > 6 ? 6 : d) {}
+};
+
+/**
+ * Hexadezimale Ausgabe ohne Präfix (z.B. LogHex(0x4008ABCD) → "4008abcd")
+ */
+struct LogHex {
+    uint32_t value;
+    
+    explicit LogHex(uint32_t v) : value(v) {}
+};
+
+/**
+ * Zeitstempel im Log-Format (z.B. LogTime(12345) → "[12345ms]")
+ */
+struct LogTime {
+    uint32_t ms;
+    
+    explicit LogTime(uint32_t t) : ms(t) {}
+};
+
+/**
+ * Log-Zeile in festem Buffer
+ */
+class LogLine {
+public:
+    /**
+     * Konstruktor
+     * @param buffer Ziel-Buffer (vom Aufrufer, z.B. auf dem Stack)
+     * @param capacity Buffer-Größe inkl. Null-Terminator
+     */
+    LogLine(char* buffer, size_t capacity);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // TYPISIERTE AUSGABE
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    LogLine& operator<<(const char* text);
+    LogLine& operator<<(char c);
+    LogLine& operator<<(bool value);
+    
+    /**
+     * Ganzzahlen (int8..int32, uint8..uint32, int, long, ...)
+     * 64-Bit wird zur Compile-Zeit abgelehnt
+     */
+    template<typename T,
+             typename std::enable_if<std::is_integral<T>::value &&
+                                     !std::is_same<T, bool>::value &&
+                                     !std::is_same<T, char>::value, int>::type = 0>
+    LogLine& operator<<(T value) {
+        static_assert(sizeof(T) <= sizeof(uint32_t), "LogLine: nur Ganzzahlen bis 32 Bit");
+        if (std::is_signed<T>::value) return appendSigned((int32_t)value);
+        return appendUnsigned((uint32_t)value);
+    }
+    
+    LogLine& operator<<(const LogFixed& fixed);
+    LogLine& operator<<(const LogHex& hex);
+    LogLine& operator<<(const LogTime& time);
+    
+    // Fließkomma nur mit expliziter Genauigkeit (LogFixed)
+    LogLine& operator<<(float value) = delete;
+    LogLine& operator<<(double value) = delete;
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // ZUGRIFF
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    /**
+     * Zeile (immer null-terminiert)
+     */
+    const char* c_str() const { return buf; }
+    
+    /**
+     * Länge ohne Null-Terminator
+     */
+    size_t length() const { return len; }
+    
+    /**
+     * Wurde die Zeile gekürzt?
+     */
+    bool isTruncated() const { return truncated; }
+    
+    /**
+     * Zeile leeren (Buffer wiederverwenden)
+     */
+    void reset();
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+    bool truncated;
+    
+    LogLine& appendSigned(int32_t value);
+    LogLine& appendUnsigned(uint32_t value);
+    void append(const char* text, size_t n);
+};
+
+#endif // LOG_FORMAT_H
@@ -6,13 +6,33 @@
  */
 
 #include "LogManager.h"
+#include "ESPNowManager.h"
+#include <esp_system.h>
+#include <esp_timer.h>
+
+static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0, "LOG_RING_SLOTS muss eine Zweierpotenz sein");
+static_assert(LOG_RECORD_SIZE <= LOG_RING_PAYLOAD_SIZE, "LOG_RECORD_SIZE muss in einen Ring-Block passen");
+static_assert(LOG_LZ_BOUND(LOG_RECORD_SIZE) <= LOG_RING_PAYLOAD_SIZE, "Komprimierter Record muss in einen Ring-Block passen");
+// Append-Handles, Ringe und Indizes bleiben offen, dazu Capture, Flight-Dump und 2 kurzzeitige Dateien
+static_assert(SD_MAX_FILES >= SD_MAX_OPEN_HANDLES + 2 * static_cast<int>(LogChannel::COUNT) + 4,
+              "SD_MAX_FILES zu klein für die dauerhaft offenen Dateien");
+
+LogManager* LogManager::instance = nullptr;
 
 LogManager::LogManager(SDCardHandler& sdCard)
     : sd(sdCard)
+    , mode(LogMode::TEXT)
+    , ringHead(0)
+    , ringTail(0)
+    , writerHandle(nullptr)
+    , writerRunning(false)
+    , drainMutex(nullptr)
 {
+    ringMux = portMUX_INITIALIZER_UNLOCKED;
+    memset(&stats, 0, sizeof(stats));
 }
 
-bool LogManager::begin() {
+bool LogManager::begin(LogMode logMode) {
     DEBUG_PRINTLN("LogManager: Initialisiere...");
     
     if (!sd.isAvailable()) {
@@ -20,63 +40,252 @@ bool LogManager::begin() {
         return false;
     }
     
-    DEBUG_PRINTLN("LogManager: ✅ Bereit");
+    if (writerHandle) return true;
+    
+    mode = logMode;
+    
+    if (!drainMutex) {
+        drainMutex = xSemaphoreCreateMutex();
+        if (!drainMutex) {
+            DEBUG_PRINTLN("LogManager: ❌ Mutex erstellen fehlgeschlagen!");
+            return false;
+        }
+    }
+    
+    // Ringdateien öffnen (beim ersten Start in voller Größe anlegen)
+    uint8_t format = mode == LogMode::BINARY ? LOG_RING_FORMAT_BINARY : LOG_RING_FORMAT_TEXT;
+    for (int i = 0; i < static_cast<int>(LogChannel::COUNT); i++) {
+        const char* logFile = channelFile(static_cast<LogChannel>(i));
+        bool compress = (LOG_COMPRESS_CHANNELS >> i) & 1;
+        if (!stores[i].open(sd, logFile, LOG_MAX_FILE_SIZE / LOG_RING_BLOCK_SIZE, format, compress)) {
+            DEBUG_PRINTF("LogManager: ⚠️ Ringdatei nicht verfügbar: %s\n", logFile);
+        }
+    }
+    
+    // Writer-Task mit niedriger Priorität auf dem anderen Core
+    writerRunning = true;
+    BaseType_t taskResult = xTaskCreatePinnedToCore(
+        writerTask,                     // Task-Funktion
+        "LogWriter",                    // Name
+        LOG_WRITER_STACK_SIZE,          // Stack-Größe
+        this,                           // Parameter (this-Pointer)
+        LOG_WRITER_PRIORITY,            // Priorität
+        &writerHandle,                  // Task-Handle
+        LOG_WRITER_CORE                 // Core
+    );
+    
+    if (taskResult != pdPASS) {
+        // Ohne Writer weiter nutzbar, dann wird beim Einreihen synchron geschrieben
+        DEBUG_PRINTLN("LogManager: ⚠️ Writer-Task fehlgeschlagen, schreibe synchron");
+        writerRunning = false;
+        writerHandle = nullptr;
+    }
+    
+    // Ausstehende Records vor esp_restart() noch schreiben
+    instance = this;
+    esp_register_shutdown_handler(shutdownHandler);
+    
+    DEBUG_PRINTF("LogManager: ✅ Bereit (%s, Ring %d × %d Bytes, Writer Core %d)\n",
+                 mode == LogMode::BINARY ? "Binär" : "Text", LOG_RING_SLOTS, LOG_RECORD_SIZE, LOG_WRITER_CORE);
     return true;
 }
 
+void LogManager::end() {
+    if (writerHandle) {
+        writerRunning = false;
+        xTaskNotifyGive(writerHandle);
+        vTaskDelay(pdMS_TO_TICKS(20));  // Warten bis Task beendet
+        writerHandle = nullptr;
+    }
+    
+    // Rest synchron schreiben, Ringdateien schließen
+    flush();
+    
+    bool locked = drainMutex && xSemaphoreTake(drainMutex, pdMS_TO_TICKS(1000)) == pdTRUE;
+    for (auto& store : stores) {
+        store.close();
+    }
+    if (locked) xSemaphoreGive(drainMutex);
+    
+    if (instance == this) {
+        esp_unregister_shutdown_handler(shutdownHandler);
+        instance = nullptr;
+    }
+}
+
+bool LogManager::flush(uint32_t timeoutMs) {
+    if (!drainMutex) {
+        // Vor begin(): kein Writer-Task, direkt schreiben
+        drain();
+        return true;
+    }
+    
+    // Im Kontext des Aufrufers leeren (Writer-Task wird über den Mutex ausgeschlossen)
+    if (xSemaphoreTake(drainMutex, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+        return false;
+    }
+    drain();
+    for (auto& store : stores) {
+        store.flush();
+    }
+    xSemaphoreGive(drainMutex);
+    
+    return getPending() == 0;
+}
+
+void LogManager::getStats(LogStats* out) {
+    if (!out) return;
+    portENTER_CRITICAL(&ringMux);
+    *out = stats;
+    portEXIT_CRITICAL(&ringMux);
+}
+
+int LogManager::getPending() {
+    return (int)(ringHead - ringTail);
+}
+
 void LogManager::clearAllLogs() {
     if (!sd.isAvailable()) return;
     
     DEBUG_PRINTLN("LogManager: Lösche alle Logs...");
     
-    sd.deleteFile(LOG_FILE_BOOT);
-    sd.deleteFile(LOG_FILE_BATTERY);
-    sd.deleteFile(LOG_FILE_CONNECTION);
-    sd.deleteFile(LOG_FILE_ERROR);
+    bool locked = drainMutex && xSemaphoreTake(drainMutex, pdMS_TO_TICKS(1000)) == pdTRUE;
+    
+    // Ringdateien bleiben angelegt, nur Head/Tail werden zurückgesetzt
+    for (auto& store : stores) {
+        store.clear();
+    }
+    
+    if (locked) xSemaphoreGive(drainMutex);
     
     DEBUG_PRINTLN("LogManager: ✅ Logs gelöscht");
 }
 
+size_t LogManager::getChannelSize(LogChannel channel) const {
+    int idx = static_cast<int>(channel);
+    return idx < static_cast<int>(LogChannel::COUNT) ? stores[idx].getUsedBytes() : 0;
+}
+
+void LogManager::setCompression(LogChannel channel, bool enable) {
+    int idx = static_cast<int>(channel);
+    if (idx >= static_cast<int>(LogChannel::COUNT)) return;
+    
+    bool locked = drainMutex && xSemaphoreTake(drainMutex, pdMS_TO_TICKS(1000)) == pdTRUE;
+    stores[idx].setCompression(enable);
+    if (locked) xSemaphoreGive(drainMutex);
+}
+
+uint32_t LogManager::getBoot(LogChannel channel) const {
+    int idx = static_cast<int>(channel);
+    return idx < static_cast<int>(LogChannel::COUNT) ? stores[idx].getBoot() : 0;
+}
+
+int LogManager::readRange(LogChannel channel, uint32_t fromMs, uint32_t toMs, LogRangeCallback callback,
+                          uint32_t boot) {
+    int idx = static_cast<int>(channel);
+    if (idx >= static_cast<int>(LogChannel::COUNT) || !callback || !drainMutex) return -1;
+    
+    if (xSemaphoreTake(drainMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return -1;
+    }
+    
+    // Ausstehende Records zuerst in den Schreib-Block übernehmen
+    drain();
+    
+    bool binary = mode == LogMode::BINARY;
+    int records = 0;
+    int blocks = stores[idx].readRange(fromMs, toMs, [&](const uint8_t* data, size_t len) {
+        // Block in Records zerlegen (überspannen keine Blockgrenze)
+        size_t pos = 0;
+        while (pos < len) {
+            size_t recLen;
+            if (binary) {
+                if (len - pos < sizeof(LogBinHeader)) break;
+                recLen = sizeof(LogBinHeader) + ((const LogBinHeader*)&data[pos])->length;
+                if (recLen > len - pos) break;
+            } else {
+                const uint8_t* nl = (const uint8_t*)memchr(&data[pos], '\n', len - pos);
+                recLen = nl ? (size_t)(nl - &data[pos]) + 1 : len - pos;
+            }
+            
+            uint32_t timestampMs;
+            if (recordTimestamp(&data[pos], recLen, binary, &timestampMs) &&
+                timestampMs >= fromMs && timestampMs <= toMs) {
+                records++;
+                if (!callback(timestampMs, (const char*)&data[pos], recLen)) return false;
+            }
+            pos += recLen;
+        }
+        return true;
+    }, boot);
+    
+    xSemaphoreGive(drainMutex);
+    
+    return blocks < 0 ? -1 : records;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // BOOT LOG
 // ═══════════════════════════════════════════════════════════════════════════
 
 bool LogManager::logBootStart(const char* reason, uint32_t freeHeap, const char* version) {
-    String line = getTimestamp() + " INFO - Boot Start";
-    line += " | Reason: " + String(reason);
-    line += " | Version: " + String(version);
-    line += " | Free Heap: " + String(freeHeap) + " bytes";
-    line += " | Chip: " + String(ESP.getChipModel());
-    line += " | CPU: " + String(ESP.getCpuFreqMHz()) + " MHz";
+    if (mode == LogMode::BINARY) {
+        LogBinBootStart rec = { freeHeap, (uint16_t)ESP.getCpuFreqMHz() };
+        return writeBinary(LogChannel::BOOT, LOG_BIN_BOOT_START, &rec, sizeof(rec),
+                           reason, version, ESP.getChipModel());
+    }
+    
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis()) << " INFO - Boot Start"
+         << " | Reason: " << reason
+         << " | Version: " << version
+         << " | Free Heap: " << freeHeap << " bytes"
+         << " | Chip: " << ESP.getChipModel()
+         << " | CPU: " << (uint32_t)ESP.getCpuFreqMHz() << " MHz";
     
-    return writeLine(LOG_FILE_BOOT, line);
+    return writeLine(LogChannel::BOOT, line);
 }
 
 bool LogManager::logSetupStep(const char* module, bool success, const char* message) {
-    String line = getTimestamp();
-    line += success ? " INFO - " : " ERROR - ";
-    line += "Setup: " + String(module);
-    line += success ? " [OK]" : " [FAILED]";
+    if (mode == LogMode::BINARY) {
+        LogBinSetupStep rec = { (uint8_t)success };
+        return writeBinary(LogChannel::BOOT, LOG_BIN_SETUP_STEP, &rec, sizeof(rec), module, message);
+    }
+    
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis())
+         << (success ? " INFO - " : " ERROR - ")
+         << "Setup: " << module
+         << (success ? " [OK]" : " [FAILED]");
     
     if (message) {
-        line += " | " + String(message);
+        line << " | " << message;
     }
     
-    return writeLine(LOG_FILE_BOOT, line);
+    return writeLine(LogChannel::BOOT, line);
 }
 
 bool LogManager::logBootComplete(uint32_t totalTimeMs, bool success) {
-    String line = getTimestamp();
-    line += success ? " INFO - " : " ERROR - ";
-    line += "Boot Complete";
-    line += " | Time: " + String(totalTimeMs) + "ms";
-    line += " | Free Heap: " + String(ESP.getFreeHeap()) + " bytes";
-    line += success ? " [SUCCESS]" : " [FAILED]";
+    if (mode == LogMode::BINARY) {
+        LogBinBootComplete rec = { totalTimeMs, (uint32_t)ESP.getFreeHeap(), (uint8_t)success };
+        return writeBinary(LogChannel::BOOT, LOG_BIN_BOOT_COMPLETE, &rec, sizeof(rec));
+    }
+    
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis())
+         << (success ? " INFO - " : " ERROR - ")
+         << "Boot Complete"
+         << " | Time: " << totalTimeMs << "ms"
+         << " | Free Heap: " << (uint32_t)ESP.getFreeHeap() << " bytes"
+         << (success ? " [SUCCESS]" : " [FAILED]");
     
     // Leere Zeile als Separator
-    writeLine(LOG_FILE_BOOT, "");
+    if (sd.isAvailable()) enqueue(LogChannel::BOOT, "", 0);
     
-    return writeLine(LOG_FILE_BOOT, line);
+    return writeLine(LogChannel::BOOT, line);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -84,27 +293,37 @@ bool LogManager::logBootComplete(uint32_t totalTimeMs, bool success) {
 // ═══════════════════════════════════════════════════════════════════════════
 
 bool LogManager::logBattery(float voltage, uint8_t percent, bool isLow, bool isCritical) {
-    String line = getTimestamp();
+    if (mode == LogMode::BINARY) {
+        LogBinBattery rec;
+        rec.voltageMv = voltage > 0.0f ? (uint16_t)lroundf(voltage * 1000.0f) : 0;
+        rec.percent = percent;
+        rec.flags = (isLow ? LOG_BIN_FLAG_LOW : 0) | (isCritical ? LOG_BIN_FLAG_CRITICAL : 0);
+        return writeBinary(LogChannel::BATTERY, LOG_BIN_BATTERY, &rec, sizeof(rec));
+    }
+    
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis());
     
     if (isCritical) {
-        line += " CRITICAL - ";
+        line << " CRITICAL - ";
     } else if (isLow) {
-        line += " WARN - ";
+        line << " WARN - ";
     } else {
-        line += " INFO - ";
+        line << " INFO - ";
     }
     
-    line += "Battery";
-    line += " | Voltage: " + String(voltage, 2) + "V";
-    line += " | Percent: " + String(percent) + "%";
+    line << "Battery"
+         << " | Voltage: " << LogFixed(voltage, 2) << "V"
+         << " | Percent: " << percent << "%";
     
     if (isCritical) {
-        line += " [CRITICAL]";
+        line << " [CRITICAL]";
     } else if (isLow) {
-        line += " [LOW]";
+        line << " [LOW]";
     }
     
-    return writeLine(LOG_FILE_BATTERY, line);
+    return writeLine(LogChannel::BATTERY, line);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -112,35 +331,56 @@ bool LogManager::logBattery(float voltage, uint8_t percent, bool isLow, bool isC
 // ═══════════════════════════════════════════════════════════════════════════
 
 bool LogManager::logConnection(const char* peerMac, const char* event, int8_t rssi) {
-    String line = getTimestamp() + " INFO - ";
-    line += "ESP-NOW: " + String(event);
-    line += " | Peer: " + String(peerMac);
+    if (mode == LogMode::BINARY) {
+        LogBinConnection rec = {};
+        EspNowManager::stringToMac(peerMac, rec.mac);
+        rec.rssi = rssi;
+        return writeBinary(LogChannel::CONNECTION, LOG_BIN_CONNECTION, &rec, sizeof(rec), event);
+    }
+    
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis()) << " INFO - "
+         << "ESP-NOW: " << event
+         << " | Peer: " << peerMac;
     
     if (rssi != 0) {
-        line += " | RSSI: " + String(rssi) + " dBm";
+        line << " | RSSI: " << rssi << " dBm";
     }
     
-    return writeLine(LOG_FILE_CONNECTION, line);
+    return writeLine(LogChannel::CONNECTION, line);
 }
 
 bool LogManager::logConnectionStats(const char* peerMac, uint32_t packetsSent, 
                                      uint32_t packetsReceived, uint32_t packetsLost, int8_t avgRssi) {
-    String line = getTimestamp() + " INFO - ";
-    line += "ESP-NOW Stats";
-    line += " | Peer: " + String(peerMac);
-    line += " | Sent: " + String(packetsSent);
-    line += " | Received: " + String(packetsReceived);
-    line += " | Lost: " + String(packetsLost);
+    if (mode == LogMode::BINARY) {
+        LogBinConnectionStats rec = {};
+        EspNowManager::stringToMac(peerMac, rec.mac);
+        rec.sent = packetsSent;
+        rec.received = packetsReceived;
+        rec.lost = packetsLost;
+        rec.avgRssi = avgRssi;
+        return writeBinary(LogChannel::CONNECTION, LOG_BIN_CONNECTION_STATS, &rec, sizeof(rec));
+    }
+    
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis()) << " INFO - "
+         << "ESP-NOW Stats"
+         << " | Peer: " << peerMac
+         << " | Sent: " << packetsSent
+         << " | Received: " << packetsReceived
+         << " | Lost: " << packetsLost;
     
     // Loss-Rate berechnen
     if (packetsSent > 0) {
         float lossRate = (packetsLost * 100.0f) / packetsSent;
-        line += " | Loss: " + String(lossRate, 1) + "%";
+        line << " | Loss: " << LogFixed(lossRate, 1) << "%";
     }
     
-    line += " | Avg RSSI: " + String(avgRssi) + " dBm";
+    line << " | Avg RSSI: " << avgRssi << " dBm";
     
-    return writeLine(LOG_FILE_CONNECTION, line);
+    return writeLine(LogChannel::CONNECTION, line);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -148,29 +388,38 @@ bool LogManager::logConnectionStats(const char* peerMac, uint32_t packetsSent,
 // ═══════════════════════════════════════════════════════════════════════════
 
 bool LogManager::logError(const char* module, int errorCode, const char* message, uint32_t freeHeap) {
-    String line = getTimestamp() + " ERROR - ";
-    line += String(module);
-    line += " | Code: " + String(errorCode);
-    line += " | " + String(message);
-    
-    if (freeHeap > 0) {
-        line += " | Free Heap: " + String(freeHeap) + " bytes";
-    } else {
-        line += " | Free Heap: " + String(ESP.getFreeHeap()) + " bytes";
+    if (mode == LogMode::BINARY) {
+        LogBinError rec = { (int32_t)errorCode, freeHeap > 0 ? freeHeap : (uint32_t)ESP.getFreeHeap() };
+        return writeBinary(LogChannel::ERRORS, LOG_BIN_ERROR, &rec, sizeof(rec), module, message);
     }
     
-    return writeLine(LOG_FILE_ERROR, line);
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis()) << " ERROR - "
+         << module
+         << " | Code: " << errorCode
+         << " | " << message
+         << " | Free Heap: " << (freeHeap > 0 ? freeHeap : (uint32_t)ESP.getFreeHeap()) << " bytes";
+    
+    return writeLine(LogChannel::ERRORS, line);
 }
 
 bool LogManager::logCrash(uint32_t pc, uint32_t excvaddr, uint32_t exccause) {
-    String line = getTimestamp() + " FATAL - ";
-    line += "CRASH";
-    line += " | PC: 0x" + String(pc, HEX);
-    line += " | ExcVAddr: 0x" + String(excvaddr, HEX);
-    line += " | ExcCause: " + String(exccause);
-    line += " | Free Heap: " + String(ESP.getFreeHeap()) + " bytes";
+    if (mode == LogMode::BINARY) {
+        LogBinCrash rec = { pc, excvaddr, exccause, (uint32_t)ESP.getFreeHeap() };
+        return writeBinary(LogChannel::ERRORS, LOG_BIN_CRASH, &rec, sizeof(rec));
+    }
+    
+    char buf[LOG_RECORD_SIZE];
+    LogLine line(buf, sizeof(buf));
+    line << LogTime(millis()) << " FATAL - "
+         << "CRASH"
+         << " | PC: 0x" << LogHex(pc)
+         << " | ExcVAddr: 0x" << LogHex(excvaddr)
+         << " | ExcCause: " << exccause
+         << " | Free Heap: " << (uint32_t)ESP.getFreeHeap() << " bytes";
     
-    return writeLine(LOG_FILE_ERROR, line);
+    return writeLine(LogChannel::ERRORS, line);
 }
 
 void LogManager::printInfo() {
@@ -180,22 +429,35 @@ void LogManager::printInfo() {
     
     DEBUG_PRINTF("SD Card:    %s\n", sd.isAvailable() ? "✅ Available" : "❌ Not available");
     
+    LogStats s;
+    getStats(&s);
+    DEBUG_PRINTF("Format:     %s\n", mode == LogMode::BINARY ? "Binär (LogSchema.h)" : "Text");
+    DEBUG_PRINTF("Writer:     %s\n", writerHandle ? "✅ Läuft" : "❌ Synchron");
+    DEBUG_PRINTF("Ring:       %d / %d (max %u)\n", getPending(), LOG_RING_SLOTS, s.highWater);
+    DEBUG_PRINTF("Records:    %lu ein / %lu geschrieben / %lu verworfen / %lu gekürzt\n",
+                 s.enqueued, s.written, s.dropped, s.truncated);
+    DEBUG_PRINTF("Fehler:     %lu Schreibfehler, Einreihen max %lu µs\n",
+                 s.writeErrors, s.maxEnqueueUs);
+    
     if (sd.isAvailable()) {
-        DEBUG_PRINTLN("\n─── Log Files ─────────────────────────────────");
-        
-        const char* logFiles[] = {
-            LOG_FILE_BOOT,
-            LOG_FILE_BATTERY,
-            LOG_FILE_CONNECTION,
-            LOG_FILE_ERROR
-        };
+        DEBUG_PRINTLN("\n─── Log Files (Ringdateien) ───────────────────");
         
-        for (int i = 0; i < 4; i++) {
-            if (sd.fileExists(logFiles[i])) {
-                size_t size = sd.getFileSize(logFiles[i]);
-                DEBUG_PRINTF("  %s: %.2f KB\n", logFiles[i], size / 1024.0);
-            } else {
-                DEBUG_PRINTF("  %s: [not exist]\n", logFiles[i]);
+        for (int i = 0; i < static_cast<int>(LogChannel::COUNT); i++) {
+            const char* logFile = channelFile(static_cast<LogChannel>(i));
+            if (!stores[i].isOpen()) {
+                DEBUG_PRINTF("  %s: [nicht geöffnet]\n", logFile);
+                continue;
+            }
+            CircularLogStats rs;
+            stores[i].getStats(&rs);
+            DEBUG_PRINTF("  %s: %.2f / %.2f KB, %lu Blöcke (%lu überschrieben), %lu Index, max %lu µs\n",
+                         logFile, stores[i].getUsedBytes() / 1024.0, stores[i].getCapacity() / 1024.0,
+                         rs.blockWrites, rs.overwritten, rs.indexWrites, rs.maxWriteUs);
+            if (rs.packedBytes > 0) {
+                DEBUG_PRINTF("    LZ%s: %.2f:1 (%lu → %lu Bytes), %.1f µs/KB\n",
+                             stores[i].isCompressed() ? "" : " (aus)",
+                             (float)rs.rawBytes / rs.packedBytes, rs.rawBytes, rs.packedBytes,
+                             rs.compressUs * 1024.0f / rs.rawBytes);
             }
         }
     }
@@ -207,40 +469,188 @@ void LogManager::printInfo() {
 // PRIVATE METHODEN
 // ═══════════════════════════════════════════════════════════════════════════
 
-String LogManager::getTimestamp() {
-    unsigned long ms = millis();
+bool LogManager::writeLine(LogChannel channel, const LogLine& line) {
+    if (!sd.isAvailable()) return false;
     
-    // Format: [12345ms]
-    return "[" + String(ms) + "ms]";
+    return enqueue(channel, line.c_str(), line.length(), line.isTruncated());
 }
 
-bool LogManager::writeLine(const char* logFile, const String& line) {
+bool LogManager::writeBinary(LogChannel channel, uint8_t type, const void* fields, size_t fieldLen,
+                             const char* text1, const char* text2, const char* text3) {
     if (!sd.isAvailable()) return false;
     
-    // Log rotieren falls nötig
-    rotateLogIfNeeded(logFile);
+    // Record muss in einen Ring-Slot passen, Payload-Länge ist 8 Bit
+    const size_t limit = (LOG_RECORD_SIZE - 1 < sizeof(LogBinHeader) + 255)
+                         ? LOG_RECORD_SIZE - 1 : sizeof(LogBinHeader) + 255;
+    uint8_t buf[LOG_RECORD_SIZE];
+    size_t len = sizeof(LogBinHeader);
+    
+    memcpy(&buf[len], fields, fieldLen);
+    len += fieldLen;
+    
+    // Text-Felder null-terminiert anhängen (gekürzt, Platz für folgende Terminatoren bleibt)
+    const char* texts[3] = { text1, text2, text3 };
+    uint8_t count = logBinTextFields(type);
+    bool clipped = false;
+    for (uint8_t i = 0; i < count && i < 3; i++) {
+        const char* text = texts[i] ? texts[i] : "";
+        size_t n = strlen(text);
+        size_t room = limit - len - (count - i);
+        if (n > room) {
+            n = room;
+            clipped = true;
+        }
+        memcpy(&buf[len], text, n);
+        len += n;
+        buf[len++] = '\0';
+    }
     
-    // Zeile anhängen
-    return sd.appendLine(logFile, line);
+    LogBinHeader header;
+    header.type = type;
+    header.length = len - sizeof(LogBinHeader);
+    header.timestampMs = millis();
+    memcpy(buf, &header, sizeof(header));
+    
+    return enqueue(channel, (const char*)buf, len, clipped, true);
 }
 
-void LogManager::rotateLogIfNeeded(const char* logFile) {
-    size_t fileSize = sd.getFileSize(logFile);
+bool LogManager::enqueue(LogChannel channel, const char* text, size_t len, bool clipped, bool raw) {
+    int64_t startUs = esp_timer_get_time();
+    
+    bool truncated = clipped || len > LOG_RECORD_SIZE - 1;
+    if (truncated) len = LOG_RECORD_SIZE - 1;
     
-    if (fileSize > LOG_MAX_FILE_SIZE) {
-        DEBUG_PRINTF("LogManager: Rotiere Log: %s (%.2f KB)\n", logFile, fileSize / 1024.0);
+    // Kopie in den Slot unter Spinlock (kurz, mehrere Produzenten möglich)
+    bool queued = false;
+    uint32_t pending;
+    portENTER_CRITICAL(&ringMux);
+    pending = ringHead - ringTail;
+    if (pending < LOG_RING_SLOTS) {
+        LogRecord& rec = ring[ringHead & (LOG_RING_SLOTS - 1)];
+        rec.timestampMs = millis();
+        rec.channel = channel;
+        memcpy(rec.text, text, len);
+        if (raw) {
+            rec.length = len;
+        } else {
+            rec.text[len] = '\n';
+            rec.length = len + 1;
+        }
+        ringHead = ringHead + 1;
+        pending++;
         
-        // Backup-Name erstellen (z.B. boot.log -> boot.log.1)
-        String backupPath = String(logFile) + ".1";
+        stats.enqueued++;
+        if (truncated) stats.truncated++;
+        if (pending > stats.highWater) stats.highWater = pending;
+        queued = true;
+    } else {
+        stats.dropped++;
+    }
+    portEXIT_CRITICAL(&ringMux);
+    
+    uint32_t elapsed = esp_timer_get_time() - startUs;
+    if (elapsed > stats.maxEnqueueUs) stats.maxEnqueueUs = elapsed;
+    
+    if (!queued) return false;
+    
+    if (!writerHandle) {
+        // Kein Writer-Task → synchron schreiben (altes Verhalten)
+        flush();
+    } else if (channel == LogChannel::ERRORS || pending >= LOG_RING_SLOTS / 4) {
+        // Fehler sofort, sonst erst ab einem Viertel Füllung wecken (Batching)
+        xTaskNotifyGive(writerHandle);
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WRITER-TASK
+// ═══════════════════════════════════════════════════════════════════════════
+
+void LogManager::writerTask(void* parameter) {
+    LogManager* log = static_cast<LogManager*>(parameter);
+    
+    DEBUG_PRINTLN("LogManager: Writer-Task gestartet");
+    
+    while (log->writerRunning) {
+        // Auf Weckruf oder Flush-Intervall warten
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_FLUSH_INTERVAL_MS));
+        if (!log->writerRunning) break;
         
-        // Altes Backup löschen
-        if (sd.fileExists(backupPath.c_str())) {
-            sd.deleteFile(backupPath.c_str());
+        if (xSemaphoreTake(log->drainMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+            if (log->getPending() > 0) log->drain();
+            
+            // Teilblöcke der Ringdateien nach Alter schreiben
+            for (auto& store : log->stores) {
+                store.flushIfDue(SD_FLUSH_INTERVAL_MS);
+            }
+            xSemaphoreGive(log->drainMutex);
         }
         
-        // Aktuelle Datei umbenennen
-        sd.renameFile(logFile, backupPath.c_str());
+        // Teilpuffer der übrigen SD-Handles (appendFile anderer Module) nach Alter schreiben
+        log->sd.flushIfDue();
+    }
+    
+    vTaskDelete(nullptr);
+}
+
+void LogManager::shutdownHandler() {
+    if (instance) {
+        instance->flush(200);
+    }
+}
+
+void LogManager::drain() {
+    // drainMutex muss gehalten werden (vor begin() gibt es nur den Aufrufer)
+    while (ringTail != ringHead) {
+        const LogRecord& rec = ring[ringTail & (LOG_RING_SLOTS - 1)];
+        
+        // In den RAM-Block der Ringdatei, SD-Zugriff nur bei vollem Block
+        bool ok = stores[static_cast<int>(rec.channel)].append((const uint8_t*)rec.text, rec.length,
+                                                                rec.timestampMs);
         
-        DEBUG_PRINTF("LogManager: ✅ Log rotiert zu: %s\n", backupPath.c_str());
+        portENTER_CRITICAL(&ringMux);
+        if (ok) {
+            stats.written++;
+        } else {
+            stats.writeErrors++;
+        }
+        ringTail = ringTail + 1;
+        portEXIT_CRITICAL(&ringMux);
+    }
+}
+
+bool LogManager::recordTimestamp(const uint8_t* data, size_t len, bool binary, uint32_t* timestampMs) {
+    if (binary) {
+        if (len < sizeof(LogBinHeader)) return false;
+        *timestampMs = ((const LogBinHeader*)data)->timestampMs;
+        return true;
+    }
+    
+    // "[12345ms] ..."
+    if (len < 2 || data[0] != '[' || data[1] < '0' || data[1] > '9') return false;
+    uint32_t value = 0;
+    for (size_t i = 1; i < len && data[i] >= '0' && data[i] <= '9'; i++) {
+        value = value * 10 + (data[i] - '0');
+    }
+    *timestampMs = value;
+    return true;
+}
+
+const char* LogManager::channelFile(LogChannel channel) const {
+    if (mode == LogMode::BINARY) {
+        switch (channel) {
+            case LogChannel::BOOT:       return LOG_BIN_FILE_BOOT;
+            case LogChannel::BATTERY:    return LOG_BIN_FILE_BATTERY;
+            case LogChannel::CONNECTION: return LOG_BIN_FILE_CONNECTION;
+            default:                     return LOG_BIN_FILE_ERROR;
+        }
+    }
+    
+    switch (channel) {
+        case LogChannel::BOOT:       return LOG_FILE_BOOT;
+        case LogChannel::BATTERY:    return LOG_FILE_BATTERY;
+        case LogChannel::CONNECTION: return LOG_FILE_CONNECTION;
+        default:                     return LOG_FILE_ERROR;
     }
 }
\ No newline at end of file
@@ -7,15 +7,27 @@
  * - Zeilenweise Logs (kein JSON!)
  * - Verschiedene Log-Typen (Boot, Battery, Connection, Error)
  * - Automatisches Timestamp
- * - Log-Rotation bei Größenüberschreitung
+ * - Vorallokierte Ringdatei pro Kanal (CircularLog): Überschreiben an Ort und
+ *   Stelle statt Rotation, kein Rename/Delete/Cluster-Allokation im Dauerbetrieb
+ * - Allokationsfreie Formatierung (LogLine, kein String/Heap im Log-Pfad)
+ * - Optional binär: feste Records nach LogSchema.h (Decoder: tools/logdecode)
+ * - Asynchron: log*() legt Records in einen RAM-Ring, ein Writer-Task
+ *   mit niedriger Priorität schreibt sie gebündelt auf die SD-Karte
  */
 
 #ifndef LOG_MANAGER_H
 #define LOG_MANAGER_H
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <functional>
 #include "config.h"
 #include "SDCardHandler.h"
+#include "LogFormat.h"
+#include "LogSchema.h"
+#include "CircularLog.h"
 
 // Log-Dateinamen
 #define LOG_FILE_BOOT       "/boot.log"
@@ -23,9 +35,102 @@
 #define LOG_FILE_CONNECTION "/connection.log"
 #define LOG_FILE_ERROR      "/error.log"
 
-// Log-Rotation
+// Binär-Dateinamen (LogMode::BINARY)
+#define LOG_BIN_FILE_BOOT       "/boot.bin"
+#define LOG_BIN_FILE_BATTERY    "/battery.bin"
+#define LOG_BIN_FILE_CONNECTION "/connection.bin"
+#define LOG_BIN_FILE_ERROR      "/error.bin"
+
+#ifndef LOG_BINARY
+#define LOG_BINARY          0       // 1 = Binär-Records statt Textzeilen
+#endif
+
+// Größe der Ringdatei pro Kanal (einmalig vorallokiert)
 #define LOG_MAX_FILE_SIZE   1048576 // 1 MB
 
+#ifndef LOG_COMPRESS_CHANNELS
+#define LOG_COMPRESS_CHANNELS   0x00    // LZ-Kompression: Bit i = LogChannel i (0x04 = CONNECTION)
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ASYNCHRONES SCHREIBEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifndef LOG_RING_SLOTS
+#define LOG_RING_SLOTS          64      // Records im RAM-Ring (vorallokiert)
+#endif
+
+#ifndef LOG_RECORD_SIZE
+#define LOG_RECORD_SIZE         192     // Max. Zeilenlänge inkl. Newline (länger = gekürzt)
+#endif
+
+#ifndef LOG_FLUSH_INTERVAL_MS
+#define LOG_FLUSH_INTERVAL_MS   500     // Writer schreibt spätestens nach dieser Zeit
+#endif
+
+#ifndef LOG_WRITER_PRIORITY
+#define LOG_WRITER_PRIORITY     1       // Unter ESP-NOW Worker (5) und Motor-Ausgabe (10)
+#endif
+
+#ifndef LOG_WRITER_CORE
+#define LOG_WRITER_CORE         0       // Protokoll-Core, weg von Worker und Motor-Task
+#endif
+
+#ifndef LOG_WRITER_STACK_SIZE
+#define LOG_WRITER_STACK_SIZE   4096    // Writer-Task Stack
+#endif
+
+/**
+ * Log-Kanal (eine Datei pro Kanal)
+ */
+enum class LogChannel : uint8_t {
+    BOOT = 0,
+    BATTERY,
+    CONNECTION,
+    ERRORS,
+    COUNT
+};
+
+/**
+ * Log-Format
+ */
+enum class LogMode : uint8_t {
+    TEXT = 0,                       // Textzeilen ([12345ms] INFO - ...)
+    BINARY                          // Records nach LogSchema.h
+};
+
+/**
+ * Eintrag im RAM-Ring
+ */
+struct LogRecord {
+    uint32_t timestampMs;           // millis() beim Einreihen
+    LogChannel channel;
+    uint16_t length;                // Bytes in text (Textzeile inkl. Newline oder Binär-Record)
+    char text[LOG_RECORD_SIZE];
+};
+
+/**
+ * Callback für readRange(): ein Record im Zeitfenster
+ * @param timestampMs Zeitstempel des Records
+ * @param data Textzeile inkl. Newline oder Binär-Record (LogSchema.h)
+ * @param len Länge in Bytes
+ * @return false = Abfrage abbrechen
+ */
+typedef std::function<bool(uint32_t timestampMs, const char* data, size_t len)> LogRangeCallback;
+
+/**
+ * Statistik des asynchronen Schreibpfads
+ */
+struct LogStats {
+    uint32_t enqueued;              // Eingereihte Records
+    uint32_t written;               // Auf SD geschriebene Records
+    uint32_t dropped;               // Verworfen (Ring voll)
+    uint32_t truncated;             // Gekürzt (> LOG_RECORD_SIZE)
+    uint32_t writeErrors;           // Fehlgeschlagene SD-Schreibvorgänge
+    uint32_t maxEnqueueUs;          // Längstes Einreihen (µs)
+    uint16_t highWater;             // Maximale Ring-Füllung
+};
+
 class LogManager {
 public:
     /**
@@ -36,9 +141,70 @@ public:
 
     /**
      * Log-Manager initialisieren
+     * @param logMode Text- oder Binär-Records (fest bis end())
      * @return true bei Erfolg
      */
-    bool begin();
+    bool begin(LogMode logMode = LOG_BINARY ? LogMode::BINARY : LogMode::TEXT);
+
+    /**
+     * Writer-Task stoppen (ausstehende Records werden vorher geschrieben)
+     */
+    void end();
+
+    /**
+     * Ausstehende Records sofort schreiben
+     * @param timeoutMs Max. Wartezeit auf den Writer-Task
+     * @return true wenn der Ring leer ist
+     */
+    bool flush(uint32_t timeoutMs = 1000);
+
+    /**
+     * Aktives Log-Format
+     */
+    LogMode getMode() const { return mode; }
+
+    /**
+     * Statistik abrufen
+     */
+    void getStats(LogStats* stats);
+
+    /**
+     * Ausstehende Records im Ring
+     */
+    int getPending();
+
+    /**
+     * Belegte Bytes eines Kanals in seiner Ringdatei (ohne SD-Zugriff)
+     */
+    size_t getChannelSize(LogChannel channel) const;
+
+    /**
+     * LZ-Kompression eines Kanals umschalten (gilt ab dem nächsten Block)
+     * Verhältnis und CPU-Zeit pro KB zeigt printInfo()
+     */
+    void setCompression(LogChannel channel, bool enable);
+
+    /**
+     * Records eines Kanals aus einem Zeitfenster lesen (älteste zuerst)
+     * Ausstehende Records werden vorher übernommen; über den Zeitindex der
+     * Ringdatei werden nur die betroffenen Blöcke von der SD gelesen.
+     * millis() beginnt bei jedem Neustart bei 0: geliefert werden nur Records
+     * eines Boots (Standard: aktueller, frühere siehe getBoot()).
+     * @param channel Log-Kanal
+     * @param fromMs Beginn in millis() (inklusive)
+     * @param toMs Ende in millis() (inklusive)
+     * @param callback Aufruf pro Record
+     * @param boot Boot-Nummer der Ringdatei (0 = aktueller Boot)
+     * @return Anzahl gelieferter Records, -1 bei Fehler
+     */
+    int readRange(LogChannel channel, uint32_t fromMs, uint32_t toMs, LogRangeCallback callback,
+                  uint32_t boot = 0);
+
+    /**
+     * Boot-Nummer eines Kanals (zählt pro Ringdatei bei jedem Start hoch, 0 = nicht geöffnet)
+     * @param channel Log-Kanal
+     */
+    uint32_t getBoot(LogChannel channel) const;
 
     /**
      * Alle Logs löschen
@@ -136,25 +302,71 @@ public:
 
 private:
     SDCardHandler& sd;          // Referenz zum SD-Handler
+    LogMode mode;               // Text oder Binär
+    
+    // RAM-Ring (mehrere Produzenten, ein Writer)
+    LogRecord ring[LOG_RING_SLOTS];
+    volatile uint32_t ringHead;         // Nächster freier Slot (Produzenten)
+    volatile uint32_t ringTail;         // Nächster zu schreibender Slot (Writer)
+    portMUX_TYPE ringMux;
+    LogStats stats;                     // Zähler unter ringMux
+    
+    // Writer-Task
+    TaskHandle_t writerHandle;
+    volatile bool writerRunning;
+    SemaphoreHandle_t drainMutex;       // Nur ein Leerlauf gleichzeitig (Task oder flush)
+    
+    // Ringdatei pro Kanal (Zugriff nur mit drainMutex)
+    CircularLog stores[static_cast<int>(LogChannel::COUNT)];
+    
+    static LogManager* instance;        // Für Shutdown-Hook
+    
+    static void writerTask(void* parameter);
+    static void shutdownHandler();
     
     /**
-     * Timestamp erstellen (Format: [12345ms])
+     * Ring leeren: Records in die Ringdateien übernehmen (Writer-Kontext)
      */
-    String getTimestamp();
+    void drain();
     
     /**
-     * Log-Zeile schreiben
-     * @param logFile Dateiname
-     * @param line Log-Zeile
-     * @return true bei Erfolg
+     * Zeitstempel eines Records aus seinen Bytes lesen
+     * Text: "[<ms>ms] ..." am Zeilenanfang, Binär: LogBinHeader::timestampMs
+     */
+    static bool recordTimestamp(const uint8_t* data, size_t len, bool binary, uint32_t* timestampMs);
+    
+    /**
+     * Dateiname eines Kanals (abhängig vom Log-Format)
+     */
+    const char* channelFile(LogChannel channel) const;
+    
+    /**
+     * Log-Zeile einreihen (kehrt sofort zurück)
+     * @param channel Log-Kanal
+     * @param line Formatierte Log-Zeile
+     * @return true wenn eingereiht
+     */
+    bool writeLine(LogChannel channel, const LogLine& line);
+    
+    /**
+     * Binär-Record einreihen (LogSchema.h)
+     * @param channel Log-Kanal
+     * @param type Record-Typ (LogBinType)
+     * @param fields Feste Felder (packed struct des Typs)
+     * @param fieldLen Größe der festen Felder
+     * @param text1..text3 Text-Felder (Anzahl laut logBinTextFields, nullptr = leer)
+     * @return true wenn eingereiht
      */
-    bool writeLine(const char* logFile, const String& line);
+    bool writeBinary(LogChannel channel, uint8_t type, const void* fields, size_t fieldLen,
+                     const char* text1 = nullptr, const char* text2 = nullptr,
+                     const char* text3 = nullptr);
     
     /**
-     * Log-Datei rotieren wenn zu groß
-     * @param logFile Dateiname
+     * Record in den Ring kopieren
+     * @param clipped Zeile wurde bereits beim Formatieren gekürzt
+     * @param raw Binär-Record (kein Newline anhängen)
      */
-    void rotateLogIfNeeded(const char* logFile);
+    bool enqueue(LogChannel channel, const char* text, size_t len, bool clipped = false, bool raw = false);
 };
 
 // Globale Instanz (wird in .cpp definiert und in main.ino extern deklariert)
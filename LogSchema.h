@@ -0,0 +1,336 @@
+/**
+ * LogSchema.h
+ *
+ * Schema der binären Log-Records
+ *
+ * Gemeinsam genutzt von LogManager (Firmware) und tools/logdecode (Linux).
+ * Nur <stdint.h>, keine Arduino-Abhängigkeiten.
+ *
+ * Ringdatei (CircularLog, Standard ab Firmware mit vorallokierten Logs):
+ *   LogRingHeader im ersten Block, danach blockCount Blöcke à LOG_RING_BLOCK_SIZE
+ *   Jeder Block: LogRingBlockHeader + used Bytes Records (Records überspannen
+ *   keine Blockgrenze). Gültig sind Blöcke mit tailSeq <= seq, Reihenfolge nach seq.
+ *   Bei rawLen > 0 sind die used Bytes LZ-komprimiert (LogCompress.h) und ergeben
+ *   rawLen Bytes Records; jeder Block ist für sich dekodierbar.
+ *   Block-Index = (seq - 1) % blockCount
+ *   Beim Anlegen wird nur die Dateigröße reserviert; genullt sind die ersten
+ *   initBlocks Datenblöcke, der Rest enthält alte Karteninhalte und wird vor dem
+ *   ersten Umlauf schrittweise genullt (initBlocks 0 = alle, ältere Dateien).
+ *
+ * Zeitindex (Sidecar "<ringdatei>.idx"):
+ *   LogRingIndexHeader, danach ein LogRingIndexEntry pro Gruppe von stride Blöcken
+ *   (Gruppe g = Block-Index g*stride ...), geschrieben wenn die Gruppe voll ist.
+ *   Ein Eintrag gilt nur, wenn der Block am Gruppenanfang noch dieselbe Sequenz
+ *   trägt. Min/Max statt erstem/letztem Zeitstempel, da millis() beim Neustart
+ *   wieder bei 0 beginnt.
+ *
+ * Boot-Nummer:
+ *   Wird bei jedem Öffnen der Ringdatei erhöht und im Kopf gespeichert. Ein Block
+ *   enthält nur Records eines Boots (LogRingBlockHeader::boot); Zeitstempel sind
+ *   nur innerhalb eines Boots vergleichbar.
+ *
+ * Einfache Datei (ältere Firmware):
+ *   LogBinFileHeader (8 Bytes, einmal am Dateianfang)
+ *   Records: LogBinHeader (6 Bytes) + Payload (LogBinHeader::length Bytes)
+ *
+ * Payload:
+ *   Feste Felder (packed struct des Typs, little-endian)
+ *   danach logBinTextFields(type) null-terminierte Strings
+ *
+ * Flight-Recorder-Dump (FlightRecorder, "/flightN.bin"):
+ *   FlightDumpHeader, danach FlightRecordHeader + len Bytes pro Eintrag
+ *
+ * Änderungen am Layout eines Typs → LOG_BIN_VERSION erhöhen.
+ * Neue Typen dürfen angehängt werden (Decoder überspringt unbekannte Typen).
+ */
+
+#ifndef LOG_SCHEMA_H
+#define LOG_SCHEMA_H
+
+#include <stdint.h>
+
+#define LOG_BIN_MAGIC       "ELOG"  // Datei-Kennung (4 Zeichen)
+#define LOG_BIN_VERSION     1       // Schema-Version
+
+/**
+ * Record-Typen
+ */
+enum LogBinType : uint8_t {
+    LOG_BIN_BOOT_START = 1,
+    LOG_BIN_SETUP_STEP,
+    LOG_BIN_BOOT_COMPLETE,
+    LOG_BIN_BATTERY,
+    LOG_BIN_CONNECTION,
+    LOG_BIN_CONNECTION_STATS,
+    LOG_BIN_ERROR,
+    LOG_BIN_CRASH,
+    LOG_BIN_TYPE_COUNT
+};
+
+// Battery-Flags
+#define LOG_BIN_FLAG_LOW        0x01
+#define LOG_BIN_FLAG_CRITICAL   0x02
+
+/**
+ * Datei-Header
+ */
+struct __attribute__((packed)) LogBinFileHeader {
+    char magic[4];                  // LOG_BIN_MAGIC
+    uint8_t version;                // LOG_BIN_VERSION
+    uint8_t reserved[3];
+};
+
+/**
+ * Record-Header
+ */
+struct __attribute__((packed)) LogBinHeader {
+    uint8_t type;                   // LogBinType
+    uint8_t length;                 // Payload-Bytes nach dem Header
+    uint32_t timestampMs;           // millis()
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PAYLOADS (feste Felder)
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct __attribute__((packed)) LogBinBootStart {
+    uint32_t freeHeap;
+    uint16_t cpuMhz;
+    // Text: reason, version, chip
+};
+
+struct __attribute__((packed)) LogBinSetupStep {
+    uint8_t success;
+    // Text: module, message
+};
+
+struct __attribute__((packed)) LogBinBootComplete {
+    uint32_t totalTimeMs;
+    uint32_t freeHeap;
+    uint8_t success;
+};
+
+struct __attribute__((packed)) LogBinBattery {
+    uint16_t voltageMv;
+    uint8_t percent;
+    uint8_t flags;                  // LOG_BIN_FLAG_*
+};
+
+struct __attribute__((packed)) LogBinConnection {
+    uint8_t mac[6];
+    int8_t rssi;                    // 0 = unbekannt
+    // Text: event
+};
+
+struct __attribute__((packed)) LogBinConnectionStats {
+    uint8_t mac[6];
+    uint32_t sent;
+    uint32_t received;
+    uint32_t lost;
+    int8_t avgRssi;
+};
+
+struct __attribute__((packed)) LogBinError {
+    int32_t code;
+    uint32_t freeHeap;
+    // Text: module, message
+};
+
+struct __attribute__((packed)) LogBinCrash {
+    uint32_t pc;
+    uint32_t excvaddr;
+    uint32_t exccause;
+    uint32_t freeHeap;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RINGDATEI
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define LOG_RING_MAGIC      "LRNG"  // Datei-Kennung (4 Zeichen)
+#define LOG_RING_VERSION    3       // Container-Version (2: Zeitstempel im Block-Kopf, 3: Boot-Nummer)
+#define LOG_RING_BLOCK_SIZE 512     // Block = SD-Sektor
+
+// Inhalt der Ringdatei
+#define LOG_RING_FORMAT_TEXT    0   // Textzeilen
+#define LOG_RING_FORMAT_BINARY  1   // Records nach diesem Schema
+
+/**
+ * Kopf der Ringdatei (belegt den ersten Block)
+ */
+struct __attribute__((packed)) LogRingHeader {
+    char magic[4];                  // LOG_RING_MAGIC
+    uint8_t version;                // LOG_RING_VERSION
+    uint8_t format;                 // LOG_RING_FORMAT_*
+    uint8_t schemaVersion;          // LOG_BIN_VERSION (bei BINARY)
+    uint8_t reserved;
+    uint16_t blockSize;             // LOG_RING_BLOCK_SIZE
+    uint16_t reserved2;
+    uint32_t blockCount;            // Datenblöcke nach dem Kopf
+    uint32_t headSeq;               // Sequenz des Schreib-Blocks (kann nachlaufen)
+    uint32_t tailSeq;               // Älteste gültige Sequenz
+    uint32_t headOffset;            // Datei-Offset des Schreib-Blocks
+    uint32_t tailOffset;            // Datei-Offset des ältesten Blocks
+    uint32_t initBlocks;            // Genullte Datenblöcke ab Dateianfang (0 = alle)
+    uint32_t boot;                  // Boot-Nummer des letzten Öffnens (ab 1)
+};
+
+/**
+ * Kopf eines Datenblocks
+ */
+struct __attribute__((packed)) LogRingBlockHeader {
+    uint32_t seq;                   // 0 = nie beschrieben
+    uint16_t used;                  // Record-Bytes nach dem Kopf
+    uint16_t rawLen;                // Unkomprimierte Bytes (0 = nicht komprimiert)
+    uint32_t minMs;                 // Kleinster Zeitstempel der Records
+    uint32_t maxMs;                 // Größter Zeitstempel der Records
+    uint32_t boot;                  // Boot-Nummer der Records
+};
+
+#define LOG_RING_INDEX_MAGIC    "LIDX"  // Kennung der Index-Datei
+
+/**
+ * Kopf der Index-Datei
+ */
+struct __attribute__((packed)) LogRingIndexHeader {
+    char magic[4];                  // LOG_RING_INDEX_MAGIC
+    uint8_t version;                // LOG_RING_VERSION
+    uint8_t reserved;
+    uint16_t stride;                // Blöcke pro Eintrag
+    uint32_t entries;               // Anzahl Einträge
+};
+
+/**
+ * Index-Eintrag (volle Blockgruppe)
+ */
+struct __attribute__((packed)) LogRingIndexEntry {
+    uint32_t seq;                   // Sequenz des ersten Blocks (0 = leer)
+    uint32_t minMs;                 // Kleinster Zeitstempel der Gruppe
+    uint32_t maxMs;                 // Größter Zeitstempel der Gruppe
+    uint32_t boot;                  // Boot-Nummer der Gruppe (0 = mehrere Boots)
+};
+
+static_assert(sizeof(LogBinFileHeader) == 8, "LogBinFileHeader Layout");
+static_assert(sizeof(LogRingHeader) <= LOG_RING_BLOCK_SIZE, "LogRingHeader Layout");
+static_assert(sizeof(LogRingBlockHeader) == 20, "LogRingBlockHeader Layout");
+static_assert(sizeof(LogRingIndexEntry) == 16, "LogRingIndexEntry Layout");
+static_assert(sizeof(LogBinHeader) == 6, "LogBinHeader Layout");
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FLIGHT-RECORDER-DUMP
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define FLIGHT_DUMP_MAGIC   "FREC"  // Datei-Kennung (4 Zeichen)
+#define FLIGHT_DUMP_VERSION 1
+
+// Art eines Eintrags (Werte wie EspNowTapKind)
+#define FLIGHT_KIND_RX          0   // Empfangener Frame (info = RSSI)
+#define FLIGHT_KIND_TX          1   // Gesendeter Frame (info = 0 OK, -1 Treiberfehler)
+#define FLIGHT_KIND_TX_STATUS   2   // Sende-Bestätigung (info = 1 Erfolg, 0 Fehler)
+#define FLIGHT_KIND_EVENT       3   // EspNowEvent (data[0], info = success)
+
+/**
+ * Auslöser eines Dumps
+ */
+enum FlightTrigger : uint8_t {
+    FLIGHT_TRIGGER_MANUAL = 0,
+    FLIGHT_TRIGGER_PEER_DISCONNECTED,
+    FLIGHT_TRIGGER_HEARTBEAT_TIMEOUT,
+    FLIGHT_TRIGGER_BATTERY_SHUTDOWN
+};
+
+/**
+ * Datei-Header eines Dumps, danach records × (FlightRecordHeader + len Bytes)
+ * in zeitlicher Reihenfolge
+ */
+struct __attribute__((packed)) FlightDumpHeader {
+    char magic[4];                  // FLIGHT_DUMP_MAGIC
+    uint8_t version;                // FLIGHT_DUMP_VERSION
+    uint8_t trigger;                // FlightTrigger
+    uint16_t reserved;
+    uint32_t dumpId;                // Fortlaufende Dump-Nummer
+    uint32_t records;               // Geschriebene Einträge
+    uint32_t lost;                  // Während des Dumps überschriebene Einträge
+    int64_t triggerUs;              // esp_timer beim Auslösen
+};
+
+/**
+ * Eintrag im Dump
+ */
+struct __attribute__((packed)) FlightRecordHeader {
+    int64_t timeUs;                 // esp_timer_get_time()
+    uint32_t seq;                   // Fortlaufend (Lücken = überschrieben)
+    uint16_t len;                   // Daten-Bytes nach dem Header
+    uint8_t kind;                   // FLIGHT_KIND_*
+    int8_t info;                    // RSSI / Status (siehe FLIGHT_KIND_*)
+    uint8_t mac[6];                 // Peer (Absender bzw. Ziel)
+};
+
+static_assert(sizeof(FlightDumpHeader) == 28, "FlightDumpHeader Layout");
+static_assert(sizeof(FlightRecordHeader) == 22, "FlightRecordHeader Layout");
+
+/**
+ * Name eines Dump-Auslösers
+ */
+static inline const char* flightTriggerName(uint8_t trigger) {
+    switch (trigger) {
+        case FLIGHT_TRIGGER_MANUAL:             return "manual";
+        case FLIGHT_TRIGGER_PEER_DISCONNECTED:  return "peer-disconnected";
+        case FLIGHT_TRIGGER_HEARTBEAT_TIMEOUT:  return "heartbeat-timeout";
+        case FLIGHT_TRIGGER_BATTERY_SHUTDOWN:   return "battery-shutdown";
+        default:                                return "?";
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCHEMA-TABELLE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Name eines Record-Typs (wie im Text-Log)
+ */
+static inline const char* logBinTypeName(uint8_t type) {
+    switch (type) {
+        case LOG_BIN_BOOT_START:        return "BootStart";
+        case LOG_BIN_SETUP_STEP:        return "Setup";
+        case LOG_BIN_BOOT_COMPLETE:     return "BootComplete";
+        case LOG_BIN_BATTERY:           return "Battery";
+        case LOG_BIN_CONNECTION:        return "Connection";
+        case LOG_BIN_CONNECTION_STATS:  return "ConnectionStats";
+        case LOG_BIN_ERROR:             return "Error";
+        case LOG_BIN_CRASH:             return "Crash";
+        default:                        return nullptr;
+    }
+}
+
+/**
+ * Größe der festen Felder eines Typs (0 = unbekannter Typ)
+ */
+static inline uint8_t logBinFixedSize(uint8_t type) {
+    switch (type) {
+        case LOG_BIN_BOOT_START:        return sizeof(LogBinBootStart);
+        case LOG_BIN_SETUP_STEP:        return sizeof(LogBinSetupStep);
+        case LOG_BIN_BOOT_COMPLETE:     return sizeof(LogBinBootComplete);
+        case LOG_BIN_BATTERY:           return sizeof(LogBinBattery);
+        case LOG_BIN_CONNECTION:        return sizeof(LogBinConnection);
+        case LOG_BIN_CONNECTION_STATS:  return sizeof(LogBinConnectionStats);
+        case LOG_BIN_ERROR:             return sizeof(LogBinError);
+        case LOG_BIN_CRASH:             return sizeof(LogBinCrash);
+        default:                        return 0;
+    }
+}
+
+/**
+ * Anzahl der Text-Felder nach den festen Feldern
+ */
+static inline uint8_t logBinTextFields(uint8_t type) {
+    switch (type) {
+        case LOG_BIN_BOOT_START:        return 3;
+        case LOG_BIN_SETUP_STEP:        return 2;
+        case LOG_BIN_CONNECTION:        return 1;
+        case LOG_BIN_ERROR:             return 2;
+        default:                        return 0;
+    }
+}
+
+#endif // LOG_SCHEMA_H
@@ -0,0 +1,285 @@
+/**
+ * MotorOutput.cpp
+ * 
+ * Implementation der Echtzeit-Ausgabestufe für die Motoren
+ */
+
+#include "MotorOutput.h"
+#include "ESPNowManager.h"
+
+MotorOutput::MotorOutput()
+    : initialized(false)
+    , running(false)
+    , periodUs(1000000UL / MOTOR_OUTPUT_RATE_HZ)
+    , taskHandle(nullptr)
+    , timer(nullptr)
+    , slewRate(MOTOR_SLEW_RATE)
+    , failsafeUs(MOTOR_FAILSAFE_MS * 1000UL)
+    , failsafeLeft(MOTOR_FAILSAFE_LEFT)
+    , failsafeRight(MOTOR_FAILSAFE_RIGHT)
+    , failsafeActive(true)
+    , stopRequested(false)
+    , outLeft(MOTOR_FAILSAFE_LEFT)
+    , outRight(MOTOR_FAILSAFE_RIGHT)
+    , hasCommand(false)
+    , lastFreshUs(0)
+    , lastCycleUs(0)
+    , applyCallback(nullptr)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+MotorOutput::~MotorOutput() {
+    end();
+}
+
+bool MotorOutput::begin(uint16_t rateHz) {
+    if (initialized) return true;
+    
+    DEBUG_PRINTLN("MotorOutput: Initialisiere Ausgabestufe...");
+    
+    periodUs = 1000000UL / (rateHz > 0 ? rateHz : MOTOR_OUTPUT_RATE_HZ);
+    running = true;
+    
+    // Task zuerst, der Timer weckt ihn nur noch
+    BaseType_t taskResult = xTaskCreatePinnedToCore(
+        outputTask,                     // Task-Funktion
+        "MotorOutput",                  // Name
+        MOTOR_OUTPUT_STACK_SIZE,        // Stack-Größe
+        this,                           // Parameter (this-Pointer)
+        MOTOR_OUTPUT_PRIORITY,          // Priorität
+        &taskHandle,                    // Task-Handle
+        MOTOR_OUTPUT_CORE               // Core
+    );
+    
+    if (taskResult != pdPASS) {
+        DEBUG_PRINTLN("MotorOutput: ❌ Task erstellen fehlgeschlagen!");
+        running = false;
+        return false;
+    }
+    
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = timerCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "MotorOutput";
+    timerArgs.skip_unhandled_events = true;
+    
+    if (esp_timer_create(&timerArgs, &timer) != ESP_OK ||
+        esp_timer_start_periodic(timer, periodUs) != ESP_OK) {
+        DEBUG_PRINTLN("MotorOutput: ❌ Timer starten fehlgeschlagen!");
+        end();
+        return false;
+    }
+    
+    initialized = true;
+    
+    DEBUG_PRINTF("MotorOutput: ✅ %lu Hz (Core %d, Prio %d), Failsafe nach %lu ms\n",
+                 1000000UL / periodUs, MOTOR_OUTPUT_CORE, MOTOR_OUTPUT_PRIORITY, failsafeUs / 1000);
+    
+    return true;
+}
+
+void MotorOutput::end() {
+    if (timer) {
+        esp_timer_stop(timer);
+        esp_timer_delete(timer);
+        timer = nullptr;
+    }
+    
+    if (taskHandle) {
+        running = false;
+        xTaskNotifyGive(taskHandle);
+        vTaskDelay(pdMS_TO_TICKS(20));  // Warten bis Task beendet
+        taskHandle = nullptr;
+    }
+    
+    // Sicherer Zustand
+    outLeft = failsafeLeft;
+    outRight = failsafeRight;
+    failsafeActive = true;
+    if (applyCallback) {
+        applyCallback(failsafeLeft, failsafeRight);
+    }
+    
+    initialized = false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// KONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+void MotorOutput::setApplyCallback(MotorApplyCallback callback) {
+    applyCallback = callback;
+}
+
+void MotorOutput::setSlewRate(float unitsPerSecond) {
+    slewRate = unitsPerSecond > 0.0f ? unitsPerSecond : 0.0f;
+}
+
+void MotorOutput::setFailsafe(uint32_t deadlineMs, int16_t left, int16_t right) {
+    failsafeUs = deadlineMs * 1000UL;
+    failsafeLeft = left;
+    failsafeRight = right;
+}
+
+void MotorOutput::emergencyStop() {
+    stopRequested = true;
+    if (taskHandle) {
+        xTaskNotifyGive(taskHandle);
+    }
+}
+
+void MotorOutput::releaseStop() {
+    stopRequested = false;
+}
+
+bool MotorOutput::isStopped() const {
+    return stopRequested || EspNowManager::getInstance().isEmergencyStopped();
+}
+
+void MotorOutput::getOutput(int16_t& left, int16_t& right) const {
+    left = (int16_t)lroundf(outLeft);
+    right = (int16_t)lroundf(outRight);
+}
+
+void MotorOutput::getStats(MotorOutputStats* out) {
+    if (out) *out = stats;
+}
+
+void MotorOutput::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TIMER & TASK
+// ═══════════════════════════════════════════════════════════════════════════
+
+void MotorOutput::timerCallback(void* arg) {
+    MotorOutput* output = static_cast<MotorOutput*>(arg);
+    if (output->taskHandle) {
+        xTaskNotifyGive(output->taskHandle);
+    }
+}
+
+void MotorOutput::outputTask(void* parameter) {
+    MotorOutput* output = static_cast<MotorOutput*>(parameter);
+    
+    DEBUG_PRINTLN("MotorOutput: Task gestartet");
+    
+    while (output->running) {
+        // Auf Timer-Tick warten (Timeout nur als Absicherung gegen hängenden Timer)
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100)) == 0) continue;
+        if (!output->running) break;
+        
+        output->cycle();
+    }
+    
+    vTaskDelete(nullptr);
+}
+
+void MotorOutput::cycle() {
+    EspNowManager& espnow = EspNowManager::getInstance();
+    
+    // Neuesten Befehl lock-frei lesen
+    EspNowMotorCommand command;
+    bool valid = espnow.getMotorCommand(&command);
+    
+    // Not-Aus: sofort und ohne Rampe (auch außerhalb des Timer-Takts),
+    // lokal bis releaseStop(), vom Funk bis clearEmergencyStop()
+    if (stopRequested || espnow.isEmergencyStopped()) {
+        if (!failsafeActive) stats.failsafeEntries++;
+        failsafeActive = true;
+        outLeft = failsafeLeft;
+        outRight = failsafeRight;
+        if (applyCallback) {
+            applyCallback(failsafeLeft, failsafeRight);
+        }
+        
+        // Alles bis zur Freigabe gilt als gesehen → danach nur ein neuer Befehl
+        hasCommand = false;
+        if (valid) lastFreshUs = command.playoutUs;
+        return;
+    }
+    
+    int64_t nowUs = esp_timer_get_time();
+    recordPeriod(nowUs);
+    
+    if (valid && !command.held && command.playoutUs != lastFreshUs) {
+        lastFreshUs = command.playoutUs;
+        hasCommand = true;
+    }
+    
+    // Deadline prüfen
+    bool fresh = hasCommand && (micros() - lastFreshUs) <= failsafeUs;
+    if (!fresh && !failsafeActive) {
+        stats.failsafeEntries++;
+        DEBUG_PRINTLN("MotorOutput: ⚠️ Failsafe (kein frischer Befehl)");
+    }
+    failsafeActive = !fresh;
+    
+    float targetLeft = fresh ? constrain((float)command.left, -100.0f, 100.0f) : failsafeLeft;
+    float targetRight = fresh ? constrain((float)command.right, -100.0f, 100.0f) : failsafeRight;
+    
+    // Slew-Rate begrenzen
+    float maxStep = slewRate > 0.0f ? slewRate * periodUs / 1000000.0f : 1000.0f;
+    outLeft = slew(outLeft, targetLeft, maxStep);
+    outRight = slew(outRight, targetRight, maxStep);
+    
+    if (applyCallback) {
+        applyCallback((int16_t)lroundf(outLeft), (int16_t)lroundf(outRight));
+    }
+    stats.cycles++;
+}
+
+float MotorOutput::slew(float current, float target, float maxStep) {
+    float delta = target - current;
+    if (delta > maxStep) return current + maxStep;
+    if (delta < -maxStep) return current - maxStep;
+    return target;
+}
+
+void MotorOutput::recordPeriod(int64_t nowUs) {
+    if (lastCycleUs > 0) {
+        int64_t error = (nowUs - lastCycleUs) - (int64_t)periodUs;
+        uint32_t absError = (uint32_t)(error < 0 ? -error : error);
+        
+        int bucket = absError / MOTOR_JITTER_BUCKET_US;
+        if (bucket >= MOTOR_JITTER_BUCKETS) bucket = MOTOR_JITTER_BUCKETS - 1;
+        stats.histogram[bucket]++;
+        
+        if (absError > stats.maxPeriodErrorUs) stats.maxPeriodErrorUs = absError;
+    }
+    lastCycleUs = nowUs;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DEBUG
+// ═══════════════════════════════════════════════════════════════════════════
+
+void MotorOutput::printInfo() {
+    int16_t left, right;
+    getOutput(left, right);
+    
+    DEBUG_PRINTLN("\n╔═══════════════════════════════════════════════╗");
+    DEBUG_PRINTLN("║          MOTOR OUTPUT INFO                    ║");
+    DEBUG_PRINTLN("╚═══════════════════════════════════════════════╝");
+    DEBUG_PRINTF("Rate:       %lu Hz\n", 1000000UL / periodUs);
+    DEBUG_PRINTF("Ausgabe:    L=%d R=%d\n", left, right);
+    DEBUG_PRINTF("Failsafe:   %s (%lu Eintritte, Deadline %lu ms)\n",
+                 failsafeActive ? "AKTIV" : "aus", stats.failsafeEntries, failsafeUs / 1000);
+    DEBUG_PRINTF("Not-Aus:    %s\n", isStopped() ? (stopRequested ? "AKTIV (lokal)" : "AKTIV (Funk)") : "aus");
+    DEBUG_PRINTF("Zyklen:     %lu, max. Abweichung %lu µs\n", stats.cycles, stats.maxPeriodErrorUs);
+    
+    DEBUG_PRINTLN("\n─── Perioden-Jitter ───────────────────────────");
+    for (int i = 0; i < MOTOR_JITTER_BUCKETS; i++) {
+        if (stats.histogram[i] == 0) continue;
+        if (i == MOTOR_JITTER_BUCKETS - 1) {
+            DEBUG_PRINTF(">= %4d µs: %lu\n", i * MOTOR_JITTER_BUCKET_US, stats.histogram[i]);
+        } else {
+            DEBUG_PRINTF("%4d-%4d µs: %lu\n", i * MOTOR_JITTER_BUCKET_US,
+                         (i + 1) * MOTOR_JITTER_BUCKET_US - 1, stats.histogram[i]);
+        }
+    }
+    DEBUG_PRINTLN("═══════════════════════════════════════════════\n");
+}
@@ -0,0 +1,219 @@
+/**
+ * MotorOutput.h
+ * 
+ * Echtzeit-Ausgabestufe für die Motoren
+ * 
+ * Features:
+ * - Eigener Task mit hoher Priorität, getaktet über esp_timer (z.B. 200 Hz)
+ * - Liest den neuesten Motor-Befehl lock-frei aus dem EspNowManager
+ * - Slew-Rate-Begrenzung (keine Sprünge am Antrieb)
+ * - Failsafe: ohne frischen Befehl innerhalb der Deadline → Failsafe-Werte
+ * - Not-Aus: Failsafe-Werte sofort und ohne Slew-Rate, bleibt bis zur
+ *   Freigabe (releaseStop) aktiv; danach erst mit einem neuen Befehl weiter
+ * - Histogramm der Perioden-Abweichung (Ausgabe-Jitter)
+ * - Unabhängig von loop(), Logging und Batterie-Code
+ */
+
+#ifndef MOTOR_OUTPUT_H
+#define MOTOR_OUTPUT_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// KONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifndef MOTOR_OUTPUT_RATE_HZ
+#define MOTOR_OUTPUT_RATE_HZ        200     // Ausgaberate
+#endif
+
+#ifndef MOTOR_OUTPUT_PRIORITY
+#define MOTOR_OUTPUT_PRIORITY       10      // Über ESP-NOW Worker (5) und loop() (1)
+#endif
+
+#ifndef MOTOR_OUTPUT_CORE
+#define MOTOR_OUTPUT_CORE           1       // App-Core
+#endif
+
+#ifndef MOTOR_OUTPUT_STACK_SIZE
+#define MOTOR_OUTPUT_STACK_SIZE     3072    // Task-Stack
+#endif
+
+#ifndef MOTOR_SLEW_RATE
+#define MOTOR_SLEW_RATE             400.0f  // Max. Änderung pro Sekunde (-100..+100 → 0.5s volle Umkehr)
+#endif
+
+#ifndef MOTOR_FAILSAFE_MS
+#define MOTOR_FAILSAFE_MS           250     // Deadline für frischen Befehl
+#endif
+
+#ifndef MOTOR_FAILSAFE_LEFT
+#define MOTOR_FAILSAFE_LEFT         0       // Failsafe-Wert links
+#endif
+
+#ifndef MOTOR_FAILSAFE_RIGHT
+#define MOTOR_FAILSAFE_RIGHT        0       // Failsafe-Wert rechts
+#endif
+
+#ifndef MOTOR_JITTER_BUCKETS
+#define MOTOR_JITTER_BUCKETS        16      // Histogramm-Klassen (letzte = Überlauf)
+#endif
+
+#ifndef MOTOR_JITTER_BUCKET_US
+#define MOTOR_JITTER_BUCKET_US      50      // Breite einer Histogramm-Klasse (µs)
+#endif
+
+// Callback-Typ: Werte an Treiber ausgeben (im Motor-Task!)
+typedef void (*MotorApplyCallback)(int16_t left, int16_t right);
+
+/**
+ * Statistik der Ausgabestufe
+ */
+struct MotorOutputStats {
+    uint32_t cycles;                        // Ausgabezyklen
+    uint32_t failsafeEntries;               // Wechsel in den Failsafe
+    uint32_t maxPeriodErrorUs;              // Größte Perioden-Abweichung
+    uint32_t histogram[MOTOR_JITTER_BUCKETS];   // |Periode - Soll| in MOTOR_JITTER_BUCKET_US-Schritten
+};
+
+class MotorOutput {
+public:
+    /**
+     * Konstruktor
+     */
+    MotorOutput();
+    
+    /**
+     * Destruktor
+     */
+    ~MotorOutput();
+    
+    /**
+     * Ausgabe-Task und Timer starten
+     * @param rateHz Ausgaberate
+     * @return true bei Erfolg
+     */
+    bool begin(uint16_t rateHz = MOTOR_OUTPUT_RATE_HZ);
+    
+    /**
+     * Ausgabe stoppen (Failsafe-Werte werden ein letztes Mal ausgegeben)
+     */
+    void end();
+    
+    /**
+     * Callback für die Treiber-Ausgabe setzen
+     */
+    void setApplyCallback(MotorApplyCallback callback);
+    
+    /**
+     * Slew-Rate setzen
+     * @param unitsPerSecond Max. Änderung pro Sekunde (0 = unbegrenzt)
+     */
+    void setSlewRate(float unitsPerSecond);
+    
+    /**
+     * Failsafe konfigurieren
+     * @param deadlineMs Max. Alter des letzten frischen Befehls
+     * @param left Failsafe-Wert links
+     * @param right Failsafe-Wert rechts
+     */
+    void setFailsafe(uint32_t deadlineMs, int16_t left = MOTOR_FAILSAFE_LEFT,
+                     int16_t right = MOTOR_FAILSAFE_RIGHT);
+    
+    /**
+     * Not-Aus auslösen: Task sofort wecken, Failsafe-Werte ohne Slew-Rate
+     * (aus dem EspNowManager Not-Aus-Handler aufrufbar, blockiert nicht)
+     * Bleibt gesetzt bis releaseStop().
+     */
+    void emergencyStop();
+    
+    /**
+     * Lokalen Not-Aus freigeben. Die Motoren laufen erst mit einem nach der
+     * Freigabe empfangenen Befehl wieder an; ein Not-Aus vom Funk bleibt bis
+     * EspNowManager::clearEmergencyStop aktiv.
+     */
+    void releaseStop();
+    
+    /**
+     * Ist ein Not-Aus aktiv (lokal oder vom Funk)?
+     */
+    bool isStopped() const;
+    
+    /**
+     * Ist der Failsafe aktiv?
+     */
+    bool isFailsafe() const { return failsafeActive; }
+    
+    /**
+     * Zuletzt ausgegebene Werte
+     */
+    void getOutput(int16_t& left, int16_t& right) const;
+    
+    /**
+     * Statistik abrufen (Snapshot)
+     */
+    void getStats(MotorOutputStats* stats);
+    
+    /**
+     * Histogramm zurücksetzen
+     */
+    void resetStats();
+    
+    /**
+     * Debug-Informationen ausgeben
+     */
+    void printInfo();
+
+private:
+    bool initialized;
+    volatile bool running;
+    uint32_t periodUs;
+    
+    // FreeRTOS / Timer
+    TaskHandle_t taskHandle;
+    esp_timer_handle_t timer;
+    
+    // Regelung
+    float slewRate;
+    uint32_t failsafeUs;
+    int16_t failsafeLeft;
+    int16_t failsafeRight;
+    volatile bool failsafeActive;
+    volatile bool stopRequested;    // Lokaler Not-Aus (bis releaseStop)
+    float outLeft;
+    float outRight;
+    
+    // Frische des Befehls
+    bool hasCommand;
+    unsigned long lastFreshUs;      // playoutUs des letzten nicht gehaltenen (bzw. im Not-Aus gesehenen) Befehls
+    
+    // Timing
+    int64_t lastCycleUs;
+    MotorOutputStats stats;         // Zähler ohne Lock (nur Statistik)
+    
+    MotorApplyCallback applyCallback;
+    
+    static void timerCallback(void* arg);
+    static void outputTask(void* parameter);
+    
+    /**
+     * Ein Ausgabezyklus (im Motor-Task)
+     */
+    void cycle();
+    
+    /**
+     * Wert mit Slew-Rate an Ziel annähern
+     */
+    float slew(float current, float target, float maxStep);
+    
+    /**
+     * Perioden-Abweichung ins Histogramm eintragen
+     */
+    void recordPeriod(int64_t nowUs);
+};
+
+#endif // MOTOR_OUTPUT_H
@@ -0,0 +1,301 @@
+/**
+ * PacketCapture.cpp
+ *
+ * Implementation des ESP-NOW-Mitschnitts (pcap)
+ */
+
+#include "PacketCapture.h"
+#include <esp_timer.h>
+
+static_assert((CAPTURE_BUFFER_SIZE & (CAPTURE_BUFFER_SIZE - 1)) == 0, "CAPTURE_BUFFER_SIZE muss eine Zweierpotenz sein");
+
+#define CAPTURE_RECORD_OVERHEAD (sizeof(PcapRecordHeader) + sizeof(PcapEspNowHeader))
+
+PacketCapture* PacketCapture::instance = nullptr;
+
+PacketCapture::PacketCapture(SDCardHandler& sdCard)
+    : sd(sdCard)
+    , capturing(false)
+    , fileSize(0)
+    , ring(nullptr)
+    , ringHead(0)
+    , ringTail(0)
+    , writerHandle(nullptr)
+    , writerRunning(false)
+    , drainMutex(nullptr)
+{
+    path[0] = '\0';
+    ringMux = portMUX_INITIALIZER_UNLOCKED;
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool PacketCapture::start(const char* capturePath) {
+    DEBUG_PRINTF("PacketCapture: Starte Mitschnitt %s...\n", capturePath);
+    
+    if (capturing) return true;
+    
+    if (!sd.isAvailable()) {
+        DEBUG_PRINTLN("PacketCapture: ⚠️ SD-Karte nicht verfügbar");
+        return false;
+    }
+    
+    // Ring, Mutex und Writer-Task beim ersten Start anlegen
+    if (!ring) {
+        ring = new uint8_t[CAPTURE_BUFFER_SIZE];
+    }
+    if (!drainMutex) {
+        drainMutex = xSemaphoreCreateMutex();
+        if (!drainMutex) {
+            DEBUG_PRINTLN("PacketCapture: ❌ Mutex erstellen fehlgeschlagen!");
+            return false;
+        }
+    }
+    if (!writerHandle) {
+        writerRunning = true;
+        BaseType_t taskResult = xTaskCreatePinnedToCore(
+            writerTask,                     // Task-Funktion
+            "CaptureWriter",                // Name
+            CAPTURE_WRITER_STACK_SIZE,      // Stack-Größe
+            this,                           // Parameter (this-Pointer)
+            CAPTURE_WRITER_PRIORITY,        // Priorität
+            &writerHandle,                  // Task-Handle
+            CAPTURE_WRITER_CORE             // Core
+        );
+        
+        if (taskResult != pdPASS) {
+            DEBUG_PRINTLN("PacketCapture: ❌ Writer-Task erstellen fehlgeschlagen!");
+            writerRunning = false;
+            writerHandle = nullptr;
+            return false;
+        }
+    }
+    
+    // Datei neu anlegen, pcap-Kopf schreiben
+    xSemaphoreTake(drainMutex, portMAX_DELAY);
+    strncpy(path, capturePath, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    file = sd.openFile(path, FILE_WRITE);
+    
+    PcapFileHeader header = {};
+    header.magic = PCAP_MAGIC;
+    header.versionMajor = PCAP_VERSION_MAJOR;
+    header.versionMinor = PCAP_VERSION_MINOR;
+    header.snapLen = sizeof(PcapEspNowHeader) + ESPNOW_MAX_PACKET_SIZE;
+    header.linkType = PCAP_LINKTYPE_USER0;
+    bool ok = file && file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    if (!ok) {
+        if (file) file.close();
+        xSemaphoreGive(drainMutex);
+        DEBUG_PRINTF("PacketCapture: ❌ Kann %s nicht anlegen\n", path);
+        return false;
+    }
+    fileSize = sizeof(header);
+    
+    portENTER_CRITICAL(&ringMux);
+    ringTail = ringHead;
+    portEXIT_CRITICAL(&ringMux);
+    capturing = true;
+    xSemaphoreGive(drainMutex);
+    
+    // Erst jetzt am EspNowManager anmelden
+    instance = this;
+    if (!EspNowManager::getInstance().addFrameTap(tap)) {
+        DEBUG_PRINTLN("PacketCapture: ⚠️ Kein Frame-Tap frei");
+        stop();
+        return false;
+    }
+    
+    DEBUG_PRINTF("PacketCapture: ✅ Mitschnitt läuft (%s, Ring %u KB)\n", path, CAPTURE_BUFFER_SIZE / 1024);
+    return true;
+}
+
+void PacketCapture::stop() {
+    // Tap auch abmelden, wenn der Writer den Mitschnitt schon beendet hat (Limit, Fehler)
+    EspNowManager::getInstance().removeFrameTap(tap);
+    capturing = false;
+    if (!drainMutex) return;
+    
+    // Rest aus dem Ring schreiben
+    xSemaphoreTake(drainMutex, portMAX_DELAY);
+    drain();
+    if (file) file.close();
+    xSemaphoreGive(drainMutex);
+    
+    DEBUG_PRINTF("PacketCapture: Mitschnitt beendet (%s, %lu Bytes, %lu verworfen)\n",
+                 path, fileSize, stats.dropped);
+}
+
+void PacketCapture::getStats(CaptureStats* out) {
+    if (!out) return;
+    
+    portENTER_CRITICAL(&ringMux);
+    *out = stats;
+    portEXIT_CRITICAL(&ringMux);
+}
+
+void PacketCapture::printInfo() {
+    DEBUG_PRINTLN("\n╔═══════════════════════════════════════════════╗");
+    DEBUG_PRINTLN("║            PACKET CAPTURE INFO                ║");
+    DEBUG_PRINTLN("╚═══════════════════════════════════════════════╝");
+    
+    CaptureStats s;
+    getStats(&s);
+    DEBUG_PRINTF("Status:     %s%s\n", capturing ? "läuft → " : "gestoppt", capturing ? path : "");
+    DEBUG_PRINTF("Datei:      %lu Bytes (max. %lu)\n", fileSize, (unsigned long)CAPTURE_MAX_FILE_SIZE);
+    DEBUG_PRINTF("Frames:     %lu erfasst, %lu verworfen\n", s.frames, s.dropped);
+    DEBUG_PRINTF("Ring:       %lu / %u Bytes max. belegt, Tap max. %lu µs\n",
+                 s.highWater, CAPTURE_BUFFER_SIZE, s.maxTapUs);
+    DEBUG_PRINTF("SD:         %lu Bytes geschrieben, %lu Fehler\n", s.written, s.writeErrors);
+    
+    DEBUG_PRINTLN("═══════════════════════════════════════════════\n");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME-TAP
+// ═══════════════════════════════════════════════════════════════════════════
+
+void PacketCapture::tap(EspNowTapKind kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info) {
+    PacketCapture* capture = instance;
+    if (!capture) return;
+    
+    switch (kind) {
+        case EspNowTapKind::RX:
+            capture->enqueue(CAPTURE_DIR_RX, mac, data, len, info);
+            break;
+        case EspNowTapKind::TX:
+            capture->enqueue(CAPTURE_DIR_TX, mac, data, len, info);
+            break;
+        case EspNowTapKind::TX_STATUS:
+            capture->enqueue(CAPTURE_DIR_TX_STATUS, mac, nullptr, 0, info);
+            break;
+        default:
+            break;      // Events sind keine Frames
+    }
+}
+
+void PacketCapture::enqueue(uint8_t direction, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info) {
+    if (!capturing) return;
+    
+    int64_t nowUs = esp_timer_get_time();
+    if (len > ESPNOW_MAX_PACKET_SIZE) len = ESPNOW_MAX_PACKET_SIZE;
+    
+    PcapRecordHeader record;
+    record.tsSec = (uint32_t)(nowUs / 1000000);
+    record.tsUsec = (uint32_t)(nowUs % 1000000);
+    record.inclLen = sizeof(PcapEspNowHeader) + len;
+    record.origLen = record.inclLen;
+    
+    PcapEspNowHeader pseudo;
+    pseudo.version = CAPTURE_HEADER_VERSION;
+    pseudo.direction = direction;
+    pseudo.info = info;
+    pseudo.reserved = 0;
+    if (mac) {
+        memcpy(pseudo.mac, mac, 6);
+    } else {
+        memset(pseudo.mac, 0, 6);
+    }
+    
+    // Kompletter Record oder gar nichts (Datei bleibt lesbar)
+    uint32_t size = CAPTURE_RECORD_OVERHEAD + len;
+    uint32_t pending;
+    bool queued = false;
+    portENTER_CRITICAL(&ringMux);
+    pending = ringHead - ringTail;
+    if (pending + size <= CAPTURE_BUFFER_SIZE) {
+        uint32_t pos = ringHead;
+        copyIn(pos, &record, sizeof(record));
+        copyIn(pos + sizeof(record), &pseudo, sizeof(pseudo));
+        if (len > 0) copyIn(pos + CAPTURE_RECORD_OVERHEAD, data, len);
+        ringHead = pos + size;
+        pending += size;
+        
+        stats.frames++;
+        if (pending > stats.highWater) stats.highWater = pending;
+        queued = true;
+    } else {
+        stats.dropped++;
+    }
+    portEXIT_CRITICAL(&ringMux);
+    
+    uint32_t elapsed = esp_timer_get_time() - nowUs;
+    if (elapsed > stats.maxTapUs) stats.maxTapUs = elapsed;
+    
+    // Erst ab einem Viertel Füllung wecken (Batching)
+    if (queued && writerHandle && pending >= CAPTURE_BUFFER_SIZE / 4) {
+        xTaskNotifyGive(writerHandle);
+    }
+}
+
+void PacketCapture::copyIn(uint32_t pos, const void* data, size_t len) {
+    uint32_t offset = pos & (CAPTURE_BUFFER_SIZE - 1);
+    size_t first = CAPTURE_BUFFER_SIZE - offset;
+    if (first > len) first = len;
+    memcpy(&ring[offset], data, first);
+    if (len > first) memcpy(ring, (const uint8_t*)data + first, len - first);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WRITER-TASK
+// ═══════════════════════════════════════════════════════════════════════════
+
+void PacketCapture::writerTask(void* parameter) {
+    PacketCapture* capture = static_cast<PacketCapture*>(parameter);
+    
+    DEBUG_PRINTLN("PacketCapture: Writer-Task gestartet");
+    
+    while (capture->writerRunning) {
+        // Auf Weckruf oder Flush-Intervall warten
+        uint32_t woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CAPTURE_FLUSH_INTERVAL_MS));
+        
+        if (xSemaphoreTake(capture->drainMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+            if (capture->file) {
+                capture->drain();
+                
+                // Nach Intervall (ohne Weckruf) auch das Verzeichnis aktualisieren
+                if (!woken && capture->file) capture->file.flush();
+            }
+            xSemaphoreGive(capture->drainMutex);
+        }
+    }
+    
+    vTaskDelete(nullptr);
+}
+
+void PacketCapture::drain() {
+    // drainMutex muss gehalten werden
+    uint32_t tail = ringTail;
+    uint32_t head = ringHead;
+    if (!file) {
+        ringTail = head;
+        return;
+    }
+    
+    // Höchstens zwei zusammenhängende Stücke (Umbruch)
+    bool ok = true;
+    while (ok && tail != head) {
+        uint32_t offset = tail & (CAPTURE_BUFFER_SIZE - 1);
+        uint32_t len = head - tail;
+        if (len > CAPTURE_BUFFER_SIZE - offset) len = CAPTURE_BUFFER_SIZE - offset;
+        
+        ok = file.write(&ring[offset], len) == len;
+        tail += len;
+        fileSize += len;
+        
+        portENTER_CRITICAL(&ringMux);
+        if (ok) {
+            stats.written += len;
+        } else {
+            stats.writeErrors++;
+        }
+        ringTail = tail;
+        portEXIT_CRITICAL(&ringMux);
+    }
+    
+    // Größenlimit oder SD-Fehler → Mitschnitt beenden
+    if (!ok || fileSize >= CAPTURE_MAX_FILE_SIZE) {
+        DEBUG_PRINTF("PacketCapture: ⚠️ Mitschnitt beendet (%s)\n", ok ? "Dateigröße erreicht" : "Schreibfehler");
+        capturing = false;
+        file.close();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+/**
+ * PacketCapture.h
+ *
+ * Mitschnitt aller ESP-NOW-Frames als pcap-Datei auf der SD-Karte
+ *
+ * Features:
+ * - Jeder empfangene (Empfangs-Callback) und gesendete Frame (TX-Queue,
+ *   esp_now_send) plus Sende-Status, erfasst über einen Frame-Tap
+ * - Klassisches pcap-Format, Link-Type USER0 (147), pro Frame ein
+ *   Pseudo-Header mit Richtung, RSSI/Status und Peer-MAC (PcapEspNowHeader)
+ * - Zeitstempel: esp_timer (µs seit Boot)
+ * - Gepuffert und asynchron: der Tap kopiert nur in einen RAM-Ring
+ *   (Spinlock, kein SD-Zugriff), ein Writer-Task mit niedriger Priorität
+ *   schreibt gebündelt; bei vollem Ring werden Frames verworfen und gezählt
+ * - Wireshark-Dissector für das TLV-Protokoll: tools/espnow.lua
+ */
+
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "config.h"
+#include "SDCardHandler.h"
+#include "ESPNowManager.h"
+
+#define CAPTURE_FILE_DEFAULT    "/capture.pcap"
+
+#ifndef CAPTURE_BUFFER_SIZE
+#define CAPTURE_BUFFER_SIZE     16384   // RAM-Ring in Bytes (Zweierpotenz, ≈ 50 volle Frames)
+#endif
+
+#ifndef CAPTURE_MAX_FILE_SIZE
+#define CAPTURE_MAX_FILE_SIZE   (64UL * 1024 * 1024)    // Mitschnitt endet bei dieser Dateigröße
+#endif
+
+#ifndef CAPTURE_FLUSH_INTERVAL_MS
+#define CAPTURE_FLUSH_INTERVAL_MS   1000    // Writer schreibt spätestens nach dieser Zeit
+#endif
+
+#ifndef CAPTURE_WRITER_PRIORITY
+#define CAPTURE_WRITER_PRIORITY     1       // Wie LogWriter, unter dem ESP-NOW Worker
+#endif
+
+#ifndef CAPTURE_WRITER_CORE
+#define CAPTURE_WRITER_CORE         0
+#endif
+
+#ifndef CAPTURE_WRITER_STACK_SIZE
+#define CAPTURE_WRITER_STACK_SIZE   4096
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PCAP-FORMAT
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define PCAP_MAGIC              0xA1B2C3D4  // µs-Zeitstempel
+#define PCAP_VERSION_MAJOR      2
+#define PCAP_VERSION_MINOR      4
+#define PCAP_LINKTYPE_USER0     147         // Wireshark: DLT_USER0 → Dissector "espnow"
+
+#define CAPTURE_HEADER_VERSION  1
+
+// Richtung im Pseudo-Header
+#define CAPTURE_DIR_RX          0   // Empfangen (info = RSSI dBm)
+#define CAPTURE_DIR_TX          1   // An esp_now_send übergeben (info = 0 OK, -1 Treiberfehler)
+#define CAPTURE_DIR_TX_STATUS   2   // Sende-Bestätigung, ohne Nutzdaten (info = 1 Erfolg, 0 Fehler)
+
+/**
+ * Datei-Header (einmal am Dateianfang)
+ */
+struct __attribute__((packed)) PcapFileHeader {
+    uint32_t magic;                 // PCAP_MAGIC
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;               // 0 (UTC)
+    uint32_t sigFigs;               // 0
+    uint32_t snapLen;               // Max. Frame-Länge inkl. Pseudo-Header
+    uint32_t linkType;              // PCAP_LINKTYPE_USER0
+};
+
+/**
+ * Record-Header (vor jedem Frame)
+ */
+struct __attribute__((packed)) PcapRecordHeader {
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;               // Gespeicherte Bytes (Pseudo-Header + Frame)
+    uint32_t origLen;
+};
+
+/**
+ * Pseudo-Header vor dem ESP-NOW-Frame (Beginn der Link-Layer-Daten)
+ */
+struct __attribute__((packed)) PcapEspNowHeader {
+    uint8_t version;                // CAPTURE_HEADER_VERSION
+    uint8_t direction;              // CAPTURE_DIR_*
+    int8_t info;                    // RSSI bzw. Status
+    uint8_t reserved;
+    uint8_t mac[6];                 // Peer-MAC (Absender bzw. Ziel)
+};
+
+static_assert(sizeof(PcapFileHeader) == 24, "PcapFileHeader muss 24 Bytes groß sein");
+static_assert(sizeof(PcapRecordHeader) == 16, "PcapRecordHeader muss 16 Bytes groß sein");
+static_assert(sizeof(PcapEspNowHeader) == 10, "PcapEspNowHeader muss 10 Bytes groß sein");
+
+/**
+ * Statistik
+ */
+struct CaptureStats {
+    uint32_t frames;                // In den Ring übernommene Frames
+    uint32_t dropped;               // Verworfen (Ring voll)
+    uint32_t written;               // Auf SD geschriebene Bytes
+    uint32_t writeErrors;           // Fehlgeschlagene SD-Schreibvorgänge
+    uint32_t highWater;             // Maximale Ring-Füllung (Bytes)
+    uint32_t maxTapUs;              // Längste Kopie im Tap (µs)
+};
+
+class PacketCapture {
+public:
+    /**
+     * Konstruktor
+     * @param sdCard Referenz zum SDCardHandler
+     */
+    PacketCapture(SDCardHandler& sdCard);
+    
+    /**
+     * Mitschnitt starten (Datei wird neu angelegt, Ring und Writer-Task
+     * beim ersten Start angelegt)
+     * @param path Dateipfad
+     * @return true bei Erfolg
+     */
+    bool start(const char* path = CAPTURE_FILE_DEFAULT);
+    
+    /**
+     * Mitschnitt beenden: Ring leeren, Datei schließen
+     */
+    void stop();
+    
+    /**
+     * Läuft ein Mitschnitt?
+     */
+    bool isRunning() const { return capturing; }
+    
+    /**
+     * Statistik abrufen
+     */
+    void getStats(CaptureStats* stats);
+    
+    /**
+     * Debug-Info ausgeben
+     */
+    void printInfo();
+
+private:
+    SDCardHandler& sd;
+    File file;
+    char path[SD_MAX_PATH];
+    volatile bool capturing;
+    uint32_t fileSize;
+    
+    // RAM-Ring in Bytes (mehrere Produzenten, ein Writer)
+    uint8_t* ring;
+    volatile uint32_t ringHead;         // Nächstes freies Byte (Produzenten)
+    volatile uint32_t ringTail;         // Nächstes zu schreibendes Byte (Writer)
+    portMUX_TYPE ringMux;
+    CaptureStats stats;                 // Zähler unter ringMux
+    
+    // Writer-Task
+    TaskHandle_t writerHandle;
+    volatile bool writerRunning;
+    SemaphoreHandle_t drainMutex;       // Nur ein Leerlauf gleichzeitig (Task oder stop)
+    
+    static PacketCapture* instance;     // Für den Frame-Tap
+    
+    static void tap(EspNowTapKind kind, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info);
+    static void writerTask(void* parameter);
+    
+    /**
+     * Frame als pcap-Record in den Ring kopieren (Tap-Kontext)
+     */
+    void enqueue(uint8_t direction, const uint8_t* mac, const uint8_t* data, size_t len, int8_t info);
+    
+    /**
+     * Bytes mit Umbruch in den Ring kopieren (ringMux gehalten)
+     */
+    void copyIn(uint32_t pos, const void* data, size_t len);
+    
+    /**
+     * Ring auf die SD-Karte schreiben (drainMutex gehalten)
+     */
+    void drain();
+};
+
+#endif // PACKET_CAPTURE_H
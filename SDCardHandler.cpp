@@ -10,6 +10,12 @@ SDCardHandler::SDCardHandler()
     : mounted(false)
     , vspi(nullptr)
 {
+    for (auto& handle : handles) {
+        handle.used = false;
+        handle.fill = 0;
+    }
+    memset(&writeStats, 0, sizeof(writeStats));
+    ioMutex = xSemaphoreCreateRecursiveMutex();
 }
 
 SDCardHandler::~SDCardHandler() {
@@ -24,7 +30,7 @@ bool SDCardHandler::begin() {
     vspi->begin(SD_SCK, SD_MISO, SD_MOSI, SD_CS);
     
     // SD-Karte mounten
-    if (!SD.begin(SD_CS, *vspi, SD_SPI_FREQUENCY)) {
+    if (!SD.begin(SD_CS, *vspi, SD_SPI_FREQUENCY, "/sd", SD_MAX_FILES)) {
         DEBUG_PRINTLN("SDCardHandler: ❌ Mount fehlgeschlagen!");
         delete vspi;
         vspi = nullptr;
@@ -52,7 +58,12 @@ bool SDCardHandler::begin() {
 
 void SDCardHandler::end() {
     if (mounted) {
-        flush();
+        // Puffer schreiben und alle Handles schließen
+        xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY);
+        for (auto& handle : handles) {
+            if (handle.used) closeHandle(handle);
+        }
+        xSemaphoreGiveRecursive(ioMutex);
         SD.end();
         mounted = false;
         DEBUG_PRINTLN("SDCardHandler: SD-Karte unmounted");
@@ -86,6 +97,9 @@ uint64_t SDCardHandler::getUsedSpace() {
 bool SDCardHandler::writeFile(const char* path, const char* data) {
     if (!mounted || !path || !data) return false;
     
+    // Offenes Append-Handle vorher schließen (sonst überschreibt dessen Puffer)
+    closeFile(path);
+    
     File file = SD.open(path, FILE_WRITE);
     if (!file) {
         DEBUG_PRINTF("SDCardHandler: ❌ Kann Datei nicht öffnen: %s\n", path);
@@ -103,18 +117,51 @@ bool SDCardHandler::writeFile(const char* path, const String& data) {
 }
 
 bool SDCardHandler::appendFile(const char* path, const char* data) {
-    if (!mounted || !path || !data) return false;
-    
-    File file = SD.open(path, FILE_APPEND);
-    if (!file) {
-        DEBUG_PRINTF("SDCardHandler: ❌ Kann Datei nicht öffnen: %s\n", path);
-        return false;
+    if (!data) return false;
+    return appendFile(path, reinterpret_cast<const uint8_t*>(data), strlen(data));
+}
+
+bool SDCardHandler::appendFile(const char* path, const uint8_t* data, size_t len) {
+    if (!mounted || !path || !data || len == 0) return false;
+    
+    // Zu lange Pfade ohne Handle (altes Verhalten: Open/Append/Close)
+    if (strlen(path) >= SD_MAX_PATH) {
+        File file = SD.open(path, FILE_APPEND);
+        if (!file) {
+            DEBUG_PRINTF("SDCardHandler: ❌ Kann Datei nicht öffnen: %s\n", path);
+            return false;
+        }
+        size_t written = file.write(data, len);
+        file.close();
+        return written == len;
     }
     
-    size_t written = file.print(data);
-    file.close();
+    if (xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) != pdTRUE) return false;
     
-    return written > 0;
+    WriteHandle* handle = getHandle(path, true);
+    bool ok = handle != nullptr;
+    
+    // In den Puffer kopieren, volle Blöcke enden auf einer Sektorgrenze der Datei
+    while (ok && len > 0) {
+        size_t chunk = handle->limit - handle->fill;
+        if (chunk > len) chunk = len;
+        
+        if (handle->fill == 0) handle->dirtySince = millis();
+        memcpy(&handle->buffer[handle->fill], data, chunk);
+        handle->fill += chunk;
+        handle->fileSize += chunk;
+        writeStats.bytesBuffered += chunk;
+        data += chunk;
+        len -= chunk;
+        
+        if (handle->fill == handle->limit) {
+            ok = flushHandle(*handle, false);
+        }
+    }
+    if (handle) handle->lastUse = millis();
+    
+    xSemaphoreGiveRecursive(ioMutex);
+    return ok;
 }
 
 bool SDCardHandler::appendFile(const char* path, const String& data) {
@@ -122,13 +169,17 @@ bool SDCardHandler::appendFile(const char* path, const String& data) {
 }
 
 bool SDCardHandler::appendLine(const char* path, const String& line) {
-    String lineWithNewline = line + "\n";
-    return appendFile(path, lineWithNewline);
+    if (xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) != pdTRUE) return false;
+    bool ok = (line.length() == 0 || appendFile(path, line.c_str())) && appendFile(path, "\n");
+    xSemaphoreGiveRecursive(ioMutex);
+    return ok;
 }
 
 int SDCardHandler::readFile(const char* path, char* buffer, size_t maxLen) {
     if (!mounted || !path || !buffer) return -1;
     
+    syncPath(path);
+    
     File file = SD.open(path, FILE_READ);
     if (!file) {
         DEBUG_PRINTF("SDCardHandler: ❌ Kann Datei nicht lesen: %s\n", path);
@@ -147,6 +198,8 @@ int SDCardHandler::readFile(const char* path, char* buffer, size_t maxLen) {
 String SDCardHandler::readFileAsString(const char* path) {
     if (!mounted || !path) return String();
     
+    syncPath(path);
+    
     File file = SD.open(path, FILE_READ);
     if (!file) {
         DEBUG_PRINTF("SDCardHandler: ❌ Kann Datei nicht lesen: %s\n", path);
@@ -162,6 +215,8 @@ String SDCardHandler::readFileAsString(const char* path) {
 bool SDCardHandler::deleteFile(const char* path) {
     if (!mounted || !path) return false;
     
+    closeFile(path);
+    
     if (!SD.exists(path)) {
         DEBUG_PRINTF("SDCardHandler: Datei existiert nicht: %s\n", path);
         return false;
@@ -181,6 +236,9 @@ bool SDCardHandler::deleteFile(const char* path) {
 bool SDCardHandler::renameFile(const char* oldPath, const char* newPath) {
     if (!mounted || !oldPath || !newPath) return false;
     
+    closeFile(oldPath);
+    closeFile(newPath);
+    
     if (!SD.exists(oldPath)) {
         DEBUG_PRINTF("SDCardHandler: Datei existiert nicht: %s\n", oldPath);
         return false;
@@ -199,12 +257,27 @@ bool SDCardHandler::renameFile(const char* oldPath, const char* newPath) {
 
 bool SDCardHandler::fileExists(const char* path) {
     if (!mounted || !path) return false;
-    return SD.exists(path);
+    
+    // Offenes Handle → Datei existiert (spart den Verzeichnis-Lookup)
+    bool open = false;
+    if (xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) == pdTRUE) {
+        open = getHandle(path, false) != nullptr;
+        xSemaphoreGiveRecursive(ioMutex);
+    }
+    return open || SD.exists(path);
 }
 
 size_t SDCardHandler::getFileSize(const char* path) {
     if (!mounted || !path) return 0;
     
+    // Offenes Handle kennt die Größe inkl. Puffer
+    if (xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) == pdTRUE) {
+        WriteHandle* handle = getHandle(path, false);
+        size_t size = handle ? handle->fileSize : 0;
+        xSemaphoreGiveRecursive(ioMutex);
+        if (handle) return size;
+    }
+    
     File file = SD.open(path, FILE_READ);
     if (!file) return 0;
     
@@ -244,7 +317,47 @@ bool SDCardHandler::removeDir(const char* path) {
 
 void SDCardHandler::flush() {
     if (!mounted) return;
-    // SD.flush() falls verfügbar in neueren Arduino-Core Versionen
+    if (xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) != pdTRUE) return;
+    
+    for (auto& handle : handles) {
+        if (handle.used) flushHandle(handle, true);
+    }
+    
+    xSemaphoreGiveRecursive(ioMutex);
+}
+
+void SDCardHandler::flushIfDue(uint32_t maxAgeMs) {
+    if (!mounted) return;
+    if (xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) != pdTRUE) return;
+    
+    unsigned long now = millis();
+    for (auto& handle : handles) {
+        if (handle.used && handle.fill > 0 && (now - handle.dirtySince) >= maxAgeMs) {
+            flushHandle(handle, true);
+        }
+    }
+    
+    xSemaphoreGiveRecursive(ioMutex);
+}
+
+void SDCardHandler::closeFile(const char* path) {
+    if (!path || xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) != pdTRUE) return;
+    
+    WriteHandle* handle = getHandle(path, false);
+    if (handle) closeHandle(*handle);
+    
+    xSemaphoreGiveRecursive(ioMutex);
+}
+
+File SDCardHandler::openFile(const char* path, const char* mode) {
+    if (!mounted || !path || !mode) return File();
+    
+    closeFile(path);
+    return SD.open(path, mode);
+}
+
+void SDCardHandler::getWriteStats(SdWriteStats* stats) {
+    if (stats) *stats = writeStats;
 }
 
 void SDCardHandler::printInfo() {
@@ -268,6 +381,16 @@ void SDCardHandler::printInfo() {
         DEBUG_PRINTF("Free:       %.2f GB (%.1f%%)\n", 
                      free / 1024.0 / 1024.0 / 1024.0,
                      (free * 100.0) / total);
+        
+        int open = 0;
+        for (const auto& handle : handles) {
+            if (handle.used) open++;
+        }
+        DEBUG_PRINTF("Handles:    %d / %d offen (%lu geöffnet, %lu verdrängt)\n",
+                     open, SD_MAX_OPEN_HANDLES, writeStats.opens, writeStats.evictions);
+        DEBUG_PRINTF("Writes:     %lu Blöcke à %d B, %lu Teilblöcke, %lu Bytes\n",
+                     writeStats.blockWrites, SD_WRITE_BUFFER_SIZE,
+                     writeStats.partialWrites, writeStats.bytesBuffered);
     }
     
     DEBUG_PRINTLN("═══════════════════════════════════════════════\n");
@@ -277,6 +400,85 @@ void SDCardHandler::printInfo() {
 // PRIVATE METHODEN
 // ═══════════════════════════════════════════════════════════════════════════
 
+SDCardHandler::WriteHandle* SDCardHandler::getHandle(const char* path, bool create) {
+    // Mutex muss gehalten werden!
+    for (auto& handle : handles) {
+        if (handle.used && strcmp(handle.path, path) == 0) return &handle;
+    }
+    if (!create) return nullptr;
+    
+    // Freien Slot nehmen, sonst am längsten ungenutztes Handle verdrängen
+    WriteHandle* slot = nullptr;
+    for (auto& handle : handles) {
+        if (!handle.used) {
+            slot = &handle;
+            break;
+        }
+        if (!slot || (long)(handle.lastUse - slot->lastUse) < 0) slot = &handle;
+    }
+    if (slot->used) {
+        closeHandle(*slot);
+        writeStats.evictions++;
+    }
+    
+    slot->file = SD.open(path, FILE_APPEND);
+    if (!slot->file) {
+        DEBUG_PRINTF("SDCardHandler: ❌ Kann Datei nicht öffnen: %s\n", path);
+        return nullptr;
+    }
+    
+    strncpy(slot->path, path, SD_MAX_PATH - 1);
+    slot->path[SD_MAX_PATH - 1] = '\0';
+    slot->used = true;
+    slot->fill = 0;
+    slot->fileSize = slot->file.size();
+    slot->limit = SD_WRITE_BUFFER_SIZE - (slot->fileSize % SD_WRITE_BUFFER_SIZE);
+    slot->lastUse = millis();
+    writeStats.opens++;
+    return slot;
+}
+
+bool SDCardHandler::flushHandle(WriteHandle& handle, bool sync) {
+    bool ok = true;
+    
+    if (handle.fill > 0) {
+        size_t written = handle.file.write(handle.buffer, handle.fill);
+        ok = (written == handle.fill);
+        if (handle.fill == handle.limit) {
+            writeStats.blockWrites++;
+        } else {
+            writeStats.partialWrites++;
+        }
+        if (!ok) {
+            DEBUG_PRINTF("SDCardHandler: ❌ Schreiben fehlgeschlagen: %s\n", handle.path);
+            handle.fileSize -= handle.fill - written;
+        }
+        
+        // Nach einem Teilblock nur bis zur nächsten Sektorgrenze puffern
+        handle.fill = 0;
+        handle.limit = SD_WRITE_BUFFER_SIZE - (handle.fileSize % SD_WRITE_BUFFER_SIZE);
+    }
+    
+    // Verzeichniseintrag (Größe) nur bei sync aktualisieren
+    if (sync) handle.file.flush();
+    return ok;
+}
+
+void SDCardHandler::closeHandle(WriteHandle& handle) {
+    flushHandle(handle, false);
+    handle.file.close();
+    handle.used = false;
+}
+
+void SDCardHandler::syncPath(const char* path) {
+    if (xSemaphoreTakeRecursive(ioMutex, portMAX_DELAY) != pdTRUE) return;
+    
+    WriteHandle* handle = getHandle(path, false);
+    if (handle) flushHandle(*handle, true);
+    
+    xSemaphoreGiveRecursive(ioMutex);
+}
+
 const char* SDCardHandler::getCardTypeString(uint8_t cardType) {
     switch (cardType) {
         case CARD_MMC:  return "MMC";
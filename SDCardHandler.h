@@ -8,6 +8,9 @@
  * - Mount/Unmount auf VSPI
  * - Datei lesen/schreiben/löschen
  * - Thread-safe Operationen
+ * - Offene Datei-Handles für Append (kein Open/Close pro Zeile)
+ * - Schreibpuffer auf 512-Byte-Sektorgrenzen, Flush nach Größe, Alter
+ *   oder auf Anforderung
  */
 
 #ifndef SD_CARD_HANDLER_H
@@ -17,8 +20,45 @@
 #include <SD.h>
 #include <SPI.h>
 #include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "config.h"
 
+// ═══════════════════════════════════════════════════════════════════════════
+// SCHREIBPUFFER
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifndef SD_WRITE_BUFFER_SIZE
+#define SD_WRITE_BUFFER_SIZE    512     // Puffer pro Handle (Sektorgröße bzw. Vielfaches)
+#endif
+
+#ifndef SD_MAX_OPEN_HANDLES
+#define SD_MAX_OPEN_HANDLES     4       // Gleichzeitig offene Append-Handles (LRU)
+#endif
+
+#ifndef SD_FLUSH_INTERVAL_MS
+#define SD_FLUSH_INTERVAL_MS    1000    // Max. Alter ungeschriebener Daten
+#endif
+
+#ifndef SD_MAX_PATH
+#define SD_MAX_PATH             32      // Max. Pfadlänge für Handles
+#endif
+
+#ifndef SD_MAX_FILES
+#define SD_MAX_FILES            16      // Gleichzeitig offene Dateien (Budget siehe config.h)
+#endif
+
+/**
+ * Statistik des gepufferten Schreibpfads
+ */
+struct SdWriteStats {
+    uint32_t opens;             // Geöffnete Handles
+    uint32_t evictions;         // Wegen LRU geschlossene Handles
+    uint32_t blockWrites;       // Volle, ausgerichtete Blöcke geschrieben
+    uint32_t partialWrites;     // Teilblöcke (Flush nach Alter/Anforderung)
+    uint32_t bytesBuffered;     // Über appendFile() angenommene Bytes
+};
+
 class SDCardHandler {
 public:
     /**
@@ -98,6 +138,15 @@ public:
      */
     bool appendFile(const char* path, const String& data);
 
+    /**
+     * Binärdaten anhängen (gepuffert)
+     * @param path Dateipfad
+     * @param data Daten
+     * @param len Datenlänge
+     * @return true bei Erfolg
+     */
+    bool appendFile(const char* path, const uint8_t* data, size_t len);
+
     /**
      * Zeile anhängen (mit Newline)
      * @param path Dateipfad
@@ -166,10 +215,37 @@ public:
     bool removeDir(const char* path);
 
     /**
-     * Manuelles Flush (alle offenen Dateien)
+     * Manuelles Flush (alle offenen Dateien, Puffer und FAT-Eintrag)
      */
     void flush();
 
+    /**
+     * Puffer schreiben, deren Daten älter als maxAgeMs sind
+     * (periodisch aus dem Log-Writer aufrufen)
+     * @param maxAgeMs Max. Alter ungeschriebener Daten
+     */
+    void flushIfDue(uint32_t maxAgeMs = SD_FLUSH_INTERVAL_MS);
+
+    /**
+     * Handle einer Datei schreiben und schließen (vor externem Zugriff)
+     * @param path Dateipfad
+     */
+    void closeFile(const char* path);
+
+    /**
+     * Datei für direkten Zugriff öffnen (z.B. "r+" für Schreiben mit seek)
+     * Ein offenes Append-Handle des Pfads wird vorher geschlossen.
+     * @param path Dateipfad
+     * @param mode Modus wie bei SD.open()
+     * @return File (ungültig bei Fehler), Aufrufer schließt
+     */
+    File openFile(const char* path, const char* mode);
+
+    /**
+     * Schreib-Statistik abrufen
+     */
+    void getWriteStats(SdWriteStats* stats);
+
     /**
      * Debug-Info ausgeben
      */
@@ -179,6 +255,43 @@ private:
     bool mounted;               // Mount-Status
     SPIClass* vspi;             // VSPI-Bus Pointer
     
+    // Offene Append-Handles mit Schreibpuffer
+    struct WriteHandle {
+        bool used;
+        char path[SD_MAX_PATH];
+        File file;
+        uint8_t buffer[SD_WRITE_BUFFER_SIZE];
+        size_t fill;                // Bytes im Puffer
+        size_t limit;               // Bytes bis zur nächsten Sektorgrenze der Datei
+        size_t fileSize;            // Dateigröße inkl. Puffer
+        unsigned long lastUse;      // Für LRU (millis)
+        unsigned long dirtySince;   // Ältestes ungeschriebenes Byte (millis)
+    };
+    WriteHandle handles[SD_MAX_OPEN_HANDLES];
+    SemaphoreHandle_t ioMutex;      // Rekursiv, schützt Handles und Dateizugriffe
+    SdWriteStats writeStats;
+    
+    /**
+     * Handle suchen (optional öffnen, LRU-Verdrängung)
+     */
+    WriteHandle* getHandle(const char* path, bool create);
+    
+    /**
+     * Puffer eines Handles schreiben
+     * @param sync true = zusätzlich file.flush() (FAT-Eintrag aktualisieren)
+     */
+    bool flushHandle(WriteHandle& handle, bool sync);
+    
+    /**
+     * Handle schreiben und schließen
+     */
+    void closeHandle(WriteHandle& handle);
+    
+    /**
+     * Puffer eines Pfads schreiben (vor dem Lesen)
+     */
+    void syncPath(const char* path);
+    
     /**
      * Card-Typ als String
      */
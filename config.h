@@ -38,7 +38,7 @@
 // ESP-NOW EINSTELLUNGEN
 // ═══════════════════════════════════════════════════════════════════════════
 
-#define ESPNOW_MAX_PEERS          1           // Maximale Anzahl Peers
+#define ESPNOW_MAX_PEERS          0           // Maximale Anzahl logischer Peers (0 = unbegrenzt)
 #define ESPNOW_CHANNEL            0           // WiFi-Kanal (0 = auto)
 #define ESPNOW_HEARTBEAT_INTERVAL 500         // Heartbeat alle 500ms
 #define ESPNOW_TIMEOUT_MS         2000        // Verbindungs-Timeout 2s
@@ -50,6 +50,7 @@
 
 #define DEBUG_SERIAL        true    // Debug-Ausgaben aktivieren
 #define SERIAL_BAUD_RATE    115200  // Serielle Baudrate
+#define ESPNOW_CAPTURE      false   // ESP-NOW-Frames als pcap auf SD (Wireshark: tools/espnow.lua)
 
 // Debug-Makros
 #if DEBUG_SERIAL
@@ -68,7 +69,8 @@
 
 #define DEBOUNCE_DELAY      50     // Entprell-Zeit in ms
 #define SD_MOUNT_POINT     "/sd"   // Mount-Punkt für SD-Karte
-#define SD_MAX_FILES       10      // Maximale Anzahl offener Dateien
+#define SD_MAX_FILES       16      // Offene Dateien: 4 Append-Handles + 4 Log-Ringe + 4 Indizes
+                                   // + Capture + Flight-Dump + 2 kurzzeitig (Config, Lesen)
 
 // ═══════════════════════════════════════════════════════════════════════════
 // FEHLERCODES
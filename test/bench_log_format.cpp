@@ -0,0 +1,127 @@
+/**
+ * bench_log_format.cpp
+ *
+ * Formatierung einer Log-Zeile (Battery-Eintrag des LogManagers):
+ * - String-Verkettung (früherer LogManager-Pfad)
+ * - snprintf in festen Buffer
+ * - LogLine (LogFormat.h)
+ *
+ * Ausgabe pro Variante: ns pro Zeile und Heap-Allokationen pro Zeile.
+ * Gezählt werden operator new und malloc/calloc/realloc (glibc: __libc_malloc).
+ * Der Host-String nutzt std::string mit Small-String-Optimierung und
+ * allokiert damit eher weniger als Arduino-String auf dem ESP32.
+ */
+
+#include <chrono>
+#include <new>
+#include "host.h"
+#include "LogFormat.h"
+#include "LogManager.h"
+
+#define BENCH_RECORDS   1000000
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ALLOKATIONSZÄHLER
+// ═══════════════════════════════════════════════════════════════════════════
+
+static uint64_t allocations = 0;
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t n, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+extern "C" void* malloc(size_t size) { allocations++; return __libc_malloc(size); }
+extern "C" void* calloc(size_t n, size_t size) { allocations++; return __libc_calloc(n, size); }
+extern "C" void* realloc(void* ptr, size_t size) { allocations++; return __libc_realloc(ptr, size); }
+extern "C" void free(void* ptr) { __libc_free(ptr); }
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = __libc_malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { __libc_free(p); }
+void operator delete[](void* p) noexcept { __libc_free(p); }
+void operator delete(void* p, size_t) noexcept { __libc_free(p); }
+void operator delete[](void* p, size_t) noexcept { __libc_free(p); }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// VARIANTEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+static volatile size_t sink;
+
+static size_t formatString(uint32_t ms, float voltage, uint8_t percent, char* out) {
+    String line = "[" + String(ms) + "ms]";
+    line += " WARN - ";
+    line += "Battery";
+    line += " | Voltage: " + String(voltage, 2) + "V";
+    line += " | Percent: " + String(percent) + "%";
+    line += " [LOW]";
+    memcpy(out, line.c_str(), line.length() + 1);
+    return line.length();
+}
+
+static size_t formatSnprintf(uint32_t ms, float voltage, uint8_t percent, char* out) {
+    int n = snprintf(out, LOG_RECORD_SIZE, "[%lums] WARN - Battery | Voltage: %.2fV | Percent: %u%% [LOW]",
+                     (unsigned long)ms, (double)voltage, percent);
+    return n > 0 ? (size_t)n : 0;
+}
+
+static size_t formatLogLine(uint32_t ms, float voltage, uint8_t percent, char* out) {
+    LogLine line(out, LOG_RECORD_SIZE);
+    line << LogTime(ms) << " WARN - " << "Battery"
+         << " | Voltage: " << LogFixed(voltage, 2) << "V"
+         << " | Percent: " << percent << "%" << " [LOW]";
+    return line.length();
+}
+
+typedef size_t (*FormatFn)(uint32_t, float, uint8_t, char*);
+
+struct BenchResult {
+    double nsPerRecord;
+    double allocsPerRecord;
+};
+
+static BenchResult run(FormatFn fn) {
+    char buf[LOG_RECORD_SIZE];
+    uint64_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++) {
+        sink = fn(1000 + i, 3.3f + (i & 63) * 0.01f, static_cast<uint8_t>(i % 101), buf);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    BenchResult r;
+    r.nsPerRecord = sec * 1e9 / BENCH_RECORDS;
+    r.allocsPerRecord = (double)(allocations - before) / BENCH_RECORDS;
+    return r;
+}
+
+int main() {
+    // Gleiche Ausgabe für alle Varianten
+    char a[LOG_RECORD_SIZE], b[LOG_RECORD_SIZE], c[LOG_RECORD_SIZE];
+    formatString(12345, 3.71f, 42, a);
+    formatSnprintf(12345, 3.71f, 42, b);
+    formatLogLine(12345, 3.71f, 42, c);
+    CHECK(strcmp(a, c) == 0);
+    CHECK(strcmp(b, c) == 0);
+    printf("Zeile: %s\n", c);
+    
+    BenchResult string = run(formatString);
+    BenchResult printf_ = run(formatSnprintf);
+    BenchResult logLine = run(formatLogLine);
+    
+    printf("%-10s %10s %12s\n", "", "ns/Zeile", "Alloc/Zeile");
+    printf("%-10s %10.1f %12.2f\n", "String", string.nsPerRecord, string.allocsPerRecord);
+    printf("%-10s %10.1f %12.2f\n", "snprintf", printf_.nsPerRecord, printf_.allocsPerRecord);
+    printf("%-10s %10.1f %12.2f\n", "LogLine", logLine.nsPerRecord, logLine.allocsPerRecord);
+    
+    CHECK(logLine.allocsPerRecord == 0.0);
+    CHECK(string.allocsPerRecord > 0.0);
+    
+    return hostReport("bench_log_format");
+}
@@ -0,0 +1,130 @@
+/**
+ * bench_sd_append.cpp
+ *
+ * Log-Zeilen pro Sekunde: Öffnen/Anhängen/Schließen pro Zeile (früheres
+ * appendFile) gegen die offenen, sektorgepufferten Handles von SDCardHandler
+ *
+ * Gemessen auf dem Host-Dateisystem (test/host, Verzeichnis /tmp/host_sd):
+ * - Dateisystem-Aufrufe pro Zeile (open/close/write) – auf der Karte je ein
+ *   FAT-Zugriff, unabhängig vom Host
+ * - Zeilen/s auf dem Host (nur Vergleich, Seitencache statt SPI)
+ * - Geschätzte Zeilen/s auf der Karte aus einem einfachen Kostenmodell
+ *   (BENCH_SD_*_US), Werte grob für SPI-SD mit 4 MHz
+ */
+
+#include <chrono>
+#include "host.h"
+#include "SDCardHandler.h"
+
+#define BENCH_LINES             20000
+
+// Kostenmodell pro Dateisystem-Aufruf auf der Karte
+#define BENCH_SD_OPEN_US        2500    // Verzeichnis + Cluster-Kette bis Dateiende
+#define BENCH_SD_CLOSE_US       1500    // Verzeichniseintrag schreiben
+#define BENCH_SD_SECTOR_US      1200    // 512 Bytes über SPI inkl. Kommando
+#define BENCH_SD_PARTIAL_US     2400    // Teilsektor: Lesen + Schreiben
+
+static const char* LINE = "[00012345] I MOTOR  left=  42 right= -17 seq=12345 rssi=-61\n";
+
+struct BenchResult {
+    double hostLinesPerSec;
+    double cardLinesPerSec;
+    HostFsStats fs;
+};
+
+/**
+ * Kostenmodell: Schreibaufrufe mit vollen Sektoren vs. Teilsektoren
+ * @param fullSectors Vollständig geschriebene Sektoren
+ */
+static double cardSeconds(const HostFsStats& fs, uint64_t fullSectors) {
+    uint64_t partial = fs.writes > fullSectors ? fs.writes - fullSectors : 0;
+    double us = fs.opens * (double)BENCH_SD_OPEN_US + fs.closes * (double)BENCH_SD_CLOSE_US +
+                fullSectors * (double)BENCH_SD_SECTOR_US + partial * (double)BENCH_SD_PARTIAL_US;
+    return us / 1e6;
+}
+
+static double elapsedSec(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Früherer Pfad: jede Zeile öffnet, schreibt und schließt die Datei
+ */
+static BenchResult runLegacy(const char* path) {
+    SD.remove(path);
+    hostFsStats() = {};
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_LINES; i++) {
+        File file = SD.open(path, FILE_APPEND);
+        file.print(LINE);
+        file.close();
+    }
+    double sec = elapsedSec(start);
+    
+    BenchResult r;
+    r.fs = hostFsStats();
+    r.hostLinesPerSec = BENCH_LINES / sec;
+    r.cardLinesPerSec = BENCH_LINES / cardSeconds(r.fs, 0);
+    return r;
+}
+
+/**
+ * Gepufferter Pfad: SDCardHandler::appendFile, am Ende flush()
+ */
+static BenchResult runBuffered(SDCardHandler& sd, const char* path) {
+    sd.deleteFile(path);
+    hostFsStats() = {};
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_LINES; i++) {
+        sd.appendFile(path, LINE);
+    }
+    sd.flush();
+    sd.closeFile(path);
+    double sec = elapsedSec(start);
+    
+    SdWriteStats stats;
+    sd.getWriteStats(&stats);
+    
+    BenchResult r;
+    r.fs = hostFsStats();
+    r.hostLinesPerSec = BENCH_LINES / sec;
+    r.cardLinesPerSec = BENCH_LINES / cardSeconds(r.fs, stats.blockWrites);
+    return r;
+}
+
+static void printResult(const char* name, const BenchResult& r) {
+    printf("%-22s %8.0f %10.0f  %6.3f %6.3f %6.3f\n", name, r.hostLinesPerSec, r.cardLinesPerSec,
+           (double)r.fs.opens / BENCH_LINES, (double)r.fs.closes / BENCH_LINES,
+           (double)r.fs.writes / BENCH_LINES);
+}
+
+int main() {
+    hostFsSetRoot("/tmp/host_sd");
+    
+    SDCardHandler sd;
+    CHECK(sd.begin());
+    
+    BenchResult legacy = runLegacy("/bench_legacy.log");
+    BenchResult buffered = runBuffered(sd, "/bench_buffered.log");
+    
+    printf("%d Zeilen à %zu Bytes\n", BENCH_LINES, strlen(LINE));
+    printf("%-22s %8s %10s  %6s %6s %6s\n", "", "Host/s", "Karte/s*", "open", "close", "write");
+    printResult("open/append/close", legacy);
+    printResult("appendFile (gepuffert)", buffered);
+    printf("* Schätzung: open %d µs, close %d µs, Sektor %d µs, Teilsektor %d µs\n",
+           BENCH_SD_OPEN_US, BENCH_SD_CLOSE_US, BENCH_SD_SECTOR_US, BENCH_SD_PARTIAL_US);
+    
+    // Beide Dateien gleich groß, gepuffert mit höchstens einem Öffnen
+    // (Karte/s ist nur eine Modellschätzung und wird nicht geprüft)
+    CHECK_EQ(sd.getFileSize("/bench_legacy.log"), (size_t)BENCH_LINES * strlen(LINE));
+    CHECK_EQ(sd.getFileSize("/bench_buffered.log"), (size_t)BENCH_LINES * strlen(LINE));
+    CHECK(buffered.fs.opens <= 2);
+    CHECK(buffered.fs.writes * SD_WRITE_BUFFER_SIZE >= BENCH_LINES * strlen(LINE));
+    
+    sd.deleteFile("/bench_legacy.log");
+    sd.deleteFile("/bench_buffered.log");
+    sd.end();
+    return hostReport("bench_sd_append");
+}
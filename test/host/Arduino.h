@@ -0,0 +1,111 @@
+/**
+ * Arduino.h (Host)
+ *
+ * Minimaler Arduino-Ersatz für Host-Tests: String, Serial, Zeitfunktionen.
+ * Die Zeit läuft virtuell (host.h: hostAdvanceUs), damit Tests deterministisch
+ * sind; delay() rückt die Uhr vor.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string>
+
+#define HEX 16
+#define DEC 10
+#define INPUT 0
+#define IRAM_ATTR
+
+class String {
+public:
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    String(const std::string& c) : s(c) {}
+    String(char c) : s(1, c) {}
+    String(int v, int base = DEC) { format(base == HEX ? "%x" : "%d", v); }
+    String(unsigned v, int base = DEC) { format(base == HEX ? "%x" : "%u", v); }
+    String(long v, int base = DEC) { format(base == HEX ? "%lx" : "%ld", v); }
+    String(unsigned long v, int base = DEC) { format(base == HEX ? "%lx" : "%lu", v); }
+    String(float v, int decimals = 2) { format("%.*f", decimals, (double)v); }
+    String(double v, int decimals = 2) { format("%.*f", decimals, v); }
+    
+    const char* c_str() const { return s.c_str(); }
+    size_t length() const { return s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    
+    String& operator+=(const String& o) { s += o.s; return *this; }
+    String& operator+=(const char* o) { s += o; return *this; }
+    String& operator+=(char o) { s += o; return *this; }
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.s); }
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator==(const char* o) const { return s == o; }
+    char operator[](size_t i) const { return s[i]; }
+    
+    bool startsWith(const char* p) const { return s.rfind(p, 0) == 0; }
+    bool endsWith(const char* p) const { size_t n = strlen(p); return s.size() >= n && s.compare(s.size() - n, n, p) == 0; }
+    int indexOf(char c) const { size_t p = s.find(c); return p == std::string::npos ? -1 : (int)p; }
+    String substring(int a, int b = -1) const { return String(s.substr(a, b < 0 ? std::string::npos : b - a)); }
+    long toInt() const { return atol(s.c_str()); }
+    void toUpperCase() { for (auto& c : s) c = toupper(c); }
+
+private:
+    std::string s;
+    
+    void format(const char* fmt, ...) {
+        char b[64];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(b, sizeof(b), fmt, args);
+        va_end(args);
+        s = b;
+    }
+};
+
+/**
+ * Serial: Ausgabe nur mit HOST_VERBOSE=1 (Debug-Ausgaben der Firmware)
+ */
+struct HostSerial {
+    void begin(unsigned long) {}
+    size_t print(const char* t);
+    size_t print(const String& t) { return print(t.c_str()); }
+    size_t println(const char* t = "");
+    size_t println(const String& t) { return println(t.c_str()); }
+    int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+extern HostSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+inline void pinMode(int, int) {}
+inline int analogRead(int) { return 0; }
+inline void analogReadResolution(int) {}
+inline uint32_t analogReadMilliVolts(int) { return 0; }
+
+struct HostEsp {
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getPsramSize() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+    const char* getChipModel() { return "host"; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart() { exit(0); }
+};
+extern HostEsp ESP;
+
+inline void* ps_malloc(size_t size) { return malloc(size); }
+inline bool psramFound() { return false; }
+
+template<class T> T constrain(T v, T lo, T hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+#endif // HOST_ARDUINO_H
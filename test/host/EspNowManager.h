@@ -0,0 +1,3 @@
+// ESPNowManager.cpp bindet "EspNowManager.h" ein (Arduino-IDE unter Windows/macOS
+// ignoriert die Schreibweise) → auf Linux hierher umleiten
+#include "ESPNowManager.h"
@@ -0,0 +1,53 @@
+/**
+ * FS.h (Host)
+ *
+ * File über stdio im Host-Verzeichnis (host.h: hostFsSetRoot).
+ * Wie bei Arduino teilen Kopien eines File dasselbe Handle.
+ */
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct HostFileHandle;
+
+class File {
+public:
+    File() {}
+    explicit File(std::shared_ptr<HostFileHandle> h) : handle(h) {}
+    
+    operator bool() const;
+    size_t write(const uint8_t* data, size_t len);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t print(const char* text) { return write(reinterpret_cast<const uint8_t*>(text), strlen(text)); }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t println(const char* text = "") { return print(text) + print("\n"); }
+    int read();
+    size_t read(uint8_t* buffer, size_t len);
+    size_t readBytes(char* buffer, size_t len) { return read(reinterpret_cast<uint8_t*>(buffer), len); }
+    String readString();
+    int available();
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position();
+    size_t size();
+    void flush();
+    void close();
+    const char* name() const;
+
+private:
+    std::shared_ptr<HostFileHandle> handle;
+};
+
+namespace fs {
+class FS {};
+}
+
+#endif // HOST_FS_H
@@ -0,0 +1,31 @@
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include "FS.h"
+#include "SPI.h"
+
+#define CARD_NONE   0
+#define CARD_MMC    1
+#define CARD_SD     2
+#define CARD_SDHC   3
+
+/**
+ * SD über ein Host-Verzeichnis (host.h: hostFsSetRoot)
+ */
+struct HostSD {
+    bool begin(uint8_t cs, SPIClass& spi, uint32_t frequency, const char* mountpoint = "/sd",
+               uint8_t maxFiles = 5, bool formatIfEmpty = false);
+    void end() {}
+    uint8_t cardType() { return CARD_SDHC; }
+    uint64_t totalBytes() { return 8ULL << 30; }
+    uint64_t usedBytes() { return 0; }
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+    bool rmdir(const char* path);
+};
+extern HostSD SD;
+
+#endif // HOST_SD_H
@@ -0,0 +1,12 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#define FSPI 1
+
+class SPIClass {
+public:
+    SPIClass(int) {}
+    void begin(int, int, int, int) {}
+};
+
+#endif // HOST_SPI_H
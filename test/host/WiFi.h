@@ -0,0 +1,16 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define WIFI_STA 1
+
+struct HostWiFi {
+    void mode(int) {}
+    void disconnect() {}
+    void macAddress(uint8_t* mac) { const uint8_t own[6] = { 0x02, 0, 0, 0, 0, 0x01 }; memcpy(mac, own, 6); }
+};
+extern HostWiFi WiFi;
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include "esp_err.h"
+
+typedef void (*shutdown_handler_t)(void);
+
+inline esp_err_t esp_register_shutdown_handler(shutdown_handler_t) { return ESP_OK; }
+inline esp_err_t esp_unregister_shutdown_handler(shutdown_handler_t) { return ESP_OK; }
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_WIFI_H
+#define HOST_ESP_WIFI_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#define WIFI_SECOND_CHAN_NONE   0
+
+inline esp_err_t esp_wifi_set_channel(uint8_t, int) { return ESP_OK; }
+
+#endif // HOST_ESP_WIFI_H
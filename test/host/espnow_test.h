@@ -0,0 +1,39 @@
+/**
+ * espnow_test.h
+ *
+ * Zugriff der Host-Tests auf die Worker-Schritte von EspNowManager
+ * Auf dem Host läuft kein Worker-Task; die Tests rufen die Schritte
+ * direkt auf (EspNowManager erklärt EspNowManagerTest zum friend).
+ */
+
+#ifndef ESPNOW_TEST_H
+#define ESPNOW_TEST_H
+
+#include "ESPNowManager.h"
+
+class EspNowManagerTest {
+public:
+    /**
+     * Ein Durchlauf der TX-Queues (wie im Worker)
+     */
+    static void processTxQueue(EspNowManager& mgr) {
+        mgr.processTxQueue();
+    }
+    
+    /**
+     * Empfangenen Frame verarbeiten (wie im Worker nach onDataRecv)
+     */
+    static void handleRxFrame(EspNowManager& mgr, const uint8_t* mac, const uint8_t* data, size_t len,
+                              int8_t rssi = -50) {
+        mgr.handleRxFrame(mac, data, len, millis(), rssi, false);
+    }
+    
+    /**
+     * Ein Durchlauf des Jitter-Buffer-Playouts
+     */
+    static void processJitter(EspNowManager& mgr) {
+        mgr.processJitter();
+    }
+};
+
+#endif // ESPNOW_TEST_H
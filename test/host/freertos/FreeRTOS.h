@@ -0,0 +1,38 @@
+/**
+ * freertos/FreeRTOS.h (Host)
+ *
+ * Host-Tests laufen in einem Thread: Mutexe und kritische Abschnitte sind
+ * leer, Tasks werden angelegt aber nicht gestartet (Tests rufen die
+ * Worker-Funktionen direkt auf).
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  1
+#define pdFAIL                  0
+#define portMAX_DELAY           0xFFFFFFFFUL
+#define portTICK_PERIOD_MS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define tskNO_AFFINITY          0x7FFFFFFF
+
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+
+inline void portENTER_CRITICAL(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL(portMUX_TYPE*) {}
+inline void portENTER_CRITICAL_ISR(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL_ISR(portMUX_TYPE*) {}
+inline void portENTER_CRITICAL_SAFE(portMUX_TYPE*) {}
+inline void portEXIT_CRITICAL_SAFE(portMUX_TYPE*) {}
+#define portYIELD_FROM_ISR(x)   ((void)(x))
+
+#endif // HOST_FREERTOS_H
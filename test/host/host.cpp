@@ -0,0 +1,389 @@
+/**
+ * host.cpp
+ *
+ * Implementation der Host-Umgebung (siehe host.h)
+ */
+
+#include "host.h"
+#include <FS.h>
+#include <SD.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <deque>
+#include <string>
+#include <sys/stat.h>
+
+HostSerial Serial;
+HostEsp ESP;
+HostWiFi WiFi;
+HostSD SD;
+int hostFailures = 0;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UHR
+// ═══════════════════════════════════════════════════════════════════════════
+
+static uint64_t clockUs = 1000000;     // Start bei 1 s (millis() > 0)
+
+void hostAdvanceUs(uint64_t us) { clockUs += us; }
+uint64_t hostNowUs() { return clockUs; }
+
+unsigned long millis() { return (unsigned long)(clockUs / 1000); }
+unsigned long micros() { return (unsigned long)clockUs; }
+void delay(unsigned long ms) { clockUs += ms * 1000ULL; }
+void delayMicroseconds(unsigned int us) { clockUs += us; }
+int64_t esp_timer_get_time() { return (int64_t)clockUs; }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SERIAL
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool verbose() {
+    static int value = -1;
+    if (value < 0) value = getenv("HOST_VERBOSE") != nullptr;
+    return value;
+}
+
+size_t HostSerial::print(const char* t) {
+    if (verbose()) fputs(t, stdout);
+    return strlen(t);
+}
+
+size_t HostSerial::println(const char* t) {
+    if (verbose()) printf("%s\n", t);
+    return strlen(t) + 1;
+}
+
+int HostSerial::printf(const char* fmt, ...) {
+    if (!verbose()) return 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FREERTOS (ein Thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct HostQueue {
+    size_t length;
+    size_t itemSize;
+    std::deque<std::string> items;
+};
+
+struct HostMutex {
+    int depth;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    return new HostQueue{ length, itemSize, {} };
+}
+
+void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t) {
+    if (queue->items.size() >= queue->length) return pdFALSE;
+    queue->items.emplace_back(static_cast<const char*>(item), queue->itemSize);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t) {
+    if (queue->items.size() >= queue->length) return pdFALSE;
+    queue->items.emplace_front(static_cast<const char*>(item), queue->itemSize);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t) {
+    if (queue->items.empty()) return pdFALSE;
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t) {
+    if (queue->items.empty()) return pdFALSE;
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { return queue->items.size(); }
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) { return queue->length - queue->items.size(); }
+BaseType_t xQueueReset(QueueHandle_t queue) { queue->items.clear(); return pdPASS; }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostMutex{ 0 }; }
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return new HostMutex{ 0 }; }
+SemaphoreHandle_t xSemaphoreCreateBinary() { return new HostMutex{ 0 }; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t) { mutex->depth++; return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) { mutex->depth--; return pdTRUE; }
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t) { mutex->depth++; return pdTRUE; }
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex) { mutex->depth--; return pdTRUE; }
+void vSemaphoreDelete(SemaphoreHandle_t mutex) { delete mutex; }
+
+// Tasks werden nicht gestartet, Handle nur als Marker; der Test läuft als eigener "Task"
+static int taskMarker;
+static int mainMarker;
+static void (*delayHook)() = nullptr;
+
+void hostSetDelayHook(void (*hook)()) { delayHook = hook; }
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*,
+                                   UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    if (handle) *handle = &taskMarker;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t) {}
+void vTaskDelay(TickType_t ticks) {
+    clockUs += ticks * 1000ULL;
+    if (delayHook) delayHook();
+}
+TickType_t xTaskGetTickCount() { return (TickType_t)(clockUs / 1000); }
+void vTaskDelayUntil(TickType_t* previous, TickType_t period) { *previous += period; }
+BaseType_t xTaskDelayUntil(TickType_t* previous, TickType_t period) { *previous += period; return pdTRUE; }
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t* woken) { if (woken) *woken = pdFALSE; }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return &mainMarker; }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ESP-NOW TREIBER
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct DriverPeer {
+    uint8_t mac[6];
+    bool encrypt;
+};
+
+static std::vector<DriverPeer> driverPeers;
+static HostDriverStats driverStats;
+static std::vector<HostFrame> sentFrames;
+static esp_now_send_cb_t sendCb = nullptr;
+
+static int findDriverPeer(const uint8_t* mac) {
+    for (size_t i = 0; i < driverPeers.size(); i++) {
+        if (memcmp(driverPeers[i].mac, mac, 6) == 0) return (int)i;
+    }
+    return -1;
+}
+
+void hostDriverReset() {
+    driverPeers.clear();
+    sentFrames.clear();
+    memset(&driverStats, 0, sizeof(driverStats));
+}
+
+const HostDriverStats& hostDriverStats() { return driverStats; }
+bool hostDriverHasPeer(const uint8_t* mac) { return findDriverPeer(mac) >= 0; }
+std::vector<HostFrame>& hostSentFrames() { return sentFrames; }
+
+void hostSendStatus(const uint8_t* mac, bool success) {
+    if (!sendCb) return;
+    wifi_tx_info_t info = { nullptr, mac };
+    sendCb(&info, success ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+}
+
+esp_err_t esp_now_init() { return ESP_OK; }
+esp_err_t esp_now_deinit() { driverPeers.clear(); return ESP_OK; }
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t) { return ESP_OK; }
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) { sendCb = cb; return ESP_OK; }
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+    driverStats.addCalls++;
+    if (findDriverPeer(peer->peer_addr) >= 0) return ESP_ERR_ESPNOW_EXIST;
+    
+    // Grenzen des ESP32-Treibers
+    if (driverStats.peers >= HOST_ESPNOW_MAX_PEERS ||
+        (peer->encrypt && driverStats.encrypted >= HOST_ESPNOW_MAX_ENCRYPT)) {
+        driverStats.rejectedFull++;
+        return ESP_ERR_ESPNOW_FULL;
+    }
+    
+    DriverPeer entry;
+    memcpy(entry.mac, peer->peer_addr, 6);
+    entry.encrypt = peer->encrypt;
+    driverPeers.push_back(entry);
+    driverStats.peers++;
+    if (peer->encrypt) driverStats.encrypted++;
+    if (driverStats.peers > driverStats.maxPeers) driverStats.maxPeers = driverStats.peers;
+    if (driverStats.encrypted > driverStats.maxEncrypted) driverStats.maxEncrypted = driverStats.encrypted;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_del_peer(const uint8_t* mac) {
+    driverStats.delCalls++;
+    int index = findDriverPeer(mac);
+    if (index < 0) return ESP_ERR_ESPNOW_NOT_FOUND;
+    
+    if (driverPeers[index].encrypt) driverStats.encrypted--;
+    driverPeers.erase(driverPeers.begin() + index);
+    driverStats.peers--;
+    return ESP_OK;
+}
+
+bool esp_now_is_peer_exist(const uint8_t* mac) {
+    return findDriverPeer(mac) >= 0;
+}
+
+esp_err_t esp_now_send(const uint8_t* mac, const uint8_t* data, size_t len) {
+    if (len > ESP_NOW_MAX_DATA_LEN) return ESP_ERR_ESPNOW_ARG;
+    if (findDriverPeer(mac) < 0) {
+        driverStats.sendUnknown++;
+        return ESP_ERR_ESPNOW_NOT_FOUND;
+    }
+    
+    HostFrame frame;
+    memcpy(frame.mac, mac, 6);
+    frame.data.assign(data, data + len);
+    sentFrames.push_back(frame);
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATEISYSTEM
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct HostFileHandle {
+    FILE* fp;
+    std::string name;
+    
+    ~HostFileHandle() {
+        if (fp) {
+            fclose(fp);
+            hostFsStats().closes++;
+        }
+    }
+};
+
+static std::string fsRoot = "/tmp/host_sd";
+static HostFsStats fsStats;
+
+HostFsStats& hostFsStats() { return fsStats; }
+
+void hostFsSetRoot(const char* dir) {
+    fsRoot = dir;
+    mkdir(dir, 0755);
+}
+
+static std::string hostPath(const char* path) {
+    return fsRoot + (path[0] == '/' ? "" : "/") + path;
+}
+
+File::operator bool() const { return handle && handle->fp; }
+
+size_t File::write(const uint8_t* data, size_t len) {
+    if (!*this) return 0;
+    fsStats.writes++;
+    fsStats.bytesWritten += len;
+    return fwrite(data, 1, len, handle->fp);
+}
+
+int File::read() {
+    if (!*this) return -1;
+    return fgetc(handle->fp);
+}
+
+size_t File::read(uint8_t* buffer, size_t len) {
+    if (!*this) return 0;
+    return fread(buffer, 1, len, handle->fp);
+}
+
+String File::readString() {
+    std::string text;
+    int c;
+    while ((c = read()) >= 0) text += (char)c;
+    return String(text);
+}
+
+int File::available() {
+    if (!*this) return 0;
+    return (int)(size() - position());
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!*this) return false;
+    int whence = mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END);
+    return fseek(handle->fp, pos, whence) == 0;
+}
+
+size_t File::position() {
+    return *this ? (size_t)ftell(handle->fp) : 0;
+}
+
+size_t File::size() {
+    if (!*this) return 0;
+    long pos = ftell(handle->fp);
+    fseek(handle->fp, 0, SEEK_END);
+    long end = ftell(handle->fp);
+    fseek(handle->fp, pos, SEEK_SET);
+    return (size_t)end;
+}
+
+void File::flush() {
+    if (*this) fflush(handle->fp);
+}
+
+void File::close() {
+    if (handle && handle->fp) {
+        fclose(handle->fp);
+        handle->fp = nullptr;
+        fsStats.closes++;
+    }
+    handle.reset();
+}
+
+const char* File::name() const {
+    return handle ? handle->name.c_str() : "";
+}
+
+bool HostSD::begin(uint8_t, SPIClass&, uint32_t, const char*, uint8_t, bool) {
+    ::mkdir(fsRoot.c_str(), 0755);
+    return true;
+}
+
+File HostSD::open(const char* path, const char* mode, bool) {
+    std::string m = mode;
+    if (m == "r+" && !exists(path)) return File();
+    FILE* fp = fopen(hostPath(path).c_str(), (m + "b").c_str());
+    if (!fp) return File();
+    
+    fsStats.opens++;
+    auto handle = std::make_shared<HostFileHandle>();
+    handle->fp = fp;
+    handle->name = path;
+    return File(handle);
+}
+
+bool HostSD::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool HostSD::remove(const char* path) { return ::remove(hostPath(path).c_str()) == 0; }
+bool HostSD::rename(const char* from, const char* to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+bool HostSD::mkdir(const char* path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+bool HostSD::rmdir(const char* path) { return ::rmdir(hostPath(path).c_str()) == 0; }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ERGEBNIS
+// ═══════════════════════════════════════════════════════════════════════════
+
+int hostReport(const char* name) {
+    if (hostFailures == 0) {
+        printf("%s: OK\n", name);
+        return 0;
+    }
+    printf("%s: %d Fehler\n", name, hostFailures);
+    return 1;
+}
@@ -0,0 +1,120 @@
+/**
+ * host.h
+ *
+ * Steuerung der Host-Umgebung für Tests und Benchmarks
+ *
+ * - Virtuelle Uhr (millis, micros, esp_timer_get_time)
+ * - Simulierter ESP-NOW-Treiber mit der Peer-Tabelle des ESP32
+ *   (20 Einträge inkl. Broadcast, davon 6 verschlüsselt)
+ * - Dateisystem: SD.open() arbeitet in einem Host-Verzeichnis
+ * - Kleine Prüf-Makros (CHECK, CHECK_EQ) ohne Test-Framework
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <Arduino.h>
+#include <vector>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UHR
+// ═══════════════════════════════════════════════════════════════════════════
+
+void hostAdvanceUs(uint64_t us);
+uint64_t hostNowUs();
+
+/**
+ * Bei jedem vTaskDelay() aufrufen (z.B. Worker-Schritt, während der Aufrufer
+ * auf den nicht laufenden Worker-Task wartet), nullptr = aus
+ */
+void hostSetDelayHook(void (*hook)());
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ESP-NOW TREIBER
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define HOST_ESPNOW_MAX_PEERS       20      // ESP_NOW_MAX_TOTAL_PEER_NUM
+#define HOST_ESPNOW_MAX_ENCRYPT     6       // ESP_NOW_MAX_ENCRYPT_PEER_NUM
+
+/**
+ * Von esp_now_send() übergebener Frame
+ */
+struct HostFrame {
+    uint8_t mac[6];
+    std::vector<uint8_t> data;
+};
+
+/**
+ * Zustand des simulierten Treibers
+ */
+struct HostDriverStats {
+    int peers;                  // Aktuell registriert (inkl. Broadcast)
+    int encrypted;              // Davon verschlüsselt
+    int maxPeers;               // Höchststand
+    int maxEncrypted;
+    uint32_t addCalls;
+    uint32_t delCalls;
+    uint32_t rejectedFull;      // add_peer mit voller Tabelle
+    uint32_t sendUnknown;       // send an nicht registrierten Peer (ESP_ERR_ESPNOW_NOT_FOUND)
+};
+
+void hostDriverReset();
+const HostDriverStats& hostDriverStats();
+bool hostDriverHasPeer(const uint8_t* mac);
+
+// Gesendete Frames (wird von Tests geleert)
+std::vector<HostFrame>& hostSentFrames();
+
+/**
+ * Sendestatus eines Frames über den registrierten Sende-Callback melden
+ * (der Treiber ruft ihn nicht selbst auf)
+ */
+void hostSendStatus(const uint8_t* mac, bool success);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATEISYSTEM
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Host-Verzeichnis als Wurzel für SD.open() (wird angelegt)
+ */
+void hostFsSetRoot(const char* dir);
+
+/**
+ * Zähler der Dateisystem-Aufrufe (entsprechen auf der Karte FAT-Zugriffen)
+ */
+struct HostFsStats {
+    uint32_t opens;
+    uint32_t closes;
+    uint32_t writes;
+    uint64_t bytesWritten;
+};
+HostFsStats& hostFsStats();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRÜFUNGEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern int hostFailures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: FEHLER: %s\n", __FILE__, __LINE__, #cond); \
+        hostFailures++; \
+    } \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long va_ = (long long)(a), vb_ = (long long)(b); \
+    if (va_ != vb_) { \
+        fprintf(stderr, "%s:%d: FEHLER: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, va_, vb_); \
+        hostFailures++; \
+    } \
+} while (0)
+
+/**
+ * Ergebnis ausgeben, Exit-Code für run_tests.sh
+ */
+int hostReport(const char* name);
+
+#endif // HOST_H
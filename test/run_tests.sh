@@ -0,0 +1,73 @@
+#!/bin/sh
+#
+# run_tests.sh
+#
+# Host-Tests und Benchmarks bauen und ausführen (Linux/macOS, g++ oder clang++)
+# Die Firmware-Quellen laufen gegen die Host-Umgebung in test/host
+# (virtuelle Uhr, simulierter ESP-NOW-Treiber, Dateisystem in /tmp).
+#
+# Aufruf (aus beliebigem Verzeichnis):
+#   test/run_tests.sh [NAME...]       z.B. test/run_tests.sh test_peer_slots
+#
+# Einzeln von Hand (aus dem Repo-Verzeichnis), Quellen siehe sources():
+#   g++ -std=gnu++2b -O2 -I test/host -I . -DSD_SPI_FREQUENCY=4000000 -o test_jitter \
+#       test/host/host.cpp ESPNowManager.cpp test/test_jitter.cpp
+#
+# Umgebung:
+#   CXX=clang++        Compiler
+#   HOST_VERBOSE=1     Debug-Ausgaben der Firmware (Serial) anzeigen
+#
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BUILD=${BUILD:-"$ROOT/_host_build"}
+CXX=${CXX:-g++}
+CXXFLAGS="-std=gnu++2b -O2 -g -I$ROOT/test/host -I$ROOT -DSD_SPI_FREQUENCY=4000000"
+
+# Firmware-Quellen pro Test
+sources() {
+    case "$1" in
+        test_peer_slots)    echo "ESPNowManager.cpp" ;;
+        test_link_loss)     echo "ESPNowManager.cpp" ;;
+        test_jitter)        echo "ESPNowManager.cpp" ;;
+        test_tx_pool)       echo "ESPNowManager.cpp" ;;
+        test_fec_loss)      echo "ESPNowManager.cpp" ;;
+        test_subscriptions) echo "ESPNowManager.cpp" ;;
+        test_imu_batch)     echo "ESPNowManager.cpp" ;;
+        test_codec)         echo "ESPNowManager.cpp" ;;
+        bench_sd_append)    echo "SDCardHandler.cpp" ;;
+        bench_log_format)   echo "LogFormat.cpp" ;;
+        *)                  echo "" ;;
+    esac
+}
+
+mkdir -p "$BUILD"
+
+if [ $# -eq 0 ]; then
+    set -- $(cd "$ROOT/test" && ls test_*.cpp bench_*.cpp 2>/dev/null | sed 's/\.cpp$//')
+fi
+
+failed=0
+for name in "$@"; do
+    files=""
+    for src in $(sources "$name"); do
+        files="$files $ROOT/$src"
+    done
+
+    echo "═══ $name"
+    if ! $CXX $CXXFLAGS -o "$BUILD/$name" "$ROOT/test/host/host.cpp" $files "$ROOT/test/$name.cpp"; then
+        echo "$name: Build fehlgeschlagen"
+        failed=$((failed + 1))
+        continue
+    fi
+    if ! "$BUILD/$name"; then
+        failed=$((failed + 1))
+    fi
+done
+
+if [ $failed -ne 0 ]; then
+    echo "❌ $failed fehlgeschlagen"
+    exit 1
+fi
+echo "✅ Alle bestanden"
@@ -0,0 +1,131 @@
+/**
+ * test_codec.cpp
+ *
+ * Kompakte Einträge mit Delta-Kontext über den Manager (Loopback)
+ * - EspNowManager::addPacked kodiert nach dem ersten Absolutwert als DELTA,
+ *   der Empfänger dekodiert alle Werte ohne verworfene Deltas
+ * - Gebaute, aber nie gesendete Pakete verändern den Kontext des Senders nicht
+ *   (früher: Referenz übersprungen → Empfänger bis zum nächsten Absolutwert blind)
+ * - Ohne Dekodier-Puffer bleiben kompakte Einträge nur als PACKED sichtbar
+ */
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+#define CODEC_FRAMES    40
+
+static const uint8_t PEER_MAC[6] = { 0x24, 0x6F, 0x28, 0x00, 0x06, 0x01 };
+
+static int received = 0;
+static int wrong = 0;
+static int deltaFrames = 0;
+static int16_t expected[3];
+
+static void valuesFor(int i, int32_t* fields) {
+    fields[0] = 1000 + i * 3;
+    fields[1] = -200 - i;
+    fields[2] = (i % 5) * 7;
+}
+
+/**
+ * Einen Wert senden und über den Treiber zurückspielen
+ * @param discard Vorher ein Paket bauen und verwerfen
+ */
+static void roundTrip(EspNowManager& mgr, int i, bool discard) {
+    int32_t fields[3];
+    valuesFor(i, fields);
+    
+    if (discard) {
+        int32_t other[3] = { -1, -1, -1 };
+        EspNowPacket unused;
+        unused.begin(MainCmd::DATA_RESPONSE);
+        CHECK(mgr.addPacked(PEER_MAC, unused, DataCmd::CUSTOM_1, other, 3, 2));
+    }
+    
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE);
+    CHECK(mgr.addPacked(PEER_MAC, packet, DataCmd::CUSTOM_1, fields, 3, 2));
+    
+    hostSentFrames().clear();
+    CHECK(mgr.send(PEER_MAC, packet));
+    EspNowManagerTest::processTxQueue(mgr);
+    CHECK_EQ(hostSentFrames().size(), 1);
+    
+    for (int f = 0; f < 3; f++) {
+        expected[f] = static_cast<int16_t>(fields[f]);
+    }
+    for (const HostFrame& frame : hostSentFrames()) {
+        // Format-Byte des kompakten Eintrags: [7:6] Codec
+        EspNowPacket raw;
+        CHECK(raw.parse(frame.data.data(), frame.data.size()));
+        const uint8_t* packed = raw.getData(DataCmd::PACKED);
+        if (packed && (packed[1] >> 6) == static_cast<uint8_t>(EspNowCodec::DELTA)) deltaFrames++;
+        EspNowManagerTest::handleRxFrame(mgr, PEER_MAC, frame.data.data(), frame.data.size());
+    }
+    ResultQueueItem result;
+    while (mgr.getData(&result)) {}
+    hostAdvanceUs(10000);
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    mgr.setHeartbeat(false);
+    mgr.setLaneRate(EspNowLane::TELEMETRY, 0, 0);
+    CHECK(mgr.addPeer(PEER_MAC));
+    mgr.setReceiveCallback([](const uint8_t*, EspNowPacket& packet) {
+        size_t len;
+        const int16_t* values = reinterpret_cast<const int16_t*>(packet.getData(DataCmd::CUSTOM_1, &len));
+        if (!values || len != 6) return;
+        received++;
+        if (memcmp(values, expected, 6) != 0) wrong++;
+    });
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Loopback: jedes zweite Mal ein verworfenes Paket dazwischen
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    EspNowCodecStats before;
+    EspNowPacket::getCodecStats(&before);
+    
+    for (int i = 0; i < CODEC_FRAMES; i++) {
+        roundTrip(mgr, i, i % 2 == 1);
+    }
+    
+    EspNowCodecStats after;
+    EspNowPacket::getCodecStats(&after);
+    printf("Codec: %d / %d empfangen, %d als Delta, %d falsch, %lu Deltas verworfen\n", received, CODEC_FRAMES,
+           deltaFrames, wrong, (unsigned long)(after.deltaMisses - before.deltaMisses));
+    
+    CHECK_EQ(received, CODEC_FRAMES);
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(after.deltaMisses, before.deltaMisses);
+    
+    // Nach dem ersten Wert als Delta kodiert, Absolutwert alle ESPNOW_CODEC_ABS_INTERVAL
+    CHECK(deltaFrames >= CODEC_FRAMES - 1 - CODEC_FRAMES / ESPNOW_CODEC_ABS_INTERVAL);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Ohne Dekodier-Puffer: nur der PACKED-Eintrag
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    int32_t fields[3] = { 1, 2, 3 };
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE).addPacked(DataCmd::CUSTOM_1, fields, 3, 2);
+    
+    EspNowPacket plain;
+    CHECK(plain.parse(packet.getRawData(), packet.getTotalLength()));
+    CHECK(plain.has(DataCmd::PACKED));
+    CHECK(!plain.has(DataCmd::CUSTOM_1));
+    
+    uint8_t decodeBuf[ESPNOW_CODEC_DECODE_SIZE];
+    plain.setDecodeBuffer(decodeBuf, sizeof(decodeBuf));
+    CHECK(plain.parse(packet.getRawData(), packet.getTotalLength()));
+    int16_t value;
+    CHECK(plain.getInt16(DataCmd::CUSTOM_1, value));
+    CHECK_EQ(value, 1);
+    
+    mgr.end();
+    return hostReport("test_codec");
+}
@@ -0,0 +1,173 @@
+/**
+ * test_fec_loss.cpp
+ *
+ * FEC (XOR-Parity) bei simuliertem Funkverlust
+ * Gesendete Frames (Daten + Parity) gehen mit Verlustrate p verloren, der Rest
+ * läuft über handleRxFrame zurück in denselben Manager (Loopback über den
+ * simulierten Treiber). Ausgegeben wird pro k und p:
+ *   roh        Anteil verlorener Daten-Frames auf der Luft
+ *   effektiv   Anteil nach Rekonstruktion nicht zugestellter Daten-Frames
+ *   Theorie    p · (1 - (1 - p)^k)  (Frame fehlt und ein weiterer der Gruppe fehlt)
+ *   Overhead   Parity-Frames pro Daten-Frame
+ *
+ * Außerdem: Parity unvollständiger Gruppen (Flush nach ESPNOW_FEC_FLUSH_MS) geht
+ * über die Lane der Gruppe und erreicht auch aus dem Treiber verdrängte Peers.
+ */
+
+#include <algorithm>
+#include <random>
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+#define FRAMES  4000
+
+static std::vector<bool> delivered;
+
+struct LossResult {
+    float raw;
+    float effective;
+    float overhead;
+    uint32_t recovered;
+};
+
+/**
+ * FRAMES Daten-Frames an mac senden, mit Verlust p zurückspielen
+ */
+static LossResult simulate(EspNowManager& mgr, const uint8_t* mac, uint8_t k, float p, uint32_t seed) {
+    mgr.setFec(true, k);
+    CHECK(mgr.addPeer(mac));
+    
+    EspNowFecStats before;
+    mgr.getFecStats(&before);
+    
+    // Senden mit 500 Hz: auch k=8 füllt eine Gruppe vor ESPNOW_FEC_FLUSH_MS
+    hostSentFrames().clear();
+    for (int i = 0; i < FRAMES; i++) {
+        EspNowPacket packet;
+        packet.begin(MainCmd::DATA_RESPONSE).addUInt16(DataCmd::CUSTOM_1, static_cast<uint16_t>(i));
+        CHECK(mgr.send(mac, packet));
+        EspNowManagerTest::processTxQueue(mgr);
+        hostAdvanceUs(2000);
+    }
+    hostAdvanceUs(ESPNOW_FEC_FLUSH_MS * 1000UL);
+    EspNowManagerTest::processTxQueue(mgr);
+    
+    // Verlust auf der Luft, Rest empfangen
+    std::vector<HostFrame> air = hostSentFrames();
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution lose(p);
+    delivered.assign(FRAMES, false);
+    
+    int dataLost = 0, parityFrames = 0;
+    for (const HostFrame& frame : air) {
+        bool isParity = frame.data[0] == static_cast<uint8_t>(MainCmd::FEC_PARITY);
+        if (isParity) parityFrames++;
+        if (lose(rng)) {
+            if (!isParity) dataLost++;
+            continue;
+        }
+        EspNowManagerTest::handleRxFrame(mgr, mac, frame.data.data(), frame.data.size());
+        ResultQueueItem result;
+        while (mgr.getData(&result)) {}
+    }
+    
+    int missing = 0;
+    for (bool ok : delivered) {
+        if (!ok) missing++;
+    }
+    
+    EspNowFecStats after;
+    mgr.getFecStats(&after);
+    
+    LossResult r;
+    r.raw = static_cast<float>(dataLost) / FRAMES;
+    r.effective = static_cast<float>(missing) / FRAMES;
+    r.overhead = static_cast<float>(parityFrames) / FRAMES;
+    r.recovered = after.recovered - before.recovered;
+    
+    // Jeder fehlende Frame ist entweder rekonstruiert oder zählt als Restverlust
+    CHECK_EQ(dataLost, missing + static_cast<int>(r.recovered));
+    return r;
+}
+
+/**
+ * Mehr Peers als Treiber-Slots, je ein Frame auf BULK → Flush-Parity für jeden
+ */
+static void flushEvicted(EspNowManager& mgr) {
+    const int count = 2 * HOST_ESPNOW_MAX_PEERS;
+    mgr.setFec(true, 4);
+    
+    for (int i = 0; i < count; i++) {
+        uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0x00, 0x04, static_cast<uint8_t>(i) };
+        CHECK(mgr.addPeer(mac));
+        EspNowPacket packet;
+        packet.begin(MainCmd::DATA_RESPONSE).addByte(DataCmd::CUSTOM_1, 1);
+        CHECK(mgr.send(mac, packet, EspNowLane::BULK));
+        EspNowManagerTest::processTxQueue(mgr);
+    }
+    
+    EspNowLaneStats before;
+    mgr.getLaneStats(EspNowLane::BULK, &before);
+    uint32_t unknown = hostDriverStats().sendUnknown;
+    hostSentFrames().clear();
+    
+    // Lane-Queue und Buffer-Kontingent fassen weniger als count Frames → über mehrere Durchläufe
+    const int perPass = std::min(ESPNOW_TX_QUEUE_SIZE, ESPNOW_TX_LANE_BUFFERS);
+    hostAdvanceUs(ESPNOW_FEC_FLUSH_MS * 1000UL);
+    for (int pass = 0; pass < count / perPass + 1; pass++) {
+        EspNowManagerTest::processTxQueue(mgr);
+    }
+    
+    int parity = 0;
+    for (const HostFrame& frame : hostSentFrames()) {
+        if (frame.data[0] == static_cast<uint8_t>(MainCmd::FEC_PARITY)) parity++;
+    }
+    EspNowLaneStats after;
+    mgr.getLaneStats(EspNowLane::BULK, &after);
+    printf("Flush: %d Peers, %d Parity-Frames, %lu über BULK\n",
+           count, parity, (unsigned long)(after.sent - before.sent));
+    
+    CHECK_EQ(parity, count);
+    CHECK_EQ(after.sent - before.sent, count);
+    CHECK_EQ(hostDriverStats().sendUnknown, unknown);
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    mgr.setHeartbeat(false);
+    mgr.setLaneRate(EspNowLane::TELEMETRY, 0, 0);
+    mgr.setReceiveCallback([](const uint8_t*, EspNowPacket& packet) {
+        uint16_t id;
+        if (packet.getUInt16(DataCmd::CUSTOM_1, id) && id < delivered.size()) delivered[id] = true;
+    });
+    
+    const uint8_t ks[] = { 2, 4, 8 };
+    const float losses[] = { 0.01f, 0.02f, 0.05f, 0.10f };
+    
+    printf("  k  Verlust    roh  effektiv  Theorie  rekonstruiert  Overhead\n");
+    int run = 0;
+    for (uint8_t k : ks) {
+        for (float p : losses) {
+            uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0x00, 0x03, static_cast<uint8_t>(run) };
+            LossResult r = simulate(mgr, mac, k, p, 1000 + run);
+            float theory = p * (1.0f - powf(1.0f - p, k));
+            printf("%3d  %5.1f %%  %5.2f %%  %6.2f %%  %5.2f %%  %13lu  %6.1f %%\n",
+                   k, p * 100.0f, r.raw * 100.0f, r.effective * 100.0f, theory * 100.0f,
+                   (unsigned long)r.recovered, r.overhead * 100.0f);
+            
+            CHECK(r.effective < r.raw);
+            CHECK(r.effective <= theory * 1.5f + 0.002f);
+            CHECK(fabsf(r.overhead - 1.0f / k) < 0.01f);
+            run++;
+        }
+    }
+    
+    flushEvicted(mgr);
+    
+    mgr.end();
+    return hostReport("test_fec_loss");
+}
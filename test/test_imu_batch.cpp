@@ -0,0 +1,79 @@
+/**
+ * test_imu_batch.cpp
+ *
+ * IMU-Batches von mehreren Absendern
+ * - Zwei Peers senden abwechselnd Batches mit eigener Zeitbasis
+ * - readImuSamples liefert pro Aufruf nur Samples eines Absenders samt MAC,
+ *   Reihenfolge und Zeitstempel pro Absender bleiben erhalten
+ */
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+#define BATCHES     4
+#define PER_BATCH   5
+
+static const uint8_t PEER_A[6] = { 0x24, 0x6F, 0x28, 0x00, 0x07, 0x01 };
+static const uint8_t PEER_B[6] = { 0x24, 0x6F, 0x28, 0x00, 0x07, 0x02 };
+
+/**
+ * Ein Batch mit PER_BATCH Samples ab Sample first (Zeitbasis base)
+ */
+static void receiveBatch(EspNowManager& mgr, const uint8_t* mac, uint32_t base, int first) {
+    EspNowImuBatcher batcher(DataCmd::ACCEL_BATCH);
+    for (int i = first; i < first + PER_BATCH; i++) {
+        CHECK(batcher.addSample(static_cast<int16_t>(i), 0, 0, base + i * 1000));
+    }
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE);
+    CHECK(batcher.appendTo(packet));
+    EspNowManagerTest::handleRxFrame(mgr, mac, packet.getRawData(), packet.getTotalLength());
+    
+    ResultQueueItem result;
+    while (mgr.getData(&result)) {}
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    mgr.setHeartbeat(false);
+    CHECK(mgr.addPeer(PEER_A));
+    CHECK(mgr.addPeer(PEER_B));
+    
+    // Verschiedene Zeitbasen: A nahe 0, B nahe 5 s
+    for (int b = 0; b < BATCHES; b++) {
+        receiveBatch(mgr, PEER_A, 0, b * PER_BATCH);
+        receiveBatch(mgr, PEER_B, 5000000, b * PER_BATCH);
+    }
+    CHECK_EQ(mgr.getImuAvailable(DataCmd::ACCEL_BATCH), 2 * BATCHES * PER_BATCH);
+    
+    // Großer Leser-Puffer: trotzdem nur ein Absender pro Aufruf
+    EspNowImuSample samples[64];
+    uint8_t mac[6];
+    int next[2] = { 0, 0 };
+    int reads = 0;
+    int n;
+    while ((n = mgr.readImuSamples(DataCmd::ACCEL_BATCH, samples, 64, mac)) > 0) {
+        bool isA = memcmp(mac, PEER_A, 6) == 0;
+        CHECK(isA || memcmp(mac, PEER_B, 6) == 0);
+        CHECK_EQ(n, PER_BATCH);
+        
+        uint32_t base = isA ? 0 : 5000000;
+        for (int i = 0; i < n; i++) {
+            int expected = next[isA ? 0 : 1]++;
+            CHECK_EQ(samples[i].x, expected);
+            CHECK_EQ(samples[i].timestampUs, base + expected * 1000);
+        }
+        reads++;
+    }
+    printf("IMU: %d Lesevorgänge, A %d / B %d Samples\n", reads, next[0], next[1]);
+    CHECK_EQ(reads, 2 * BATCHES);
+    CHECK_EQ(next[0], BATCHES * PER_BATCH);
+    CHECK_EQ(next[1], BATCHES * PER_BATCH);
+    CHECK_EQ(mgr.getImuDropped(DataCmd::ACCEL_BATCH), 0);
+    
+    mgr.end();
+    return hostReport("test_imu_batch");
+}
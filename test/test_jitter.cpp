@@ -0,0 +1,168 @@
+/**
+ * test_jitter.cpp
+ *
+ * Jitter-Buffer für Motor-Befehle
+ * - Jitter-Schätzung unabhängig von der Ausgabeperiode: ein Sender mit 100 Hz
+ *   und ±1 ms Streuung ergibt bei 50 Hz Ausgabe die Mindestverzögerung
+ * - Verlorene Frames verfälschen die Schätzung nicht (Abstand pro Sequenzschritt)
+ * - Motor-Befehle nur von der Motor-Quelle (erster Absender bzw. festgelegt)
+ * - Mehr als vier Peers mit Jitter-Buffer werden in jedem Durchlauf ausgegeben
+ * - Sender schneller als die Ausgabe (19,6 ms und 10 ms gegen 20 ms): das
+ *   Alter ausgegebener Frames bleibt unter ESPNOW_JITTER_MAX_DELAY_MS
+ */
+
+#include <algorithm>
+#include <random>
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+#define PEERS   8
+#define DRIFT_RUN_US    20000000UL      // 20 s: bei 2 % Drift mehr als ein voller Puffer
+
+static void makeMac(uint8_t* mac, int i) {
+    const uint8_t base[6] = { 0x24, 0x6F, 0x28, 0x00, 0x01, 0x00 };
+    memcpy(mac, base, 6);
+    mac[5] = static_cast<uint8_t>(i);
+}
+
+static void receiveMotor(EspNowManager& mgr, const uint8_t* mac, uint16_t seq, int16_t value) {
+    int16_t motors[2] = { value, value };
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE).addUInt16(DataCmd::SEQUENCE, seq)
+          .add(DataCmd::MOTOR_ALL, motors, sizeof(motors));
+    EspNowManagerTest::handleRxFrame(mgr, mac, packet.getRawData(), packet.getTotalLength());
+    
+    ResultQueueItem result;
+    while (mgr.getData(&result)) {}
+}
+
+static int playouts = 0;
+
+/**
+ * Sender mit fester Periode, Worker-Durchlauf jede Millisekunde
+ * @return Größtes Alter (Empfang → Ausgabe) eines ausgegebenen Frames in µs
+ */
+static uint32_t driftRun(EspNowManager& mgr, const uint8_t* mac, uint32_t sendPeriodUs) {
+    std::vector<unsigned long> arrival;
+    uint32_t maxAge = 0;
+    mgr.setPlayoutCallback([&](const EspNowMotorCommand& command) {
+        if (command.held || memcmp(command.mac, mac, 6) != 0 || command.seq >= arrival.size()) return;
+        maxAge = std::max(maxAge, (uint32_t)(command.playoutUs - arrival[command.seq]));
+    });
+    
+    uint64_t start = hostNowUs();
+    uint64_t nextSend = start, nextWork = start;
+    while (hostNowUs() - start < DRIFT_RUN_US) {
+        hostAdvanceUs(std::min(nextSend, nextWork) - hostNowUs());
+        if (hostNowUs() >= nextSend) {
+            arrival.push_back(micros());
+            receiveMotor(mgr, mac, static_cast<uint16_t>(arrival.size() - 1), 1);
+            nextSend += sendPeriodUs;
+        }
+        if (hostNowUs() >= nextWork) {
+            EspNowManagerTest::processJitter(mgr);
+            nextWork += 1000;
+        }
+    }
+    
+    mgr.setPlayoutCallback([](const EspNowMotorCommand&) { playouts++; });
+    return maxAge;
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    mgr.setJitterBuffer(true, 20);
+    mgr.setPlayoutCallback([](const EspNowMotorCommand&) { playouts++; });
+    
+    uint8_t mac[6];
+    for (int i = 0; i < PEERS; i++) {
+        makeMac(mac, i);
+        CHECK(mgr.addPeer(mac));
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Sender 100 Hz ±1 ms, 5 % Verlust, Ausgabe 50 Hz
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> spread(-1000, 1000);
+    std::bernoulli_distribution lose(0.05);
+    
+    makeMac(mac, 0);
+    for (uint16_t seq = 0; seq < 500; seq++) {
+        hostAdvanceUs(10000 + spread(rng));
+        if (lose(rng)) continue;
+        receiveMotor(mgr, mac, seq, 10);
+    }
+    
+    EspNowJitterStats stats;
+    CHECK(mgr.getJitterStats(mac, &stats));
+    printf("100 Hz ±1 ms bei 50 Hz Ausgabe: Jitter %lu µs, Verzögerung %lu µs\n",
+           (unsigned long)stats.jitterUs, (unsigned long)stats.delayUs);
+    CHECK(stats.jitterUs < 1500);
+    CHECK_EQ(stats.delayUs, ESPNOW_JITTER_MIN_DELAY_MS * 1000UL);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Motor-Quelle: erster Absender übernommen, andere Peers verworfen
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    uint8_t source[6];
+    CHECK(mgr.getMotorSource(source));
+    CHECK(memcmp(source, mac, 6) == 0);
+    
+    uint8_t other[6];
+    makeMac(other, 1);
+    receiveMotor(mgr, other, 0, -50);
+    CHECK_EQ(mgr.getMotorRejected(), 1);
+    CHECK(!mgr.getJitterStats(other, &stats));
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Alle Peers fällig → alle in einem Durchlauf ausgegeben
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    const uint8_t anySource[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    mgr.setMotorSource(anySource);
+    
+    for (int i = 0; i < PEERS; i++) {
+        makeMac(mac, i);
+        receiveMotor(mgr, mac, 1000, static_cast<int16_t>(i));
+    }
+    hostAdvanceUs(ESPNOW_JITTER_MAX_DELAY_MS * 1000UL);
+    
+    playouts = 0;
+    EspNowManagerTest::processJitter(mgr);
+    CHECK_EQ(playouts, PEERS);
+    
+    for (int i = 0; i < PEERS; i++) {
+        makeMac(mac, i);
+        CHECK(mgr.getJitterStats(mac, &stats));
+        CHECK(stats.played >= 1);
+    }
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Sender schneller als die Ausgabe: Alter bleibt begrenzt
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    const uint32_t sendPeriods[] = { 19600, 10000 };
+    for (int i = 0; i < 2; i++) {
+        makeMac(mac, PEERS + i);
+        CHECK(mgr.addPeer(mac));
+        mgr.setMotorSource(mac);
+        
+        uint32_t maxAge = driftRun(mgr, mac, sendPeriods[i]);
+        CHECK(mgr.getJitterStats(mac, &stats));
+        printf("Sender %lu µs bei 20 ms Ausgabe: max. Alter %lu µs, %lu übersprungen, %lu Überläufe\n",
+               (unsigned long)sendPeriods[i], (unsigned long)maxAge,
+               (unsigned long)stats.skipped, (unsigned long)stats.overflows);
+        CHECK(maxAge <= ESPNOW_JITTER_MAX_DELAY_MS * 1000UL);
+        CHECK(stats.skipped > 0);
+        CHECK_EQ(stats.overflows, 0);
+    }
+    
+    mgr.end();
+    return hostReport("test_jitter");
+}
@@ -0,0 +1,100 @@
+/**
+ * test_link_loss.cpp
+ *
+ * Verlustrate der Link-Statistik (getLinkQuality().lossRate)
+ * - Gleichmäßiger Verlust (jeder 10. Frame fehlt) → Mittel ≈ 10 %
+ * - Zufälliger Verlust 1 - 20 % → Mittel über den Lauf ≈ eingestellte Rate
+ * - Eine lange Lücke treibt die Rate gegen 1, Empfang senkt sie wieder
+ */
+
+#include <random>
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+#define FRAMES  4000
+
+static const uint8_t PEER_MAC[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x01 };
+
+static uint16_t nextSeq = 0;
+
+/**
+ * Frame mit Sequenznummer empfangen (wie vom Sender in transmitTx gebaut)
+ * @param drop true = Frame geht verloren, nur Sequenznummer verbraucht
+ */
+static void receive(EspNowManager& mgr, bool drop) {
+    uint16_t seq = nextSeq++;
+    if (drop) return;
+    
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE).addUInt16(DataCmd::SEQUENCE, seq).addByte(DataCmd::CUSTOM_1, 1);
+    EspNowManagerTest::handleRxFrame(mgr, PEER_MAC, packet.getRawData(), packet.getTotalLength());
+    
+    // Ergebnis-Queue leeren
+    ResultQueueItem result;
+    while (mgr.getData(&result)) {}
+    hostAdvanceUs(10000);
+}
+
+static float lossRate(EspNowManager& mgr) {
+    EspNowLinkQuality link;
+    if (!mgr.getLinkQuality(PEER_MAC, &link)) return -1.0f;
+    return link.lossRate;
+}
+
+/**
+ * Mittlere lossRate über FRAMES erwartete Frames
+ * Gemessen direkt nach einem Empfang, also nach dessen 0-Sample:
+ * Erwartungswert rate * (1 - ESPNOW_LINK_EWMA_ALPHA)
+ */
+static float meanLoss(EspNowManager& mgr, std::function<bool(int)> drop) {
+    double sum = 0;
+    int samples = 0;
+    for (int i = 0; i < FRAMES; i++) {
+        bool lost = drop(i);
+        receive(mgr, lost);
+        if (!lost && i >= FRAMES / 10) {
+            sum += lossRate(mgr);
+            samples++;
+        }
+    }
+    return samples ? static_cast<float>(sum / samples) : -1.0f;
+}
+
+static float expected(float rate) {
+    return rate * (1.0f - ESPNOW_LINK_EWMA_ALPHA);
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    CHECK(mgr.addPeer(PEER_MAC));
+    
+    // Gleichmäßig: 1 von 10 verloren (pro Frame gemittelt wären es ~5,5 %)
+    float even = meanLoss(mgr, [](int i) { return i % 10 == 9; });
+    printf("Jeder 10. verloren: lossRate %.3f\n", even);
+    CHECK(fabsf(even - expected(0.10f)) < 0.01f);
+    
+    // Zufällig, feste Saat
+    std::mt19937 rng(42);
+    const float rates[] = { 0.01f, 0.05f, 0.10f, 0.20f };
+    for (float rate : rates) {
+        std::bernoulli_distribution lose(rate);
+        float mean = meanLoss(mgr, [&](int) { return lose(rng); });
+        printf("Verlust %4.1f %%: lossRate %.3f\n", rate * 100.0f, mean);
+        CHECK(fabsf(mean - expected(rate)) < 0.01f + rate * 0.1f);
+    }
+    
+    // Lange Lücke: Rate nahe 1, danach fällt sie pro empfangenem Frame
+    for (int i = 0; i < 100; i++) receive(mgr, true);
+    receive(mgr, false);
+    float afterGap = lossRate(mgr);
+    CHECK(afterGap > 0.85f);
+    for (int i = 0; i < 60; i++) receive(mgr, false);
+    CHECK(lossRate(mgr) < 0.01f);
+    
+    mgr.end();
+    return hostReport("test_link_loss");
+}
@@ -0,0 +1,118 @@
+/**
+ * test_peer_slots.cpp
+ *
+ * Virtuelle Peers gegen den simulierten ESP-NOW-Treiber (20 Einträge inkl.
+ * Broadcast, davon 6 verschlüsselt, wie ESP_NOW_MAX_TOTAL_PEER_NUM /
+ * ESP_NOW_MAX_ENCRYPT_PEER_NUM)
+ * - Mehr logische Peers als Treiber-Slots (ESPNOW_MAX_PEERS 0 = unbegrenzt)
+ * - Jeder Send landet beim richtigen Peer, nie an einem nicht registrierten
+ * - Treiber-Tabelle läuft nie über, LRU-Swap zählt Verdrängungen
+ * - Pro-Peer-Zustand (Sequenznummer, Zähler) überlebt die Verdrängung
+ */
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+#define PLAIN_PEERS     24
+#define ENCRYPT_PEERS   8
+#define TOTAL_PEERS     (PLAIN_PEERS + ENCRYPT_PEERS)
+#define ROUNDS          3
+
+static void makeMac(uint8_t* mac, int i) {
+    const uint8_t base[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x00 };
+    memcpy(mac, base, 6);
+    mac[4] = static_cast<uint8_t>(i >> 8);
+    mac[5] = static_cast<uint8_t>(i);
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    CHECK_EQ(hostDriverStats().peers, 1);   // Broadcast
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Mehr Peers als Treiber-Slots anlegen
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    uint8_t mac[6];
+    for (int i = 0; i < TOTAL_PEERS; i++) {
+        makeMac(mac, i);
+        CHECK(mgr.addPeer(mac, i >= PLAIN_PEERS));
+    }
+    CHECK_EQ(mgr.getPeerCount(), TOTAL_PEERS);
+    CHECK_EQ(hostDriverStats().peers, HOST_ESPNOW_MAX_PEERS);
+    CHECK_EQ(hostDriverStats().rejectedFull, 0);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Jeden Peer mehrmals anschreiben (erzwingt LRU-Swaps)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    hostSentFrames().clear();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < TOTAL_PEERS; i++) {
+            makeMac(mac, i);
+            EspNowPacket packet;
+            packet.begin(MainCmd::DATA_RESPONSE).addUInt16(DataCmd::CUSTOM_1, static_cast<uint16_t>(i));
+            CHECK(mgr.send(mac, packet));
+            EspNowManagerTest::processTxQueue(mgr);
+            hostAdvanceUs(1000);
+        }
+    }
+    
+    const HostDriverStats& driver = hostDriverStats();
+    CHECK(driver.maxPeers <= HOST_ESPNOW_MAX_PEERS);
+    CHECK(driver.maxEncrypted <= HOST_ESPNOW_MAX_ENCRYPT);
+    CHECK_EQ(driver.rejectedFull, 0);
+    CHECK_EQ(driver.sendUnknown, 0);
+    
+    // Frames: richtiges Ziel, Sequenznummer pro Peer fortlaufend
+    CHECK_EQ(hostSentFrames().size(), TOTAL_PEERS * ROUNDS);
+    for (size_t n = 0; n < hostSentFrames().size(); n++) {
+        const HostFrame& frame = hostSentFrames()[n];
+        int expected = static_cast<int>(n % TOTAL_PEERS);
+        makeMac(mac, expected);
+        CHECK(memcmp(frame.mac, mac, 6) == 0);
+        
+        EspNowPacket packet;
+        uint16_t seq = 0, value = 0;
+        CHECK(packet.parse(frame.data.data(), frame.data.size()));
+        CHECK(packet.getUInt16(DataCmd::SEQUENCE, seq));
+        CHECK(packet.getUInt16(DataCmd::CUSTOM_1, value));
+        CHECK_EQ(seq, n / TOTAL_PEERS);
+        CHECK_EQ(value, expected);
+    }
+    
+    // Zuletzt benutzte Peers sind registriert, die ältesten virtuell
+    makeMac(mac, TOTAL_PEERS - 1);
+    CHECK(hostDriverHasPeer(mac));
+    makeMac(mac, 0);
+    CHECK(!hostDriverHasPeer(mac));
+    
+    EspNowSwapStats swap;
+    mgr.getSwapStats(&swap);
+    CHECK(swap.evictions > 0);
+    CHECK(swap.swapIns > 0);
+    CHECK_EQ(swap.failures, 0);
+    CHECK_EQ(swap.registeredPeers + 1, driver.peers);
+    CHECK_EQ(swap.registeredEncrypted, driver.encrypted);
+    
+    // Zustand verdrängter Peers bleibt erhalten
+    for (int i = 0; i < TOTAL_PEERS; i++) {
+        makeMac(mac, i);
+        EspNowPeer* peer = mgr.getPeer(mac);
+        CHECK(peer != nullptr);
+        if (!peer) continue;
+        CHECK_EQ(peer->txSeq, ROUNDS);
+        CHECK_EQ(peer->packetsSent, ROUNDS);
+        CHECK_EQ(peer->encrypt, i >= PLAIN_PEERS);
+    }
+    
+    printf("Peers: %d logisch, Treiber max %d (%d verschlüsselt), %lu Swaps, %lu Verdrängungen\n",
+           TOTAL_PEERS, driver.maxPeers, driver.maxEncrypted,
+           (unsigned long)swap.swapIns, (unsigned long)swap.evictions);
+    
+    mgr.end();
+    return hostReport("test_peer_slots");
+}
@@ -0,0 +1,97 @@
+/**
+ * test_subscriptions.cpp
+ *
+ * Abonnements pro DataCmd
+ * - Zustellung im Worker direkt nach dem Parsen
+ * - Handles mit Generation: ein veraltetes Handle trifft nach unsubscribe()
+ *   nicht den neuen Abonnenten im selben Slot
+ * - Neuvergabe des Slots aus dem eigenen Callback
+ */
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+static const uint8_t PEER_MAC[6] = { 0x24, 0x6F, 0x28, 0x00, 0x06, 0x01 };
+
+static int firstCalls = 0;
+static int secondCalls = 0;
+static int replacement = 0;
+
+static void receiveBattery(EspNowManager& mgr, uint16_t millivolts) {
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE).addUInt16(DataCmd::BATTERY_VOLTAGE, millivolts);
+    EspNowManagerTest::handleRxFrame(mgr, PEER_MAC, packet.getRawData(), packet.getTotalLength());
+    
+    ResultQueueItem result;
+    while (mgr.getData(&result)) {}
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    mgr.setHeartbeat(false);
+    CHECK(mgr.addPeer(PEER_MAC));
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Veraltetes Handle nach Neuvergabe des Slots
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    int first = mgr.subscribe(DataCmd::BATTERY_VOLTAGE, [](const uint8_t*, DataCmd, const uint8_t*, size_t) {
+        firstCalls++;
+    });
+    CHECK(first > 0);
+    receiveBattery(mgr, 3700);
+    CHECK_EQ(firstCalls, 1);
+    CHECK(mgr.unsubscribe(first));
+    
+    int second = mgr.subscribe(DataCmd::BATTERY_VOLTAGE, [](const uint8_t*, DataCmd, const uint8_t*, size_t) {
+        secondCalls++;
+    });
+    CHECK(second > 0);
+    CHECK((second & 0xFF) == (first & 0xFF));
+    CHECK(second != first);
+    
+    // Altes Handle greift nicht auf den neuen Abonnenten
+    EspNowSubscriptionStats stats;
+    CHECK(!mgr.unsubscribe(first));
+    CHECK(!mgr.resumeSubscription(first));
+    CHECK(!mgr.getSubscriptionStats(first, &stats));
+    
+    receiveBattery(mgr, 3650);
+    CHECK_EQ(firstCalls, 1);
+    CHECK_EQ(secondCalls, 1);
+    CHECK(mgr.getSubscriptionStats(second, &stats));
+    CHECK_EQ(stats.calls, 1);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Callback meldet sich ab und vergibt den Slot neu
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    static int current;
+    current = second;
+    CHECK(mgr.unsubscribe(second));
+    current = mgr.subscribe(DataCmd::BATTERY_VOLTAGE, [](const uint8_t*, DataCmd, const uint8_t*, size_t) {
+        EspNowManager& m = EspNowManager::getInstance();
+        m.unsubscribe(current);
+        replacement = m.subscribe(DataCmd::BATTERY_VOLTAGE, [](const uint8_t*, DataCmd, const uint8_t*, size_t) {
+            secondCalls++;
+        });
+    });
+    receiveBattery(mgr, 3600);
+    CHECK(replacement > 0);
+    CHECK(replacement != current);
+    
+    // Laufzeit des alten Callbacks landet nicht beim neuen Abonnenten
+    CHECK(mgr.getSubscriptionStats(replacement, &stats));
+    CHECK_EQ(stats.calls, 0);
+    receiveBattery(mgr, 3550);
+    CHECK_EQ(secondCalls, 2);
+    CHECK(mgr.getSubscriptionStats(replacement, &stats));
+    CHECK_EQ(stats.calls, 1);
+    CHECK_EQ(mgr.getSubscriptionsDropped(), 0);
+    
+    mgr.end();
+    return hostReport("test_subscriptions");
+}
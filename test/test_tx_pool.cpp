@@ -0,0 +1,166 @@
+/**
+ * test_tx_pool.cpp
+ *
+ * TX-Pool unter voller Last
+ * - BULK und TELEMETRY gedrosselt, Kontingent der Lane (ESPNOW_TX_LANE_BUFFERS) voll
+ * - CONTROL bekommt trotzdem sein volles Kontingent (kein "TX-Pool erschöpft")
+ * - Nach dem Senden sind alle Buffer wieder frei
+ * - send() an mehr Ziele als die Lane-Queue fasst: jedes Ziel bekommt genau
+ *   einen Frame und einen Sendestatus, der Buffer wird danach freigegeben
+ */
+
+#include "ESPNowManager.h"
+#include "host.h"
+#include "espnow_test.h"
+
+static const uint8_t BULK_MAC[6]      = { 0x24, 0x6F, 0x28, 0x00, 0x02, 0x01 };
+static const uint8_t TELEMETRY_MAC[6] = { 0x24, 0x6F, 0x28, 0x00, 0x02, 0x02 };
+static const uint8_t CONTROL_MAC[6]   = { 0x24, 0x6F, 0x28, 0x00, 0x02, 0x03 };
+
+#define FANOUT_COUNT    (2 * ESPNOW_TX_QUEUE_SIZE + 5)
+
+static int sendStatus[FANOUT_COUNT];
+
+/**
+ * Lane mit gedrosseltem Peer füllen, bis send() abgelehnt wird
+ * @return Anzahl angenommener Frames
+ */
+static int fillLane(EspNowManager& mgr, const uint8_t* mac, EspNowLane lane) {
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE).addByte(DataCmd::CUSTOM_1, 1);
+    
+    int accepted = 0;
+    for (int i = 0; i < 4 * ESPNOW_TX_LANE_BUFFERS; i++) {
+        if (mgr.send(mac, packet, lane)) accepted++;
+        EspNowManagerTest::processTxQueue(mgr);
+    }
+    return accepted;
+}
+
+/**
+ * Worker-Schritt, während send() auf Platz in der Lane-Queue wartet
+ */
+static void workerStep() {
+    EspNowManagerTest::processTxQueue(EspNowManager::getInstance());
+}
+
+static void fanoutMac(int i, uint8_t* mac) {
+    const uint8_t base[6] = { 0x24, 0x6F, 0x28, 0x00, 0x05, static_cast<uint8_t>(i) };
+    memcpy(mac, base, 6);
+}
+
+/**
+ * Ein Paket an FANOUT_COUNT Peers (mehr als ESPNOW_TX_QUEUE_SIZE)
+ */
+static void fanout(EspNowManager& mgr) {
+    std::vector<EspNowMac> macs(FANOUT_COUNT);
+    for (int i = 0; i < FANOUT_COUNT; i++) {
+        fanoutMac(i, macs[i].addr);
+        CHECK(mgr.addPeer(macs[i].addr));
+    }
+    
+    mgr.setSendCallback([](const uint8_t* mac, bool success) {
+        if (mac[4] == 0x05 && mac[5] < FANOUT_COUNT && success) sendStatus[mac[5]]++;
+    });
+    
+    EspNowPacket packet;
+    packet.begin(MainCmd::DATA_RESPONSE).addByte(DataCmd::CUSTOM_1, 7);
+    
+    hostSentFrames().clear();
+    hostSetDelayHook(workerStep);
+    int accepted = mgr.send(std::span<const EspNowMac>(macs), packet, EspNowLane::TELEMETRY);
+    hostSetDelayHook(nullptr);
+    EspNowManagerTest::processTxQueue(mgr);
+    CHECK_EQ(accepted, FANOUT_COUNT);
+    
+    // Genau ein Frame pro Ziel, Sendestatus pro Ziel über den Callback
+    int frames[FANOUT_COUNT] = {};
+    for (const HostFrame& frame : hostSentFrames()) {
+        if (frame.mac[4] == 0x05 && frame.mac[5] < FANOUT_COUNT) frames[frame.mac[5]]++;
+    }
+    for (const HostFrame& frame : hostSentFrames()) {
+        hostSendStatus(frame.mac, true);
+    }
+    int complete = 0;
+    for (int i = 0; i < FANOUT_COUNT; i++) {
+        CHECK_EQ(frames[i], 1);
+        if (sendStatus[i] == 1) complete++;
+    }
+    printf("Fan-out: %d Ziele, %d angenommen, %d abgeschlossen\n", FANOUT_COUNT, accepted, complete);
+    CHECK_EQ(complete, FANOUT_COUNT);
+    mgr.setSendCallback(nullptr);
+    
+    // Letzte Referenz gibt den Buffer frei
+    int inUse;
+    uint32_t exhausted;
+    mgr.getTxPoolStats(&inUse, &exhausted);
+    CHECK_EQ(inUse, 0);
+    CHECK_EQ(exhausted, 0);
+}
+
+int main() {
+    EspNowManager& mgr = EspNowManager::getInstance();
+    hostDriverReset();
+    CHECK(mgr.begin());
+    mgr.setHeartbeat(false);
+    CHECK(mgr.addPeer(BULK_MAC));
+    CHECK(mgr.addPeer(TELEMETRY_MAC));
+    CHECK(mgr.addPeer(CONTROL_MAC));
+    
+    // Ein Token pro Sekunde, Uhr steht → nach dem ersten Frame gedrosselt
+    mgr.setLaneRate(EspNowLane::BULK, 1, 1);
+    mgr.setLaneRate(EspNowLane::TELEMETRY, 1, 1);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // BULK und TELEMETRY bis zum Anschlag füllen
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    const int perLane = ESPNOW_TX_LANE_BUFFERS;
+    CHECK_EQ(fillLane(mgr, BULK_MAC, EspNowLane::BULK), 1 + perLane);
+    CHECK_EQ(fillLane(mgr, TELEMETRY_MAC, EspNowLane::TELEMETRY), 1 + perLane);
+    
+    int inUse;
+    uint32_t exhausted;
+    mgr.getTxPoolStats(&inUse, &exhausted);
+    CHECK_EQ(inUse, 2 * perLane);
+    CHECK_EQ(exhausted, 0);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // CONTROL: volles Kontingent ohne Worker-Durchlauf muss Buffer bekommen
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    EspNowPacket control;
+    control.begin(MainCmd::DATA_REQUEST).addByte(DataCmd::MODE, 2);
+    for (int i = 0; i < ESPNOW_TX_LANE_BUFFERS; i++) {
+        CHECK(mgr.send(CONTROL_MAC, control, EspNowLane::CONTROL));
+    }
+    mgr.getTxPoolStats(&inUse, &exhausted);
+    printf("TX-Pool: %d / %d belegt, %lu erschöpft\n", inUse, ESPNOW_TX_POOL_SIZE, (unsigned long)exhausted);
+    CHECK_EQ(inUse, 3 * perLane);
+    CHECK_EQ(exhausted, 0);
+    
+    hostSentFrames().clear();
+    EspNowManagerTest::processTxQueue(mgr);
+    int controlFrames = 0;
+    for (const HostFrame& frame : hostSentFrames()) {
+        if (memcmp(frame.mac, CONTROL_MAC, 6) == 0) controlFrames++;
+    }
+    CHECK_EQ(controlFrames, ESPNOW_TX_LANE_BUFFERS);
+    
+    // Drosselung aufheben → alles raus, Pool leer
+    mgr.setLaneRate(EspNowLane::BULK, 0, 0);
+    mgr.setLaneRate(EspNowLane::TELEMETRY, 0, 0);
+    EspNowManagerTest::processTxQueue(mgr);
+    mgr.getTxPoolStats(&inUse, &exhausted);
+    CHECK_EQ(inUse, 0);
+    CHECK_EQ(exhausted, 0);
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Fan-out größer als die Lane-Queue
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    fanout(mgr);
+    
+    mgr.end();
+    return hostReport("test_tx_pool");
+}
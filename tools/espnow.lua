@@ -0,0 +1,274 @@
+--[[
+  espnow.lua
+
+  Wireshark-Dissector für ESP-NOW-Mitschnitte des PacketCapture (pcap)
+
+  Link-Type USER0 (147), pro Frame:
+    PcapEspNowHeader (10 Bytes): [VERSION 1B] [DIRECTION 1B] [INFO 1B] [RESERVED 1B] [MAC 6B]
+    ESP-NOW-Frame:               [MAIN_CMD 1B] [TOTAL_LEN 1B] { [SUB_CMD 1B] [LEN 1B] [DATA] } ...
+
+  Installation:
+    Datei in den persönlichen Plugin-Ordner kopieren
+    (Hilfe → Über Wireshark → Ordner → Persönliche Lua-Plugins)
+    oder: wireshark -X lua_script:espnow.lua capture.pcap
+
+  Filter-Beispiele:
+    espnow.dir == 0                     Nur Empfang
+    espnow.main_cmd == 0x09             Not-Aus
+    espnow.sub_cmd == 0x61              Frames mit Sequenznummer
+    espnow.seq                          Sequenznummern als Spalte
+
+  Tabellen entsprechen MainCmd/DataCmd in ESPNowManager.h,
+  Pseudo-Header PcapEspNowHeader in PacketCapture.h.
+]]
+
+local espnow = Proto("espnow", "ESP-NOW (PacketCapture)")
+
+-- ═══════════════════════════════════════════════════════════════════════════
+-- TABELLEN
+-- ═══════════════════════════════════════════════════════════════════════════
+
+local directions = {
+    [0] = "RX",
+    [1] = "TX",
+    [2] = "TX-Status"
+}
+
+local main_cmds = {
+    [0x00] = "NONE",
+    [0x01] = "HEARTBEAT",
+    [0x02] = "ACK",
+    [0x03] = "DATA_REQUEST",
+    [0x04] = "DATA_RESPONSE",
+    [0x05] = "PAIR_REQUEST",
+    [0x06] = "PAIR_RESPONSE",
+    [0x07] = "ERROR",
+    [0x08] = "FEC_PARITY",
+    [0x09] = "EMERGENCY_STOP",
+    [0x0A] = "STATE_DELTA",
+    [0x0B] = "STATE_KEYFRAME"
+}
+
+local data_cmds = {
+    [0x00] = "NONE",
+    [0x01] = "JOYSTICK_X",
+    [0x02] = "JOYSTICK_Y",
+    [0x03] = "JOYSTICK_BTN",
+    [0x04] = "JOYSTICK_ALL",
+    [0x10] = "BUTTON_STATE",
+    [0x11] = "SWITCH_STATE",
+    [0x12] = "POTENTIOMETER",
+    [0x20] = "MOTOR_LEFT",
+    [0x21] = "MOTOR_RIGHT",
+    [0x22] = "MOTOR_ALL",
+    [0x23] = "SPEED",
+    [0x30] = "BATTERY_VOLTAGE",
+    [0x31] = "BATTERY_PERCENT",
+    [0x32] = "TEMPERATURE",
+    [0x33] = "RSSI",
+    [0x40] = "CONNECTION",
+    [0x41] = "ERROR_CODE",
+    [0x42] = "MODE",
+    [0x50] = "DISTANCE",
+    [0x51] = "ACCELERATION",
+    [0x52] = "GYROSCOPE",
+    [0x53] = "ACCEL_BATCH",
+    [0x54] = "GYRO_BATCH",
+    [0x60] = "GROUP_ID",
+    [0x61] = "SEQUENCE",
+    [0x62] = "FEC_INFO",
+    [0x63] = "FEC_DATA",
+    [0x64] = "PACKED",
+    [0x65] = "STOP_ID",
+    [0xA0] = "CUSTOM_1",
+    [0xA1] = "CUSTOM_2",
+    [0xA2] = "CUSTOM_3",
+    [0xFF] = "RAW_DATA"
+}
+
+-- Feste Werte: DataCmd → Liste von (Name, Typ) in Reihenfolge (little-endian)
+local layouts = {
+    [0x01] = { { "x", "int16" } },
+    [0x02] = { { "y", "int16" } },
+    [0x03] = { { "btn", "uint8" } },
+    [0x04] = { { "x", "int16" }, { "y", "int16" }, { "btn", "uint8" } },
+    [0x10] = { { "mask", "hex8" } },
+    [0x11] = { { "mask", "hex8" } },
+    [0x12] = { { "value", "uint16" } },
+    [0x20] = { { "left", "int16" } },
+    [0x21] = { { "right", "int16" } },
+    [0x22] = { { "left", "int16" }, { "right", "int16" } },
+    [0x23] = { { "percent", "uint8" } },
+    [0x30] = { { "mV", "uint16" } },
+    [0x31] = { { "percent", "uint8" } },
+    [0x32] = { { "deci_C", "int16" } },
+    [0x33] = { { "dBm", "int8" } },
+    [0x40] = { { "connected", "uint8" } },
+    [0x41] = { { "code", "uint8" } },
+    [0x42] = { { "mode", "uint8" } },
+    [0x50] = { { "mm", "uint16" } },
+    [0x51] = { { "x", "int16" }, { "y", "int16" }, { "z", "int16" } },
+    [0x52] = { { "x", "int16" }, { "y", "int16" }, { "z", "int16" } },
+    [0x60] = { { "group", "uint8" } },
+    [0x62] = { { "group", "uint8" }, { "index", "uint8" }, { "k", "uint8" }, { "len_xor", "hex8" } },
+    [0x65] = { { "stop_id", "uint16" } }
+}
+
+local type_sizes = { uint8 = 1, int8 = 1, hex8 = 1, uint16 = 2, int16 = 2 }
+
+-- ═══════════════════════════════════════════════════════════════════════════
+-- FELDER
+-- ═══════════════════════════════════════════════════════════════════════════
+
+local f = espnow.fields
+f.version   = ProtoField.uint8("espnow.version", "Header-Version", base.DEC)
+f.dir       = ProtoField.uint8("espnow.dir", "Richtung", base.DEC, directions)
+f.rssi      = ProtoField.int8("espnow.rssi", "RSSI (dBm)", base.DEC)
+f.status    = ProtoField.int8("espnow.status", "Status", base.DEC)
+f.mac       = ProtoField.ether("espnow.mac", "Peer-MAC")
+f.main_cmd  = ProtoField.uint8("espnow.main_cmd", "MainCmd", base.HEX, main_cmds)
+f.total_len = ProtoField.uint8("espnow.total_len", "Gesamtlänge", base.DEC)
+f.entry     = ProtoField.bytes("espnow.entry", "Eintrag")
+f.sub_cmd   = ProtoField.uint8("espnow.sub_cmd", "DataCmd", base.HEX, data_cmds)
+f.sub_len   = ProtoField.uint8("espnow.sub_len", "Länge", base.DEC)
+f.value     = ProtoField.bytes("espnow.value", "Daten")
+f.seq       = ProtoField.uint16("espnow.seq", "Sequenz", base.DEC)
+
+local ef_truncated = ProtoExpert.new("espnow.truncated", "Eintrag abgeschnitten",
+                                     expert.group.MALFORMED, expert.severity.ERROR)
+local ef_length = ProtoExpert.new("espnow.bad_len", "TOTAL_LEN größer als Frame",
+                                  expert.group.MALFORMED, expert.severity.ERROR)
+espnow.experts = { ef_truncated, ef_length }
+
+-- ═══════════════════════════════════════════════════════════════════════════
+-- DISSECTOR
+-- ═══════════════════════════════════════════════════════════════════════════
+
+local function cmd_name(names, value)
+    return names[value] or (names == main_cmds and value >= 0x10 and string.format("USER_0x%02X", value))
+        or string.format("0x%02X", value)
+end
+
+-- Feste Werte eines Eintrags als Text, nil wenn Länge nicht passt
+local function format_values(sub_cmd, value)
+    local layout = layouts[sub_cmd]
+    if not layout then return nil end
+
+    local size = 0
+    for _, field in ipairs(layout) do size = size + type_sizes[field[2]] end
+    if value:len() ~= size then return nil end
+
+    local parts = {}
+    local pos = 0
+    for _, field in ipairs(layout) do
+        local name, kind = field[1], field[2]
+        local text
+        if kind == "uint8" then
+            text = tostring(value:range(pos, 1):uint())
+        elseif kind == "int8" then
+            text = tostring(value:range(pos, 1):int())
+        elseif kind == "hex8" then
+            text = string.format("0x%02X", value:range(pos, 1):uint())
+        elseif kind == "uint16" then
+            text = tostring(value:range(pos, 2):le_uint())
+        elseif kind == "int16" then
+            text = tostring(value:range(pos, 2):le_int())
+        end
+        parts[#parts + 1] = name .. "=" .. text
+        pos = pos + type_sizes[kind]
+    end
+    return table.concat(parts, " ")
+end
+
+function espnow.dissector(tvb, pinfo, tree)
+    if tvb:len() < 10 then return 0 end
+
+    pinfo.cols.protocol = "ESP-NOW"
+    local root = tree:add(espnow, tvb(), "ESP-NOW")
+
+    -- Pseudo-Header
+    local direction = tvb(1, 1):uint()
+    root:add(f.version, tvb(0, 1))
+    root:add(f.dir, tvb(1, 1))
+    if direction == 0 then
+        root:add(f.rssi, tvb(2, 1))
+    else
+        root:add(f.status, tvb(2, 1))
+    end
+    root:add(f.mac, tvb(4, 6))
+
+    local mac = tostring(tvb(4, 6):ether())
+    if direction == 0 then
+        pinfo.cols.src = mac
+        pinfo.cols.dst = "local"
+    else
+        pinfo.cols.src = "local"
+        pinfo.cols.dst = mac
+    end
+
+    if direction == 2 then
+        pinfo.cols.info = string.format("TX-Status %s", tvb(2, 1):int() ~= 0 and "OK" or "FEHLER")
+        return tvb:len()
+    end
+
+    -- ESP-NOW-Frame
+    if tvb:len() < 12 then return tvb:len() end
+    local frame = tvb(10):tvb()
+
+    local main_cmd = frame(0, 1):uint()
+    local total_len = frame(1, 1):uint()
+    local tlv = root:add(frame(), string.format("%s, %d Bytes Nutzdaten",
+                                                cmd_name(main_cmds, main_cmd), total_len))
+    tlv:add(f.main_cmd, frame(0, 1))
+    local len_item = tlv:add(f.total_len, frame(1, 1))
+    if total_len > frame:len() - 2 then
+        len_item:add_proto_expert_info(ef_length)
+        total_len = frame:len() - 2
+    end
+
+    local info = { string.format("%-3s %s", directions[direction] or "?", cmd_name(main_cmds, main_cmd)) }
+    local pos = 2
+    local stop = 2 + total_len
+    while pos + 2 <= stop do
+        local sub_cmd = frame(pos, 1):uint()
+        local sub_len = frame(pos + 1, 1):uint()
+        local name = cmd_name(data_cmds, sub_cmd)
+
+        if pos + 2 + sub_len > stop then
+            local item = tlv:add(f.entry, frame(pos, stop - pos))
+            item:set_text(name .. " (abgeschnitten)")
+            item:add_proto_expert_info(ef_truncated)
+            break
+        end
+
+        local entry = tlv:add(f.entry, frame(pos, 2 + sub_len))
+        entry:add(f.sub_cmd, frame(pos, 1))
+        entry:add(f.sub_len, frame(pos + 1, 1))
+
+        local text = name
+        if sub_len > 0 then
+            local value = frame(pos + 2, sub_len)
+            entry:add(f.value, value)
+            if sub_cmd == 0x61 and sub_len == 2 then
+                entry:add_le(f.seq, value)
+            end
+
+            local values = format_values(sub_cmd, value)
+            if values then
+                text = name .. ": " .. values
+            else
+                text = string.format("%s: %d Bytes", name, sub_len)
+            end
+        end
+        entry:set_text(text)
+        info[#info + 1] = text
+
+        pos = pos + 2 + sub_len
+    end
+
+    pinfo.cols.info = table.concat(info, ", ")
+    return tvb:len()
+end
+
+-- pcap Link-Type 147 (DLT_USER0)
+DissectorTable.get("wtap_encap"):add(wtap.USER0, espnow)
@@ -0,0 +1,592 @@
+/**
+ * logdecode.cpp
+ *
+ * Decoder für Log-Dateien des LogManagers
+ * - Ringdateien (CircularLog, Text oder Binär) in zeitlicher Reihenfolge,
+ *   LZ-komprimierte Blöcke werden entpackt (LogCompress.h)
+ * - Einfache Binärdateien (LogBinFileHeader)
+ * - Flight-Recorder-Dumps (FlightDumpHeader): ein Vorgang pro Zeile mit
+ *   µs-Zeitstempel, Art, MAC, RSSI/Status und Nutzdaten als Hex
+ *
+ * Build (Linux):
+ *   g++ -std=c++17 -O2 -I.. -o logdecode logdecode.cpp
+ *
+ * Aufruf:
+ *   logdecode [--csv] [--from MS] [--to MS] [--type NAME]... DATEI...
+ *
+ *   --csv        CSV statt Textzeilen (Spalten: timestamp_ms,type,Felder...)
+ *   --from MS    Nur Records mit timestamp >= MS
+ *   --to MS      Nur Records mit timestamp <= MS
+ *   --type NAME  Nur diesen Typ (Name aus logBinTypeName oder Nummer, mehrfach möglich)
+ *
+ * Bei Text-Ringdateien werden die Zeilen unverändert ausgegeben (nur Zeitfilter).
+ * Bei Flight-Dumps gilt nur der Zeitfilter (ms seit Boot), --csv/--type werden ignoriert.
+ *
+ * Textausgabe entspricht dem Text-Log der Firmware, vorhandene grep-Muster
+ * funktionieren weiter. Records sind little-endian (wie ESP32 und x86/ARM-Hosts).
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "LogSchema.h"
+#include "LogCompress.h"
+
+/**
+ * Filter aus der Kommandozeile
+ */
+struct Filter {
+    uint32_t fromMs = 0;
+    uint32_t toMs = UINT32_MAX;
+    bool types[256] = {};
+    bool anyType = true;
+};
+
+/**
+ * Zeiger auf die Text-Felder eines Records
+ */
+struct Texts {
+    const char* field[3] = { "", "", "" };
+};
+
+static void splitTexts(const uint8_t* data, size_t len, uint8_t count, Texts* out) {
+    size_t pos = 0;
+    for (uint8_t i = 0; i < count && i < 3 && pos < len; i++) {
+        out->field[i] = (const char*)&data[pos];
+        while (pos < len && data[pos] != '\0') pos++;
+        pos++;
+    }
+}
+
+static void macToString(const uint8_t* mac, char* out) {
+    snprintf(out, 18, "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+/**
+ * CSV-Feld mit Quoting ausgeben
+ */
+static void csvText(const char* text) {
+    putchar(',');
+    if (!strpbrk(text, ",\"\n")) {
+        fputs(text, stdout);
+        return;
+    }
+    putchar('"');
+    for (const char* c = text; *c; c++) {
+        if (*c == '"') putchar('"');
+        putchar(*c);
+    }
+    putchar('"');
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// AUSGABE PRO TYP
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void printText(uint8_t type, uint32_t ts, const uint8_t* payload, size_t len) {
+    Texts t;
+    uint8_t fixed = logBinFixedSize(type);
+    splitTexts(payload + fixed, len - fixed, logBinTextFields(type), &t);
+    char mac[18];
+    
+    printf("[%ums] ", ts);
+    
+    switch (type) {
+        case LOG_BIN_BOOT_START: {
+            LogBinBootStart r;
+            memcpy(&r, payload, sizeof(r));
+            printf("INFO - Boot Start | Reason: %s | Version: %s | Free Heap: %u bytes | Chip: %s | CPU: %u MHz\n",
+                   t.field[0], t.field[1], r.freeHeap, t.field[2], r.cpuMhz);
+            break;
+        }
+        case LOG_BIN_SETUP_STEP: {
+            LogBinSetupStep r;
+            memcpy(&r, payload, sizeof(r));
+            printf("%s - Setup: %s %s", r.success ? "INFO" : "ERROR", t.field[0],
+                   r.success ? "[OK]" : "[FAILED]");
+            if (t.field[1][0]) printf(" | %s", t.field[1]);
+            putchar('\n');
+            break;
+        }
+        case LOG_BIN_BOOT_COMPLETE: {
+            LogBinBootComplete r;
+            memcpy(&r, payload, sizeof(r));
+            printf("%s - Boot Complete | Time: %ums | Free Heap: %u bytes %s\n",
+                   r.success ? "INFO" : "ERROR", r.totalTimeMs, r.freeHeap,
+                   r.success ? "[SUCCESS]" : "[FAILED]");
+            break;
+        }
+        case LOG_BIN_BATTERY: {
+            LogBinBattery r;
+            memcpy(&r, payload, sizeof(r));
+            bool critical = r.flags & LOG_BIN_FLAG_CRITICAL;
+            bool low = r.flags & LOG_BIN_FLAG_LOW;
+            printf("%s - Battery | Voltage: %.2fV | Percent: %u%%%s\n",
+                   critical ? "CRITICAL" : (low ? "WARN" : "INFO"), r.voltageMv / 1000.0, r.percent,
+                   critical ? " [CRITICAL]" : (low ? " [LOW]" : ""));
+            break;
+        }
+        case LOG_BIN_CONNECTION: {
+            LogBinConnection r;
+            memcpy(&r, payload, sizeof(r));
+            macToString(r.mac, mac);
+            printf("INFO - ESP-NOW: %s | Peer: %s", t.field[0], mac);
+            if (r.rssi != 0) printf(" | RSSI: %d dBm", r.rssi);
+            putchar('\n');
+            break;
+        }
+        case LOG_BIN_CONNECTION_STATS: {
+            LogBinConnectionStats r;
+            memcpy(&r, payload, sizeof(r));
+            macToString(r.mac, mac);
+            printf("INFO - ESP-NOW Stats | Peer: %s | Sent: %u | Received: %u | Lost: %u",
+                   mac, r.sent, r.received, r.lost);
+            if (r.sent > 0) printf(" | Loss: %.1f%%", r.lost * 100.0 / r.sent);
+            printf(" | Avg RSSI: %d dBm\n", r.avgRssi);
+            break;
+        }
+        case LOG_BIN_ERROR: {
+            LogBinError r;
+            memcpy(&r, payload, sizeof(r));
+            printf("ERROR - %s | Code: %d | %s | Free Heap: %u bytes\n",
+                   t.field[0], r.code, t.field[1], r.freeHeap);
+            break;
+        }
+        case LOG_BIN_CRASH: {
+            LogBinCrash r;
+            memcpy(&r, payload, sizeof(r));
+            printf("FATAL - CRASH | PC: 0x%x | ExcVAddr: 0x%x | ExcCause: %u | Free Heap: %u bytes\n",
+                   r.pc, r.excvaddr, r.exccause, r.freeHeap);
+            break;
+        }
+    }
+}
+
+static void printCsv(uint8_t type, uint32_t ts, const uint8_t* payload, size_t len) {
+    Texts t;
+    uint8_t fixed = logBinFixedSize(type);
+    splitTexts(payload + fixed, len - fixed, logBinTextFields(type), &t);
+    char mac[18];
+    
+    const char* name = logBinTypeName(type);
+    printf("%u,%s", ts, name ? name : "?");
+    
+    switch (type) {
+        case LOG_BIN_BOOT_START: {
+            LogBinBootStart r;
+            memcpy(&r, payload, sizeof(r));
+            csvText(t.field[0]);
+            csvText(t.field[1]);
+            printf(",%u", r.freeHeap);
+            csvText(t.field[2]);
+            printf(",%u", r.cpuMhz);
+            break;
+        }
+        case LOG_BIN_SETUP_STEP: {
+            LogBinSetupStep r;
+            memcpy(&r, payload, sizeof(r));
+            csvText(t.field[0]);
+            printf(",%u", r.success);
+            csvText(t.field[1]);
+            break;
+        }
+        case LOG_BIN_BOOT_COMPLETE: {
+            LogBinBootComplete r;
+            memcpy(&r, payload, sizeof(r));
+            printf(",%u,%u,%u", r.totalTimeMs, r.freeHeap, r.success);
+            break;
+        }
+        case LOG_BIN_BATTERY: {
+            LogBinBattery r;
+            memcpy(&r, payload, sizeof(r));
+            printf(",%.3f,%u,%u,%u", r.voltageMv / 1000.0, r.percent,
+                   (r.flags & LOG_BIN_FLAG_LOW) ? 1 : 0, (r.flags & LOG_BIN_FLAG_CRITICAL) ? 1 : 0);
+            break;
+        }
+        case LOG_BIN_CONNECTION: {
+            LogBinConnection r;
+            memcpy(&r, payload, sizeof(r));
+            macToString(r.mac, mac);
+            printf(",%s", mac);
+            csvText(t.field[0]);
+            printf(",%d", r.rssi);
+            break;
+        }
+        case LOG_BIN_CONNECTION_STATS: {
+            LogBinConnectionStats r;
+            memcpy(&r, payload, sizeof(r));
+            macToString(r.mac, mac);
+            printf(",%s,%u,%u,%u,%d", mac, r.sent, r.received, r.lost, r.avgRssi);
+            break;
+        }
+        case LOG_BIN_ERROR: {
+            LogBinError r;
+            memcpy(&r, payload, sizeof(r));
+            csvText(t.field[0]);
+            printf(",%d", r.code);
+            csvText(t.field[1]);
+            printf(",%u", r.freeHeap);
+            break;
+        }
+        case LOG_BIN_CRASH: {
+            LogBinCrash r;
+            memcpy(&r, payload, sizeof(r));
+            printf(",0x%x,0x%x,%u,%u", r.pc, r.excvaddr, r.exccause, r.freeHeap);
+            break;
+        }
+    }
+    putchar('\n');
+}
+
+/**
+ * CSV-Kopfzeile (nur wenn genau ein Typ gefiltert ist, sonst variieren die Spalten)
+ */
+static void printCsvHeader(uint8_t type) {
+    static const char* columns[LOG_BIN_TYPE_COUNT] = {
+        nullptr,
+        "reason,version,free_heap,chip,cpu_mhz",
+        "module,success,message",
+        "total_ms,free_heap,success",
+        "voltage,percent,low,critical",
+        "peer,event,rssi",
+        "peer,sent,received,lost,avg_rssi",
+        "module,code,message,free_heap",
+        "pc,excvaddr,exccause,free_heap",
+    };
+    printf("timestamp_ms,type,%s\n", columns[type]);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATEI LESEN
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Binäre Records eines Datenstroms ausgeben
+ * @return Anzahl ausgegebener Records
+ */
+static long decodeRecords(const char* path, const uint8_t* data, size_t size,
+                          const Filter& filter, bool csv) {
+    long printed = 0;
+    size_t pos = 0;
+    while (pos + sizeof(LogBinHeader) <= size) {
+        LogBinHeader h;
+        memcpy(&h, &data[pos], sizeof(h));
+        pos += sizeof(h);
+        
+        if (pos + h.length > size) {
+            fprintf(stderr, "logdecode: %s: Record bei Offset %zu abgeschnitten\n",
+                    path, pos - sizeof(h));
+            break;
+        }
+        const uint8_t* payload = &data[pos];
+        pos += h.length;
+        
+        // Unbekannte oder zu kurze Records überspringen (neuere Firmware)
+        if (!logBinTypeName(h.type) || h.length < logBinFixedSize(h.type)) continue;
+        
+        if (h.timestampMs < filter.fromMs || h.timestampMs > filter.toMs) continue;
+        if (!filter.anyType && !filter.types[h.type]) continue;
+        
+        if (csv) {
+            printCsv(h.type, h.timestampMs, payload, h.length);
+        } else {
+            printText(h.type, h.timestampMs, payload, h.length);
+        }
+        printed++;
+    }
+    return printed;
+}
+
+/**
+ * Textzeilen ausgeben (Zeitfilter über das Präfix "[12345ms]")
+ * @return Anzahl ausgegebener Zeilen
+ */
+static long decodeLines(const uint8_t* data, size_t size, const Filter& filter) {
+    long printed = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        const uint8_t* end = (const uint8_t*)memchr(&data[pos], '\n', size - pos);
+        size_t len = end ? (size_t)(end - &data[pos]) + 1 : size - pos;
+        
+        unsigned long ts = 0;
+        bool hasTime = data[pos] == '[' && sscanf((const char*)&data[pos], "[%lums]", &ts) == 1;
+        if (!hasTime || (ts >= filter.fromMs && ts <= filter.toMs)) {
+            fwrite(&data[pos], 1, len, stdout);
+            printed++;
+        }
+        pos += len;
+    }
+    return printed;
+}
+
+/**
+ * Ringdatei (CircularLog) auspacken: gültige Blöcke nach Sequenz verketten
+ * @param format Ausgabe: LOG_RING_FORMAT_*
+ * @return false bei ungültigem Kopf
+ */
+static bool unwrapRing(const char* path, const std::vector<uint8_t>& data,
+                       std::vector<uint8_t>* stream, uint8_t* format) {
+    LogRingHeader rh;
+    if (data.size() < LOG_RING_BLOCK_SIZE) return false;
+    memcpy(&rh, data.data(), sizeof(rh));
+    
+    if (rh.version != LOG_RING_VERSION || rh.blockSize != LOG_RING_BLOCK_SIZE) {
+        fprintf(stderr, "logdecode: %s: Ringdatei-Version %u nicht unterstützt\n", path, rh.version);
+        return false;
+    }
+    if (rh.format == LOG_RING_FORMAT_BINARY && rh.schemaVersion != LOG_BIN_VERSION) {
+        fprintf(stderr, "logdecode: %s: Schema-Version %u (erwartet %u)\n",
+                path, rh.schemaVersion, LOG_BIN_VERSION);
+        return false;
+    }
+    
+    // Head im Kopf kann nachlaufen → Blöcke selbst nach Sequenz ordnen
+    // (nur genullte Blöcke, dahinter liegen beim ersten Umlauf alte Karteninhalte)
+    uint32_t initBlocks = rh.initBlocks == 0 || rh.initBlocks > rh.blockCount ? rh.blockCount : rh.initBlocks;
+    std::vector<std::pair<uint32_t, size_t>> blocks;
+    for (uint32_t i = 0; i < initBlocks; i++) {
+        size_t offset = (size_t)(i + 1) * LOG_RING_BLOCK_SIZE;
+        if (offset + LOG_RING_BLOCK_SIZE > data.size()) break;
+        
+        LogRingBlockHeader bh;
+        memcpy(&bh, &data[offset], sizeof(bh));
+        if (bh.seq == 0 || bh.seq < rh.tailSeq) continue;
+        if (bh.used > LOG_RING_BLOCK_SIZE - sizeof(bh)) continue;
+        blocks.push_back({ (uint32_t)bh.seq, offset });
+    }
+    std::sort(blocks.begin(), blocks.end());
+    
+    uint8_t unpacked[LOG_LZ_WINDOW];
+    for (const auto& block : blocks) {
+        LogRingBlockHeader bh;
+        memcpy(&bh, &data[block.second], sizeof(bh));
+        const uint8_t* payload = &data[block.second + sizeof(bh)];
+        
+        if (bh.rawLen == 0) {
+            stream->insert(stream->end(), payload, payload + bh.used);
+            continue;
+        }
+        
+        // Komprimierter Block (für sich dekodierbar)
+        int n = logLzDecompress(payload, bh.used, unpacked, sizeof(unpacked));
+        if (n != bh.rawLen) {
+            fprintf(stderr, "logdecode: %s: Block %u nicht dekomprimierbar, übersprungen\n",
+                    path, (uint32_t)bh.seq);
+            continue;
+        }
+        stream->insert(stream->end(), unpacked, unpacked + n);
+    }
+    *format = rh.format;
+    return true;
+}
+
+// Namen der EspNowEvents (Reihenfolge wie enum class EspNowEvent)
+static const char* const FLIGHT_EVENT_NAMES[] = {
+    "NONE", "DATA_RECEIVED", "DATA_SENT", "PEER_CONNECTED", "PEER_DISCONNECTED",
+    "PEER_ADDED", "PEER_REMOVED", "SEND_SUCCESS", "SEND_FAILED",
+    "HEARTBEAT_RECEIVED", "HEARTBEAT_TIMEOUT", "STATE_UPDATED", "EMERGENCY_STOP"
+};
+
+/**
+ * Flight-Recorder-Dump ausgeben
+ * @return Anzahl ausgegebener Einträge, -1 bei Fehler
+ */
+static long decodeFlight(const char* path, const std::vector<uint8_t>& data, const Filter& filter) {
+    static const char* const kinds[] = { "RX", "TX", "TX-STATUS", "EVENT" };
+    
+    FlightDumpHeader fh;
+    if (data.size() < sizeof(fh)) return -1;
+    memcpy(&fh, data.data(), sizeof(fh));
+    if (fh.version != FLIGHT_DUMP_VERSION) {
+        fprintf(stderr, "logdecode: %s: Dump-Version %u nicht unterstützt\n", path, fh.version);
+        return -1;
+    }
+    printf("# Flight-Dump %u: Auslöser %s bei %lld us, %u Einträge, %u überschrieben\n",
+           fh.dumpId, flightTriggerName(fh.trigger), (long long)fh.triggerUs, fh.records, fh.lost);
+    
+    long printed = 0;
+    size_t pos = sizeof(fh);
+    while (pos + sizeof(FlightRecordHeader) <= data.size()) {
+        FlightRecordHeader rh;
+        memcpy(&rh, &data[pos], sizeof(rh));
+        pos += sizeof(rh);
+        if (pos + rh.len > data.size()) {
+            fprintf(stderr, "logdecode: %s: Eintrag bei Offset %zu abgeschnitten\n",
+                    path, pos - sizeof(rh));
+            break;
+        }
+        const uint8_t* payload = &data[pos];
+        pos += rh.len;
+        
+        uint64_t ms = (uint64_t)rh.timeUs / 1000;
+        if (ms < filter.fromMs || ms > filter.toMs) continue;
+        
+        char mac[18];
+        macToString(rh.mac, mac);
+        const char* kind = rh.kind <= FLIGHT_KIND_EVENT ? kinds[rh.kind] : "?";
+        printf("[%lld.%03lldms] %-9s %s", (long long)(rh.timeUs / 1000),
+               (long long)(rh.timeUs % 1000), kind, mac);
+        
+        switch (rh.kind) {
+            case FLIGHT_KIND_RX:
+                printf(" rssi=%d", rh.info);
+                break;
+            case FLIGHT_KIND_TX:
+                printf(" %s", rh.info == 0 ? "queued" : "driver-error");
+                break;
+            case FLIGHT_KIND_TX_STATUS:
+                printf(" %s", rh.info ? "ok" : "fail");
+                break;
+            case FLIGHT_KIND_EVENT:
+                if (rh.len >= 1 && payload[0] < sizeof(FLIGHT_EVENT_NAMES) / sizeof(FLIGHT_EVENT_NAMES[0])) {
+                    printf(" %s%s", FLIGHT_EVENT_NAMES[payload[0]], rh.info ? "" : " (fail)");
+                }
+                rh.len = 0;
+                break;
+        }
+        
+        if (rh.len > 0) {
+            printf(" len=%u:", rh.len);
+            for (uint16_t i = 0; i < rh.len; i++) printf(" %02X", payload[i]);
+        }
+        putchar('\n');
+        printed++;
+    }
+    return printed;
+}
+
+/**
+ * Eine Datei dekodieren (Ringdatei oder einfache Binärdatei)
+ * @return Anzahl ausgegebener Records, -1 bei Fehler
+ */
+static long decodeFile(const char* path, const Filter& filter, bool csv) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "logdecode: %s: kann nicht geöffnet werden\n", path);
+        return -1;
+    }
+    
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(f);
+    
+    if (data.size() >= 4 && memcmp(data.data(), LOG_RING_MAGIC, 4) == 0) {
+        std::vector<uint8_t> stream;
+        uint8_t format;
+        if (!unwrapRing(path, data, &stream, &format)) return -1;
+        
+        if (format == LOG_RING_FORMAT_TEXT) {
+            if (csv || !filter.anyType) {
+                fprintf(stderr, "logdecode: %s: Text-Log, --csv/--type werden ignoriert\n", path);
+            }
+            return decodeLines(stream.data(), stream.size(), filter);
+        }
+        return decodeRecords(path, stream.data(), stream.size(), filter, csv);
+    }
+    
+    if (data.size() >= 4 && memcmp(data.data(), FLIGHT_DUMP_MAGIC, 4) == 0) {
+        if (csv || !filter.anyType) {
+            fprintf(stderr, "logdecode: %s: Flight-Dump, --csv/--type werden ignoriert\n", path);
+        }
+        return decodeFlight(path, data, filter);
+    }
+    
+    LogBinFileHeader fh;
+    if (data.size() < sizeof(fh) || memcmp(data.data(), LOG_BIN_MAGIC, sizeof(fh.magic)) != 0) {
+        fprintf(stderr, "logdecode: %s: keine Log-Datei (weder Ringdatei noch Binärdatei)\n", path);
+        return -1;
+    }
+    memcpy(&fh, data.data(), sizeof(fh));
+    if (fh.version != LOG_BIN_VERSION) {
+        fprintf(stderr, "logdecode: %s: Schema-Version %u (erwartet %u)\n",
+                path, fh.version, LOG_BIN_VERSION);
+        return -1;
+    }
+    
+    return decodeRecords(path, &data[sizeof(fh)], data.size() - sizeof(fh), filter, csv);
+}
+
+static int parseType(const char* arg) {
+    char* end;
+    long num = strtol(arg, &end, 0);
+    if (*end == '\0' && num > 0 && num < LOG_BIN_TYPE_COUNT) return (int)num;
+    
+    for (int t = 1; t < LOG_BIN_TYPE_COUNT; t++) {
+        if (strcasecmp(arg, logBinTypeName(t)) == 0) return t;
+    }
+    return -1;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "Aufruf: logdecode [--csv] [--from MS] [--to MS] [--type NAME]... DATEI...\n"
+            "Typen:");
+    for (int t = 1; t < LOG_BIN_TYPE_COUNT; t++) {
+        fprintf(stderr, " %s", logBinTypeName(t));
+    }
+    fputc('\n', stderr);
+}
+
+int main(int argc, char** argv) {
+    Filter filter;
+    bool csv = false;
+    std::vector<const char*> files;
+    
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        
+        if (strcmp(arg, "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(arg, "--from") == 0 && hasValue) {
+            filter.fromMs = strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(arg, "--to") == 0 && hasValue) {
+            filter.toMs = strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(arg, "--type") == 0 && hasValue) {
+            int type = parseType(argv[++i]);
+            if (type < 0) {
+                fprintf(stderr, "logdecode: unbekannter Typ: %s\n", argv[i]);
+                usage();
+                return 2;
+            }
+            filter.types[type] = true;
+            filter.anyType = false;
+        } else if (arg[0] == '-') {
+            usage();
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    
+    if (files.empty()) {
+        usage();
+        return 2;
+    }
+    
+    // Einheitliche Spalten nur bei genau einem Typ
+    if (csv) {
+        int selected = -1;
+        int count = 0;
+        for (int t = 1; t < LOG_BIN_TYPE_COUNT; t++) {
+            if (filter.types[t]) {
+                selected = t;
+                count++;
+            }
+        }
+        if (count == 1) printCsvHeader(selected);
+    }
+    
+    int result = 0;
+    for (const char* path : files) {
+        if (decodeFile(path, filter, csv) < 0) result = 1;
+    }
+    return result;
+}